@@ -431,84 +431,136 @@ ly_strcat(char **dest, const char *format, ...)
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Parse the magnitude and sign of an integer the same way strtoull(3) would but without requiring
+ * a terminated string and so without any allocation.
+ *
+ * @param[in] val_str String value containing the integer, only whitespaces are allowed after the value itself.
+ * @param[in] val_len Length of the @p val_str string.
+ * @param[in] base Numeric base for parsing, see ::ly_parse_int().
+ * @param[out] negative Whether the value is negative.
+ * @param[out] ret Parsed magnitude of the value.
+ * @return LY_SUCCESS on success.
+ * @return LY_EVALID if the string contains an invalid value or the magnitude does not fit into 64 bits.
+ */
+static LY_ERR
+ly_parse_magnitude(const char *val_str, size_t val_len, int base, ly_bool *negative, uint64_t *ret)
+{
+    size_t i = 0, digits;
+    uint64_t u = 0, cutoff;
+    uint32_t cutlim, d;
+    char c;
+
+    /* leading whitespaces and sign */
+    while ((i < val_len) && isspace(val_str[i])) {
+        ++i;
+    }
+    *negative = 0;
+    if ((i < val_len) && ((val_str[i] == '-') || (val_str[i] == '+'))) {
+        *negative = (val_str[i] == '-');
+        ++i;
+    }
+
+    /* base prefix */
+    if (((base == 0) || (base == LY_BASE_HEX)) && (i + 2 < val_len) && (val_str[i] == '0') &&
+            ((val_str[i + 1] == 'x') || (val_str[i + 1] == 'X')) && isxdigit(val_str[i + 2])) {
+        base = LY_BASE_HEX;
+        i += 2;
+    } else if (!base) {
+        base = ((i < val_len) && (val_str[i] == '0')) ? LY_BASE_OCT : LY_BASE_DEC;
+    }
+
+    /* digits */
+    cutoff = UINT64_MAX / base;
+    cutlim = UINT64_MAX % base;
+    for (digits = i; i < val_len; ++i) {
+        c = val_str[i];
+        if ((c >= '0') && (c <= '9')) {
+            d = c - '0';
+        } else if ((c >= 'a') && (c <= 'z')) {
+            d = c - 'a' + 10;
+        } else if ((c >= 'A') && (c <= 'Z')) {
+            d = c - 'A' + 10;
+        } else {
+            break;
+        }
+        if (d >= (uint32_t)base) {
+            break;
+        }
+
+        if ((u > cutoff) || ((u == cutoff) && (d > cutlim))) {
+            /* overflow */
+            return LY_EVALID;
+        }
+        u = u * base + d;
+    }
+    if (i == digits) {
+        /* no number */
+        return LY_EVALID;
+    }
+
+    /* trailing whitespaces, the value may also be terminated before val_len */
+    while ((i < val_len) && isspace(val_str[i])) {
+        ++i;
+    }
+    if ((i < val_len) && val_str[i]) {
+        /* invalid characters after some number */
+        return LY_EVALID;
+    }
+
+    *ret = u;
+    return LY_SUCCESS;
+}
+
 LY_ERR
 ly_parse_int(const char *val_str, size_t val_len, int64_t min, int64_t max, int base, int64_t *ret)
 {
-    LY_ERR rc = LY_SUCCESS;
-    char *ptr, *str;
+    ly_bool negative;
+    uint64_t u;
     int64_t i;
 
     LY_CHECK_ARG_RET(NULL, val_str, val_str[0], val_len, LY_EINVAL);
 
-    /* duplicate the value */
-    str = strndup(val_str, val_len);
-    LY_CHECK_RET(!str, LY_EMEM);
-
-    /* parse the value to avoid accessing following bytes */
-    errno = 0;
-    i = strtoll(str, &ptr, base);
-    if (errno || (ptr == str)) {
-        /* invalid string */
-        rc = LY_EVALID;
-    } else if ((i < min) || (i > max)) {
-        /* invalid number */
-        rc = LY_EDENIED;
-    } else if (*ptr) {
-        while (isspace(*ptr)) {
-            ++ptr;
+    LY_CHECK_RET(ly_parse_magnitude(val_str, val_len, base, &negative, &u));
+    if (negative) {
+        if (u > (uint64_t)INT64_MAX + 1) {
+            /* out of int64 range */
+            return LY_EVALID;
         }
-        if (*ptr) {
-            /* invalid characters after some number */
-            rc = LY_EVALID;
+        i = u ? -(int64_t)(u - 1) - 1 : 0;
+    } else {
+        if (u > (uint64_t)INT64_MAX) {
+            /* out of int64 range */
+            return LY_EVALID;
         }
+        i = u;
     }
 
-    /* cleanup */
-    free(str);
-    if (!rc) {
-        *ret = i;
+    if ((i < min) || (i > max)) {
+        /* invalid number */
+        return LY_EDENIED;
     }
-    return rc;
+
+    *ret = i;
+    return LY_SUCCESS;
 }
 
 LY_ERR
 ly_parse_uint(const char *val_str, size_t val_len, uint64_t max, int base, uint64_t *ret)
 {
-    LY_ERR rc = LY_SUCCESS;
-    char *ptr, *str;
+    ly_bool negative;
     uint64_t u;
 
     LY_CHECK_ARG_RET(NULL, val_str, val_str[0], val_len, LY_EINVAL);
 
-    /* duplicate the value to avoid accessing following bytes */
-    str = strndup(val_str, val_len);
-    LY_CHECK_RET(!str, LY_EMEM);
-
-    /* parse the value */
-    errno = 0;
-    u = strtoull(str, &ptr, base);
-    if (errno || (ptr == str)) {
-        /* invalid string */
-        rc = LY_EVALID;
-    } else if ((u > max) || (u && (str[0] == '-'))) {
+    LY_CHECK_RET(ly_parse_magnitude(val_str, val_len, base, &negative, &u));
+    if ((u > max) || (u && negative)) {
         /* invalid number */
-        rc = LY_EDENIED;
-    } else if (*ptr) {
-        while (isspace(*ptr)) {
-            ++ptr;
-        }
-        if (*ptr) {
-            /* invalid characters after some number */
-            rc = LY_EVALID;
-        }
+        return LY_EDENIED;
     }
 
-    /* cleanup */
-    free(str);
-    if (!rc) {
-        *ret = u;
-    }
-    return rc;
+    *ret = u;
+    return LY_SUCCESS;
 }
 
 /**
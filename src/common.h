@@ -220,6 +220,9 @@ void ly_log_dbg(uint32_t group, const char *format, ...);
 #define LY_CHECK_ARG_RET(CTX, ...) GETMACRO6(__VA_ARGS__, LY_CHECK_ARG_RET5, LY_CHECK_ARG_RET4, LY_CHECK_ARG_RET3, \
     LY_CHECK_ARG_RET2, LY_CHECK_ARG_RET1, DUMMY) (CTX, __VA_ARGS__)
 
+#define LY_CHECK_CTX_FROZEN_RET(CTX, RETVAL) if ((CTX)->flags & LY_CTX_FROZEN) {\
+        LOGERR(CTX, LY_EDENIED, "Schema of a frozen context cannot be changed.");return RETVAL;}
+
 /* count sequence size for LY_VCODE_INCHILDSTMT validation error code */
 size_t LY_VCODE_INSTREXP_len(const char *str);
 /* default maximum characters to print in LY_VCODE_INCHILDSTMT */
@@ -326,6 +329,12 @@ struct ly_ctx {
 
     pthread_key_t errlist_key;        /**< key for the thread-specific list of errors related to the context */
     pthread_mutex_t lyb_hash_lock;    /**< lock for storing LYB schema hashes in schema nodes */
+    struct hash_table *val_pool;      /**< values shared by data nodes, see ::LY_CTX_INTERN_VALUES */
+    pthread_mutex_t val_pool_lock;    /**< lock for the shared values */
+
+    struct ly_ctx *parent;            /**< parent context whose dictionary is shared, see ::ly_ctx_new_clone() */
+    uint32_t clone_count;             /**< number of contexts cloned from this context, protected by the dictionary lock */
+    ly_bool destroy_pending;          /**< set if the context was destroyed while there were still its clones */
 };
 
 /**
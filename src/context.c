@@ -36,6 +36,7 @@
 #include "compat.h"
 #include "hash_table.h"
 #include "in.h"
+#include "lyb.h"
 #include "parser_data.h"
 #include "plugins_internal.h"
 #include "plugins_types.h"
@@ -194,6 +195,7 @@ ly_ctx_load_module(struct ly_ctx *ctx, const char *name, const char *revision, c
     LY_ERR ret = LY_SUCCESS;
 
     LY_CHECK_ARG_RET(ctx, ctx, name, NULL);
+    LY_CHECK_CTX_FROZEN_RET(ctx, NULL);
 
     /* load and parse */
     ret = lys_parse_load(ctx, name, revision, &ctx->unres.creating, &mod);
@@ -204,7 +206,7 @@ ly_ctx_load_module(struct ly_ctx *ctx, const char *name, const char *revision, c
     LY_CHECK_GOTO(ret, cleanup);
 
     if (!(ctx->flags & LY_CTX_EXPLICIT_COMPILE)) {
-        /* create dep set for the module and mark all the modules that will be (re)compiled */
+        /* create dep set for the module */
         LY_CHECK_GOTO(ret = lys_unres_dep_sets_create(ctx, &ctx->unres.dep_sets, mod), cleanup);
 
         /* (re)compile the whole dep set (other dep sets will have no modules marked for compilation) */
@@ -223,8 +225,17 @@ cleanup:
     return mod;
 }
 
-API LY_ERR
-ly_ctx_new(const char *search_dir, uint16_t options, struct ly_ctx **new_ctx)
+/**
+ * @brief Create a new context, optionally sharing the dictionary of a parent context.
+ *
+ * @param[in] search_dir Search directories separated by ':', if any.
+ * @param[in] options Context options, see @ref contextoptions.
+ * @param[in] parent Optional parent context.
+ * @param[out] new_ctx Created context.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+ly_ctx_new_parent(const char *search_dir, uint16_t options, struct ly_ctx *parent, struct ly_ctx **new_ctx)
 {
     struct ly_ctx *ctx = NULL;
     struct lys_module *module;
@@ -235,13 +246,18 @@ ly_ctx_new(const char *search_dir, uint16_t options, struct ly_ctx **new_ctx)
     LY_ERR rc = LY_SUCCESS;
     struct lys_glob_unres unres = {0};
 
-    LY_CHECK_ARG_RET(NULL, new_ctx, LY_EINVAL);
-
     ctx = calloc(1, sizeof *ctx);
     LY_CHECK_ERR_GOTO(!ctx, LOGMEM(NULL); rc = LY_EMEM, cleanup);
 
     /* dictionary */
     lydict_init(&ctx->dict);
+    if (parent) {
+        /* share the dictionary of the parent, it cannot be freed before this context */
+        pthread_mutex_lock(&parent->dict.lock);
+        ++parent->clone_count;
+        pthread_mutex_unlock(&parent->dict.lock);
+        ctx->parent = parent;
+    }
 
     /* plugins */
     LY_CHECK_ERR_GOTO(lyplg_init(), LOGINT(NULL); rc = LY_EINT, cleanup);
@@ -252,8 +268,11 @@ ly_ctx_new(const char *search_dir, uint16_t options, struct ly_ctx **new_ctx)
     /* init LYB hash lock */
     pthread_mutex_init(&ctx->lyb_hash_lock, NULL);
 
-    /* models list */
-    ctx->flags = options;
+    /* init shared values lock */
+    pthread_mutex_init(&ctx->val_pool_lock, NULL);
+
+    /* models list, the context can be frozen only when created */
+    ctx->flags = options & ~LY_CTX_FROZEN;
     if (search_dir) {
         search_dir_list = strdup(search_dir);
         LY_CHECK_ERR_GOTO(!search_dir_list, LOGMEM(NULL); rc = LY_EMEM, cleanup);
@@ -305,6 +324,11 @@ ly_ctx_new(const char *search_dir, uint16_t options, struct ly_ctx **new_ctx)
         ctx->flags &= ~LY_CTX_EXPLICIT_COMPILE;
     }
 
+    if (options & LY_CTX_FROZEN) {
+        /* freeze the context */
+        LY_CHECK_GOTO(rc = ly_ctx_set_options(ctx, LY_CTX_FROZEN), cleanup);
+    }
+
 cleanup:
     ly_in_free(in, 0);
     lys_unres_glob_erase(&unres);
@@ -316,6 +340,107 @@ cleanup:
     return rc;
 }
 
+API LY_ERR
+ly_ctx_new(const char *search_dir, uint16_t options, struct ly_ctx **new_ctx)
+{
+    LY_CHECK_ARG_RET(NULL, new_ctx, LY_EINVAL);
+
+    return ly_ctx_new_parent(search_dir, options, NULL, new_ctx);
+}
+
+/**
+ * @brief Get all the enabled features of a module.
+ *
+ * @param[in] mod Module to examine.
+ * @param[out] features NULL-terminated array of enabled feature names, "*" if all of them are enabled.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+ly_ctx_clone_mod_features(const struct lys_module *mod, const char ***features)
+{
+    struct lysp_feature *f = NULL;
+    uint32_t idx = 0, count = 0;
+    void *mem;
+
+    *features = NULL;
+    while ((f = lysp_feature_next(f, mod->parsed, &idx))) {
+        if (!(f->flags & LYS_FENABLED)) {
+            continue;
+        }
+
+        mem = realloc(*features, (count + 2) * sizeof **features);
+        LY_CHECK_ERR_RET(!mem, free(*features); *features = NULL; LOGMEM(mod->ctx), LY_EMEM);
+        *features = mem;
+        (*features)[count++] = f->name;
+        (*features)[count] = NULL;
+    }
+
+    return LY_SUCCESS;
+}
+
+API LY_ERR
+ly_ctx_new_clone(struct ly_ctx *ctx, uint16_t options, struct ly_ctx **new_ctx)
+{
+    LY_ERR rc = LY_SUCCESS;
+    struct ly_ctx *clone = NULL;
+    struct lys_module *mod, *mod_clone;
+    const char **features = NULL;
+    uint32_t i;
+
+    LY_CHECK_ARG_RET(ctx, ctx, new_ctx, LY_EINVAL);
+
+    /* create the context with the same settings (but not frozen), compile it only once at the end */
+    options |= ctx->flags & ~LY_CTX_FROZEN;
+    LY_CHECK_GOTO(rc = ly_ctx_new_parent(NULL, (options & ~LY_CTX_FROZEN) | LY_CTX_EXPLICIT_COMPILE, ctx, &clone),
+            cleanup);
+    for (i = 0; i < ctx->search_paths.count; ++i) {
+        LY_CHECK_GOTO(rc = ly_ctx_set_searchdir(clone, ctx->search_paths.objs[i]), cleanup);
+    }
+    clone->imp_clb = ctx->imp_clb;
+    clone->imp_clb_data = ctx->imp_clb_data;
+
+    /* load all the implemented modules with their features, imports are loaded implicitly */
+    for (i = 0; i < ctx->list.count; ++i) {
+        mod = ctx->list.objs[i];
+        if (!mod->implemented) {
+            continue;
+        }
+
+        LY_CHECK_GOTO(rc = ly_ctx_clone_mod_features(mod, &features), cleanup);
+        mod_clone = ly_ctx_get_module(clone, mod->name, mod->revision);
+        if (mod_clone) {
+            /* internal or already imported module */
+            rc = lys_set_implemented(mod_clone, features);
+        } else if (!ly_ctx_load_module(clone, mod->name, mod->revision, features)) {
+            LOGERR(ctx, LY_ENOTFOUND, "Unable to load module \"%s%s%s\" into the cloned context.", mod->name,
+                    mod->revision ? "@" : "", mod->revision ? mod->revision : "");
+            rc = LY_ENOTFOUND;
+        }
+        free(features);
+        features = NULL;
+        LY_CHECK_GOTO(rc, cleanup);
+    }
+
+    if (!(options & LY_CTX_EXPLICIT_COMPILE)) {
+        /* compile now */
+        LY_CHECK_GOTO(rc = ly_ctx_compile(clone), cleanup);
+        clone->flags &= ~LY_CTX_EXPLICIT_COMPILE;
+    }
+
+    if (options & LY_CTX_FROZEN) {
+        /* freeze the clone */
+        LY_CHECK_GOTO(rc = ly_ctx_set_options(clone, LY_CTX_FROZEN), cleanup);
+    }
+
+cleanup:
+    if (rc) {
+        ly_ctx_destroy(clone);
+    } else {
+        *new_ctx = clone;
+    }
+    return rc;
+}
+
 static LY_ERR
 ly_ctx_new_yl_legacy(struct ly_ctx *ctx, struct lyd_node *yltree)
 {
@@ -401,12 +526,13 @@ ly_ctx_new_yl_common(const char *search_dir, const char *input, LYD_FORMAT forma
     struct ly_ctx *ctx_yl = NULL, *ctx_new = NULL;
     ly_bool no_expl_compile = 0;
 
-    /* create a seperate context in case it is LY_CTX_NO_YANGLIBRARY since it needs it for parsing */
+    /* create a seperate context in case it is LY_CTX_NO_YANGLIBRARY since it needs it for parsing,
+     * the new context is frozen only once all the modules are loaded */
     if (options & LY_CTX_NO_YANGLIBRARY) {
         LY_CHECK_GOTO(ret = ly_ctx_new(search_dir, 0, &ctx_yl), cleanup);
-        LY_CHECK_GOTO(ret = ly_ctx_new(search_dir, options, &ctx_new), cleanup);
+        LY_CHECK_GOTO(ret = ly_ctx_new(search_dir, options & ~LY_CTX_FROZEN, &ctx_new), cleanup);
     } else {
-        LY_CHECK_GOTO(ret = ly_ctx_new(search_dir, options, &ctx_new), cleanup);
+        LY_CHECK_GOTO(ret = ly_ctx_new(search_dir, options & ~LY_CTX_FROZEN, &ctx_new), cleanup);
     }
 
     /* parse yang library data tree */
@@ -476,6 +602,11 @@ ly_ctx_new_yl_common(const char *search_dir, const char *input, LYD_FORMAT forma
         ctx_new->flags &= ~LY_CTX_EXPLICIT_COMPILE;
     }
 
+    if (options & LY_CTX_FROZEN) {
+        /* freeze the context */
+        LY_CHECK_GOTO(ret = ly_ctx_set_options(ctx_new, LY_CTX_FROZEN), cleanup);
+    }
+
 cleanup:
     lyd_free_all(yltree);
     ly_set_free(set, NULL);
@@ -510,8 +641,9 @@ ly_ctx_compile(struct ly_ctx *ctx)
     LY_ERR ret = LY_SUCCESS;
 
     LY_CHECK_ARG_RET(NULL, ctx, LY_EINVAL);
+    LY_CHECK_CTX_FROZEN_RET(ctx, LY_EDENIED);
 
-    /* create dep sets and mark all the modules that will be (re)compiled */
+    /* create dep sets */
     LY_CHECK_GOTO(ret = lys_unres_dep_sets_create(ctx, &ctx->unres.dep_sets, NULL), cleanup);
 
     /* (re)compile all the dep sets */
@@ -534,6 +666,35 @@ ly_ctx_get_options(const struct ly_ctx *ctx)
     return ctx->flags;
 }
 
+/**
+ * @brief Generate the canonical values of all the default values of a schema node.
+ *
+ * Implementation of ::lysc_dfs_clb.
+ */
+static LY_ERR
+ly_ctx_dflt_canonical_dfs_cb(struct lysc_node *node, void *UNUSED(data), ly_bool *UNUSED(dfs_continue))
+{
+    struct lysc_node_leaf *leaf;
+    struct lysc_node_leaflist *llist;
+    LY_ARRAY_COUNT_TYPE u;
+
+    if (node->nodetype == LYS_LEAF) {
+        leaf = (struct lysc_node_leaf *)node;
+        if (leaf->dflt && !lyd_value_get_canonical(node->module->ctx, leaf->dflt)) {
+            return LY_EMEM;
+        }
+    } else if (node->nodetype == LYS_LEAFLIST) {
+        llist = (struct lysc_node_leaflist *)node;
+        LY_ARRAY_FOR(llist->dflts, u) {
+            if (!lyd_value_get_canonical(node->module->ctx, llist->dflts[u])) {
+                return LY_EMEM;
+            }
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
 API LY_ERR
 ly_ctx_set_options(struct ly_ctx *ctx, uint16_t option)
 {
@@ -546,6 +707,7 @@ ly_ctx_set_options(struct ly_ctx *ctx, uint16_t option)
             LOGARG(ctx, option), LY_EINVAL);
 
     if (!(ctx->flags & LY_CTX_SET_PRIV_PARSED) && (option & LY_CTX_SET_PRIV_PARSED)) {
+        LY_CHECK_CTX_FROZEN_RET(ctx, LY_EDENIED);
         ctx->flags |= LY_CTX_SET_PRIV_PARSED;
         /* recompile the whole context to set the priv pointers */
         for (i = 0; i < ctx->list.count; ++i) {
@@ -560,6 +722,20 @@ ly_ctx_set_options(struct ly_ctx *ctx, uint16_t option)
         }
     }
 
+    if (!lyrc && !(ctx->flags & LY_CTX_FROZEN) && (option & LY_CTX_FROZEN)) {
+        /* compile any pending changes */
+        lyrc = ly_ctx_compile(ctx);
+
+        /* generate all the LYB hashes and canonical default values now so that they are never stored later */
+        for (i = 0; !lyrc && (i < ctx->list.count); ++i) {
+            mod = ctx->list.objs[i];
+            if (mod->implemented) {
+                lyb_cache_module_hash(mod);
+                lyrc = lysc_module_dfs_full(mod, ly_ctx_dflt_canonical_dfs_cb, NULL);
+            }
+        }
+    }
+
     /* set the option(s) */
     if (!lyrc) {
         ctx->flags |= option;
@@ -619,6 +795,8 @@ ly_ctx_unset_options(struct ly_ctx *ctx, uint16_t option)
         struct lys_module *mod;
         uint32_t index;
 
+        LY_CHECK_CTX_FROZEN_RET(ctx, LY_EDENIED);
+
         index = 0;
         while ((mod = ly_ctx_get_module_iter(ctx, &index))) {
             lysc_node_clear_all_priv(mod);
@@ -1206,11 +1384,22 @@ API void
 ly_ctx_destroy(struct ly_ctx *ctx)
 {
     struct lys_module *mod;
+    struct ly_ctx *parent;
+    ly_bool destroy_parent = 0;
 
     if (!ctx) {
         return;
     }
 
+    pthread_mutex_lock(&ctx->dict.lock);
+    if (ctx->clone_count) {
+        /* there are still clones sharing our dictionary, destroy the context with the last of them */
+        ctx->destroy_pending = 1;
+        pthread_mutex_unlock(&ctx->dict.lock);
+        return;
+    }
+    pthread_mutex_unlock(&ctx->dict.lock);
+
     /* models list */
     for ( ; ctx->list.count; ctx->list.count--) {
         mod = ctx->list.objs[ctx->list.count - 1];
@@ -1241,8 +1430,27 @@ ly_ctx_destroy(struct ly_ctx *ctx)
     /* LYB hash lock */
     pthread_mutex_destroy(&ctx->lyb_hash_lock);
 
+    /* shared values, all freed with the data */
+    lyht_free(ctx->val_pool);
+    pthread_mutex_destroy(&ctx->val_pool_lock);
+
     /* plugins - will be removed only if this is the last context */
     lyplg_clean();
 
+    parent = ctx->parent;
     free(ctx);
+
+    if (parent) {
+        /* the dictionary of the parent is no longer shared by this context */
+        pthread_mutex_lock(&parent->dict.lock);
+        --parent->clone_count;
+        if (!parent->clone_count && parent->destroy_pending) {
+            destroy_parent = 1;
+        }
+        pthread_mutex_unlock(&parent->dict.lock);
+
+        if (destroy_parent) {
+            ly_ctx_destroy(parent);
+        }
+    }
 }
@@ -95,6 +95,7 @@ struct lys_module;
  * --------------
  *
  * - ::ly_ctx_new()
+ * - ::ly_ctx_new_clone()
  * - ::ly_ctx_destroy()
  *
  * - ::ly_ctx_set_searchdir()
@@ -196,6 +197,52 @@ struct ly_ctx;
 #define LY_CTX_ENABLE_IMP_FEATURES 0x0100 /**< By default, all features of newly implemented imported modules of
                                         a module that is being loaded are disabled. With this flag they all become
                                         enabled. */
+#define LY_CTX_FROZEN 0x0200 /**< The context schema is final and cannot be changed anymore, all the functions
+                                        loading or parsing new modules, changing their features, or recompiling the
+                                        context fail with ::LY_EDENIED. When setting this option, any pending changes
+                                        are compiled and all the lazily generated information is prepared (LYB hashes
+                                        of the schema nodes, canonical default values) so that working with data never
+                                        writes into the compiled schema. As a result, a frozen context can be used from
+                                        multiple threads without locking the schema and when created before fork(), its
+                                        memory pages stay shared by all the child processes. Can be unset by
+                                        ::ly_ctx_unset_options(). */
+#define LY_CTX_SKIP_UNUSED_GROUPINGS 0x0400 /**< Groupings that are never instantiated by any uses statement are not
+                                        compiled. By default, all of them are compiled only to be validated and then
+                                        immediately freed. Skipping them speeds up the compilation of schemas with many
+                                        unused groupings (about twice for a module with 9 of 10 groupings unused), but
+                                        errors in the unused groupings are no longer detected. The instantiated schema
+                                        nodes are still all compiled and the memory of the compiled schema is the
+                                        same, it is not a lazy compilation. */
+#define LY_CTX_NO_DESCRIPTIONS 0x0800 /**< The description and reference statements of all the modules parsed
+                                        into the context are not stored neither in the parsed nor in the compiled
+                                        schema trees. Such texts are never needed for processing data but they
+                                        often take most of the memory of the schema strings. Affects only modules
+                                        parsed after setting this option and these modules are printed without
+                                        these statements. */
+#define LY_CTX_INLINE_STRINGS 0x1000 /**< String values that fit into the fixed memory of ::lyd_value (including
+                                        the terminating zero) are stored directly in it instead of being inserted
+                                        into the context dictionary. Saves the dictionary record and the separate
+                                        allocation of every distinct short string, which is most of the memory of
+                                        data trees with many unique short values, such as list keys. The size of
+                                        the fixed memory is set by the LYD_VALUE_SIZE build option. Affects only
+                                        values stored after setting this option. */
+#define LY_CTX_INTERN_VALUES 0x2000 /**< Equal union values of the same node stored from the same string share
+                                        a single reference-counted value instead of each data node allocating its
+                                        own. Union values are the only built-in values with a dynamically allocated
+                                        representation (that keeps the original string, too), so repeated values
+                                        such as addresses of the same next-hop in operational data save most of
+                                        their memory and are duplicated without any allocation. Values that may be
+                                        resolved again in the data tree (leafref, instance-identifier) are never
+                                        shared. Affects only values stored after setting this option. */
+#define LY_CTX_UNIQUE_INDEX 0x4000 /**< The unique values of the list instances are kept in indexes stored in their
+                                        data parent (::lyd_node_inner.uniq_idx) between validations. The indexes are
+                                        created by the first validation of a list with unique statements and then
+                                        updated by every change of the data tree so that the next validation checks
+                                        only the changed instances instead of hashing the unique values of all the
+                                        instances again. Speeds up repeated validation of large lists with unique
+                                        statements at the cost of the memory of the indexes. Top-level lists are
+                                        always checked fully. See ::lyd_unique_index_stats() for the cost of
+                                        maintaining the indexes. */
 
 /** @} contextoptions */
 
@@ -268,6 +315,28 @@ LY_ERR ly_ctx_new_ylpath(const char *search_dir, const char *path, LYD_FORMAT fo
  */
 LY_ERR ly_ctx_new_ylmem(const char *search_dir, const char *data, LYD_FORMAT format, int options, struct ly_ctx **ctx);
 
+/**
+ * @brief Create libyang context as a clone of another context.
+ *
+ * The new context has the same search directories, import callback, options and implemented modules with the same
+ * features enabled as @p ctx. The modules are loaded the same way as in case of ::ly_ctx_load_module() so they must be
+ * available in the search locations or using the import callback. Once created, the clone can be freely changed
+ * (load new modules, change features) without affecting @p ctx. To apply all such changes with a single compilation,
+ * use the ::LY_CTX_EXPLICIT_COMPILE option.
+ *
+ * The clone shares the dictionary of @p ctx so all the strings already stored in it (names, descriptions, values)
+ * are only referenced and not stored again, which significantly reduces memory consumption of many similar
+ * contexts. Consequently, @p ctx destroyed by ::ly_ctx_destroy() is really freed only after all its clones are
+ * destroyed.
+ *
+ * @param[in] ctx Context to clone.
+ * @param[in] options Additional context options of the new context, see @ref contextoptions. Options of @p ctx
+ * are always inherited.
+ * @param[out] new_ctx Pointer to the created libyang context if LY_SUCCESS returned.
+ * @return LY_ERR return value.
+ */
+LY_ERR ly_ctx_new_clone(struct ly_ctx *ctx, uint16_t options, struct ly_ctx **new_ctx);
+
 /**
  * @brief Compile (recompile) the context applying all the performed changes after the last context compilation.
  * Should be used only if ::LY_CTX_EXPLICIT_COMPILE option is set, has no effect otherwise.
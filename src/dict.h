@@ -42,6 +42,9 @@ struct ly_ctx;
  *
  * To remove (reference of the) string from the context dictionary, ::lydict_remove() is supposed to be used.
  *
+ * Context created by ::ly_ctx_new_clone() shares the dictionary of its parent context. Strings found in the parent
+ * dictionary are referenced there and only the new strings are stored in the dictionary of the clone.
+ *
  * \note Incorrect usage of the dictionary can break libyang functionality.
  *
  * \note API for this group of functions is described in the [Dictionary module](@ref dict).
@@ -800,14 +800,7 @@ lyd_diff_siblings(const struct lyd_node *first, const struct lyd_node *second, u
     return lyd_diff(first, second, options, 0, diff);
 }
 
-/**
- * @brief Learn operation of a diff node.
- *
- * @param[in] diff_node Diff node.
- * @param[out] op Operation.
- * @return LY_ERR value.
- */
-static LY_ERR
+LY_ERR
 lyd_diff_get_op(const struct lyd_node *diff_node, enum lyd_diff_op *op)
 {
     struct lyd_meta *meta = NULL;
@@ -59,4 +59,13 @@ LY_ERR lyd_diff_add(const struct lyd_node *node, enum lyd_diff_op op, const char
         const char *key, const char *value, const char *position, const char *orig_key, const char *orig_position,
         struct lyd_node **diff);
 
+/**
+ * @brief Learn operation of a diff node.
+ *
+ * @param[in] diff_node Diff node.
+ * @param[out] op Operation.
+ * @return LY_ERR value.
+ */
+LY_ERR lyd_diff_get_op(const struct lyd_node *diff_node, enum lyd_diff_op *op);
+
 #endif /* LY_DIFF_H_ */
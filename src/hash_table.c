@@ -156,6 +156,51 @@ lydict_resize_val_eq(void *val1_p, void *val2_p, ly_bool mod, void *cb_data)
     return 0;
 }
 
+/**
+ * @brief Find a string in the dictionary of a parent context (and its parents) and reference it.
+ *
+ * Strings of the parent context dictionary are shared with the context clones so they do not have to be stored again.
+ *
+ * @param[in] ctx Parent context to search in.
+ * @param[in] value String to find.
+ * @param[in] len Length of @p value.
+ * @param[in] hash Hash of @p value.
+ * @param[out] str_p Referenced string stored in the parent dictionary.
+ * @return LY_SUCCESS if found and referenced.
+ * @return LY_ENOTFOUND if not found.
+ * @return LY_ERR on error.
+ */
+static LY_ERR
+dict_parent_ref(const struct ly_ctx *ctx, const char *value, size_t len, uint32_t hash, const char **str_p)
+{
+    LY_ERR ret;
+    struct dict_rec rec, *match = NULL;
+
+    rec.value = (char *)value;
+    rec.refcount = 0;
+
+    pthread_mutex_lock((pthread_mutex_t *)&ctx->dict.lock);
+    lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
+    ret = lyht_find(ctx->dict.hash_tab, &rec, hash, (void **)&match);
+    if (!ret) {
+        /* found, the string must be NULL-terminated after len bytes */
+        if (match->value[len]) {
+            ret = LY_ENOTFOUND;
+        } else {
+            match->refcount++;
+            *str_p = match->value;
+        }
+    }
+    pthread_mutex_unlock((pthread_mutex_t *)&ctx->dict.lock);
+
+    if ((ret == LY_ENOTFOUND) && ctx->parent) {
+        /* try the parent of the parent */
+        ret = dict_parent_ref(ctx->parent, value, len, hash, str_p);
+    }
+
+    return ret;
+}
+
 API LY_ERR
 lydict_remove(const struct ly_ctx *ctx, const char *value)
 {
@@ -200,6 +245,10 @@ lydict_remove(const struct ly_ctx *ctx, const char *value)
             free(val_p);
             LY_CHECK_ERR_GOTO(ret, LOGINT(ctx), finish);
         }
+    } else if ((ret == LY_ENOTFOUND) && ctx->parent) {
+        /* the string is shared from the parent dictionary */
+        pthread_mutex_unlock((pthread_mutex_t *)&ctx->dict.lock);
+        return lydict_remove(ctx->parent, value);
     } else if (ret == LY_ENOTFOUND) {
         LOGERR(ctx, LY_ENOTFOUND, "Value \"%s\" was not found in the dictionary.", value);
     } else {
@@ -227,6 +276,20 @@ dict_insert(const struct ly_ctx *ctx, char *value, size_t len, ly_bool zerocopy,
     rec.value = value;
     rec.refcount = 1;
 
+    if (ctx->parent && (lyht_find(ctx->dict.hash_tab, &rec, hash, NULL) == LY_ENOTFOUND)) {
+        /* not in our dictionary, use the string from the parent dictionary, if there is one */
+        ret = dict_parent_ref(ctx->parent, value, len, hash, str_p);
+        if (ret != LY_ENOTFOUND) {
+            if (zerocopy && !ret) {
+                free(value);
+            }
+            return ret;
+        }
+
+        /* restore the compare callback data */
+        lyht_set_cb_data(ctx->dict.hash_tab, (void *)&len);
+    }
+
     ret = lyht_insert_with_resize_cb(ctx->dict.hash_tab, (void *)&rec, hash, lydict_resize_val_eq, (void **)&match);
     if (ret == LY_EEXIST) {
         match->refcount++;
@@ -374,12 +437,20 @@ lyht_dup(const struct hash_table *orig)
         return NULL;
     }
 
-    memcpy(ht->recs, orig->recs, (size_t)orig->used * (size_t)orig->rec_size);
+    memcpy(ht->recs, orig->recs, (size_t)orig->size * (size_t)orig->rec_size);
     ht->used = orig->used;
     ht->invalid = orig->invalid;
     return ht;
 }
 
+void
+lyht_clear(struct hash_table *ht)
+{
+    memset(ht->recs, 0, (size_t)ht->size * (size_t)ht->rec_size);
+    ht->used = 0;
+    ht->invalid = 0;
+}
+
 void
 lyht_free(struct hash_table *ht)
 {
@@ -163,6 +163,13 @@ void *lyht_set_cb_data(struct hash_table *ht, void *new_cb_data);
  */
 struct hash_table *lyht_dup(const struct hash_table *orig);
 
+/**
+ * @brief Remove all the values from a hash table, keeping its size.
+ *
+ * @param[in] ht Hash table to clear.
+ */
+void lyht_clear(struct hash_table *ht);
+
 /**
  * @brief Free a hash table.
  *
@@ -22,6 +22,7 @@
 
 #include "common.h"
 #include "compat.h"
+#include "context.h"
 #include "tree_schema.h"
 
 /**
@@ -100,6 +101,11 @@ lyb_cache_node_hash_cb(struct lysc_node *node, void *UNUSED(data), ly_bool *UNUS
 void
 lyb_cache_module_hash(const struct lys_module *mod)
 {
+    if (mod->ctx->flags & LY_CTX_FROZEN) {
+        /* all the hashes were cached when the context was frozen */
+        return;
+    }
+
     /* LOCK */
     pthread_mutex_lock(&mod->ctx->lyb_hash_lock);
 
@@ -92,7 +92,9 @@ struct ly_in;
  * to modify the validation process by @ref datavalidationoptions. This way the state data can be prohibited
  * (::LYD_VALIDATE_NO_STATE) and checking for mandatory nodes can be limited to the YANG modules with already present data
  * instances (::LYD_VALIDATE_PRESENT). Validation of the standard data tree can be also limited with ::lyd_validate_module()
- * function, which scopes only to a specified single YANG module.
+ * function, which scopes only to a specified single YANG module. A valid data tree that was changed by applying a diff
+ * (::lyd_diff_apply_all()) can be revalidated incrementally by ::lyd_validate_diff(), which checks only the nodes
+ * affected by the changes.
  *
  * Since the operation data trees (RPCs, Actions or Notifications) can reference (leafref, instance-identifier, when/must
  * expressions) data from a datastore tree, ::lyd_validate_op() may require additional data tree to be provided. This is a
@@ -103,7 +105,9 @@ struct ly_in;
  * --------------
  * - ::lyd_validate_all()
  * - ::lyd_validate_module()
+ * - ::lyd_validate_diff()
  * - ::lyd_validate_op()
+ * - ::lyd_unique_index_stats()
  */
 
 /**
@@ -188,6 +192,10 @@ struct ly_in;
 #define LYD_VALIDATE_NO_STATE   0x0001      /**< Consider state data not allowed and raise an error if they are found.
                                                  Also, no implicit state data are added. */
 #define LYD_VALIDATE_PRESENT    0x0002      /**< Validate only modules whose data actually exist. */
+#define LYD_VALIDATE_MULTI_THREAD 0x0004    /**< Resolve leafref and instance-identifier values on several threads
+                                                 if there are enough of them. The data tree must not be accessed by
+                                                 any other thread during the validation. The reported error is
+                                                 the same as if the values were resolved sequentially. */
 
 #define LYD_VALIDATE_OPTS_MASK  0x0000FFFF  /**< Mask for all the LYD_VALIDATE_* options. */
 
@@ -427,6 +435,49 @@ LY_ERR lyd_validate_all(struct lyd_node **tree, const struct ly_ctx *ctx, uint32
  */
 LY_ERR lyd_validate_module(struct lyd_node **tree, const struct lys_module *module, uint32_t val_opts, struct lyd_node **diff);
 
+/**
+ * @brief Validate a data tree after a diff was applied to it.
+ *
+ * The data tree must have been valid, with the same @p val_opts, before @p changes were applied to it (::lyd_diff_apply_all()).
+ * Only the changed subtrees, their parents, and the nodes whose when, must, or leafref restrictions reference
+ * the changed nodes are then validated, with the same result as ::lyd_validate_all(). If the changes cannot be
+ * validated incrementally (for example, a when condition automatically removes some data), the whole data tree is validated.
+ *
+ * The data tree is modified in-place.  As a result of the validation, some data might be removed
+ * from the tree. In that case, the removed items are freed, not just unlinked.
+ *
+ * @param[in,out] tree Data tree to validate. May be changed by validation, might become NULL.
+ * @param[in] changes Diff that was applied to @p tree.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[out] diff Optional diff with any changes made by the validation.
+ * @return LY_SUCCESS on success.
+ * @return LY_ERR error on error.
+ */
+LY_ERR lyd_validate_diff(struct lyd_node **tree, const struct lyd_node *changes, uint32_t val_opts, struct lyd_node **diff);
+
+/**
+ * @brief Statistics of the unique indexes of a data tree, see ::LY_CTX_UNIQUE_INDEX.
+ */
+struct lyd_unique_index_stats {
+    uint32_t indexes;           /**< number of the indexes, one for each list with unique statements in a data parent */
+    uint32_t instances;         /**< number of the list instances in the indexes */
+    uint64_t invalidations;     /**< number of the data tree changes of the indexed instances that were recorded */
+    uint64_t rehashes;          /**< number of the instances whose unique values were hashed into the indexes */
+};
+
+/**
+ * @brief Get the statistics of the unique indexes of a data tree, the cost of maintaining them.
+ *
+ * The indexes are created and used only with the ::LY_CTX_UNIQUE_INDEX context option. The counters of an index
+ * are kept from its creation, by the first validation of the list instances, until it is freed with its data parent.
+ *
+ * @param[in] tree Data tree, all its siblings are included.
+ * @param[out] stats Statistics summed over all the indexes in @p tree.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINVAL on invalid arguments.
+ */
+LY_ERR lyd_unique_index_stats(const struct lyd_node *tree, struct lyd_unique_index_stats *stats);
+
 /**
  * @brief Validate an RPC/action request, reply, or notification.
  *
@@ -764,6 +764,7 @@ keyword_start:
                     "The maximum number of block nestings has been exceeded.");
             return LY_EINVAL;
         }
+        ctx->dropped_text[ctx->depth] = 0;
         goto success;
     } else if (*kw == LY_STMT_SYNTAX_RIGHT_BRACE) {
         ctx->depth--;
@@ -966,8 +967,15 @@ parse_text_field(struct lys_yang_parser_ctx *ctx, enum ly_stmt substmt, uint32_t
     char *buf, *word;
     size_t word_len;
     enum ly_stmt kw;
+    uint8_t dropped = 0;
 
-    if (*value) {
+    if (((substmt == LY_STMT_DESCRIPTION) || (substmt == LY_STMT_REFERENCE)) &&
+            (PARSER_CTX(ctx)->flags & LY_CTX_NO_DESCRIPTIONS)) {
+        /* the text is not stored, remember the statement in the parent block instead */
+        dropped = (substmt == LY_STMT_DESCRIPTION) ? 0x01 : 0x02;
+    }
+
+    if (*value || (ctx->dropped_text[ctx->depth] & dropped)) {
         LOGVAL_PARSER(ctx, LY_VCODE_DUPSTMT, ly_stmt2str(substmt));
         return LY_EVALID;
     }
@@ -975,8 +983,14 @@ parse_text_field(struct lys_yang_parser_ctx *ctx, enum ly_stmt substmt, uint32_t
     /* get value */
     LY_CHECK_RET(get_argument(ctx, arg, NULL, &word, &buf, &word_len));
 
-    /* store value and spend buf if allocated */
-    INSERT_WORD_RET(ctx, buf, *value, word, word_len);
+    if (dropped) {
+        /* the text is not needed */
+        ctx->dropped_text[ctx->depth] |= dropped;
+        free(buf);
+    } else {
+        /* store value and spend buf if allocated */
+        INSERT_WORD_RET(ctx, buf, *value, word, word_len);
+    }
 
     YANG_READ_SUBSTMT_FOR(ctx, kw, word, word_len, ret, return LY_SUCCESS, return ret) {
         switch (kw) {
@@ -1198,7 +1198,16 @@ yin_parse_meta(struct lys_yin_parser_ctx *ctx, enum ly_stmt elem_type, const cha
     LY_CHECK_RET(yin_parse_attribute(ctx, YIN_ARG_NONE, NULL, Y_MAYBE_STR_ARG, elem_type));
 
     /* parse content */
-    return yin_parse_content(ctx, subelems, ly_sizeofarray(subelems), elem_type, NULL, exts);
+    LY_CHECK_RET(yin_parse_content(ctx, subelems, ly_sizeofarray(subelems), elem_type, NULL, exts));
+
+    if (((elem_type == LY_STMT_DESCRIPTION) || (elem_type == LY_STMT_REFERENCE)) &&
+            (PARSER_CTX(ctx)->flags & LY_CTX_NO_DESCRIPTIONS)) {
+        /* the text is not needed */
+        lydict_remove(PARSER_CTX(ctx), *value);
+        *value = NULL;
+    }
+
+    return LY_SUCCESS;
 }
 
 /**
@@ -26,6 +26,7 @@
 #include "compat.h"
 #include "context.h"
 #include "dict.h"
+#include "hash_table.h"
 #include "path.h"
 #include "schema_compile.h"
 #include "set.h"
@@ -306,6 +307,12 @@ lyplg_type_dup_simple(const struct ly_ctx *ctx, const struct lyd_value *original
     return LY_SUCCESS;
 }
 
+API uint32_t
+lyplg_type_hash_simple(const struct lyd_value *value, uint32_t hash)
+{
+    return lyplg_type_hash_data(hash, value->_canonical, ly_strlen(value->_canonical));
+}
+
 API void
 lyplg_type_free_simple(const struct ly_ctx *ctx, struct lyd_value *value)
 {
@@ -313,6 +320,50 @@ lyplg_type_free_simple(const struct ly_ctx *ctx, struct lyd_value *value)
     value->_canonical = NULL;
 }
 
+API LY_ERR
+lyplg_type_print_cache(const struct ly_ctx *ctx, const char *canon, ly_bool dynamic, const struct lyd_value *value)
+{
+    const char *str;
+
+    if (dynamic) {
+        LY_CHECK_RET(lydict_insert_zc(ctx, (char *)canon, &str));
+    } else {
+        LY_CHECK_RET(lydict_insert(ctx, canon, 0, &str));
+    }
+
+    /* another thread may have cached the same value in the meantime */
+    if (!LY_ATOMIC_CAS_PTR(((struct lyd_value *)value)->_canonical, NULL, str)) {
+        lydict_remove(ctx, str);
+    }
+    return LY_SUCCESS;
+}
+
+API uint32_t
+lyplg_type_hash_data(uint32_t hash, const void *data, size_t len)
+{
+    return dict_hash_multi(hash, data, len);
+}
+
+API uint32_t
+lyplg_type_hash_value(const struct lyd_value *value, uint32_t hash)
+{
+    const void *key;
+    size_t key_len;
+    ly_bool dyn;
+
+    if (value->realtype->plugin->hash) {
+        return value->realtype->plugin->hash(value, hash);
+    }
+
+    /* hash the LYB value */
+    key = value->realtype->plugin->print(NULL, value, LY_VALUE_LYB, NULL, &dyn, &key_len);
+    hash = lyplg_type_hash_data(hash, key, key_len);
+    if (dyn) {
+        free((void *)key);
+    }
+    return hash;
+}
+
 API LY_ERR
 lyplg_type_parse_int(const char *datatype, int base, int64_t min, int64_t max, const char *value, size_t value_len,
         int64_t *ret, struct ly_err_item **err)
@@ -370,7 +421,7 @@ API LY_ERR
 lyplg_type_parse_dec64(uint8_t fraction_digits, const char *value, size_t value_len, int64_t *ret, struct ly_err_item **err)
 {
     LY_ERR ret_val;
-    char *valcopy = NULL;
+    char buf[LY_NUMBER_MAXLEN + 1], *valcopy = NULL;
     size_t fraction = 0, size, len = 0, trailing_zeros;
     int64_t d;
 
@@ -433,10 +484,14 @@ decimal:
         }
     }
 
-    /* prepare value string without decimal point to easily parse using standard functions */
-    valcopy = malloc(size * sizeof *valcopy);
-    if (!valcopy) {
-        return ly_err_new(err, LY_EMEM, 0, NULL, NULL, LY_EMEM_MSG);
+    /* prepare value string without decimal point to easily parse it, no allocation needed for sensible lengths */
+    if (size <= sizeof buf) {
+        valcopy = buf;
+    } else {
+        valcopy = malloc(size * sizeof *valcopy);
+        if (!valcopy) {
+            return ly_err_new(err, LY_EMEM, 0, NULL, NULL, LY_EMEM_MSG);
+        }
     }
 
     valcopy[size - 1] = '\0';
@@ -456,7 +511,9 @@ decimal:
     if (!ret_val && ret) {
         *ret = d;
     }
-    free(valcopy);
+    if (valcopy != buf) {
+        free(valcopy);
+    }
 
     return ret_val;
 }
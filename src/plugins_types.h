@@ -160,7 +160,7 @@ struct lysc_type_leafref;
 /**
  * @brief Type API version
  */
-#define LYPLG_TYPE_API_VERSION 1
+#define LYPLG_TYPE_API_VERSION 2
 
 /**
  * @brief Macro to define plugin information in external plugins
@@ -334,6 +334,45 @@ size_t lyplg_type_bits_bitmap_size(const struct lysc_type_bits *type);
  */
 ly_bool lyplg_type_bits_is_bit_set(const char *bitmap, size_t size, uint32_t bit_position);
 
+/**
+ * @brief Add data into a value hash.
+ *
+ * Meant to be used in implementations of ::lyplg_type_hash_clb.
+ *
+ * @param[in] hash Hash to add @p data into.
+ * @param[in] data Data to add.
+ * @param[in] len Length of @p data in bytes. If 0, the hash is only mixed so that even empty values change it.
+ * @return Updated hash.
+ */
+uint32_t lyplg_type_hash_data(uint32_t hash, const void *data, size_t len);
+
+/**
+ * @brief Add a stored value into a hash.
+ *
+ * Uses the ::lyplg_type_hash_clb of the value type, if any, otherwise hashes the value in ::LY_VALUE_LYB format.
+ *
+ * @param[in] value Value to hash.
+ * @param[in] hash Hash to add @p value into.
+ * @return Updated hash.
+ */
+uint32_t lyplg_type_hash_value(const struct lyd_value *value, uint32_t hash);
+
+/**
+ * @brief Cache a lazily generated canonical value in ::lyd_value._canonical.
+ *
+ * To be used by ::lyplg_type_print_clb callbacks generating the canonical value on the first request. Values can be
+ * printed by several threads at once (see ::LYD_VALIDATE_MULTI_THREAD) so only the first cached canonical value is
+ * kept and any other is released.
+ *
+ * @param[in] ctx libyang context of the dictionary.
+ * @param[in] canon Generated canonical value.
+ * @param[in] dynamic Whether @p canon is dynamically allocated and should be used directly (and freed) or copied.
+ * @param[in] value Value to cache @p canon in.
+ * @return LY_SUCCESS on success.
+ * @return LY_EMEM on memory allocation failure.
+ */
+LY_ERR lyplg_type_print_cache(const struct ly_ctx *ctx, const char *canon, ly_bool dynamic, const struct lyd_value *value);
+
 /**
  * @brief Get format-specific prefix for a module.
  *
@@ -559,6 +598,18 @@ typedef LY_ERR (*lyplg_type_dup_clb)(const struct ly_ctx *ctx, const struct lyd_
  */
 typedef void (*lyplg_type_free_clb)(const struct ly_ctx *ctx, struct lyd_value *value);
 
+/**
+ * @brief Callback for adding the stored value into a hash.
+ *
+ * The value is hashed directly, without printing it. Values equal according to ::lyplg_type_compare_clb must
+ * always produce the same hash. If not set, the value printed in ::LY_VALUE_LYB format is hashed.
+ *
+ * @param[in] value Value to hash.
+ * @param[in] hash Hash to add the value into, use ::lyplg_type_hash_data() for the hashing.
+ * @return Updated hash, not finished.
+ */
+typedef uint32_t (*lyplg_type_hash_clb)(const struct lyd_value *value, uint32_t hash);
+
 /**
  * @brief Hold type-specific functions for various operations with the data values.
  *
@@ -577,6 +628,7 @@ struct lyplg_type {
     lyplg_type_print_clb print;         /**< printer callback to get string representing the value */
     lyplg_type_dup_clb duplicate;       /**< data duplication callback */
     lyplg_type_free_clb free;           /**< optional function to free the type-spceific way stored value */
+    lyplg_type_hash_clb hash;           /**< optional function to hash the stored value */
     int32_t lyb_data_len;               /**< Length of the data in [LYB format](@ref howtoDataLYB).
                                              For variable-length is set to -1. */
 };
@@ -620,6 +672,11 @@ const void *lyplg_type_print_simple(const struct ly_ctx *ctx, const struct lyd_v
  */
 LY_ERR lyplg_type_dup_simple(const struct ly_ctx *ctx, const struct lyd_value *original, struct lyd_value *dup);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for a generic simple type.
+ */
+uint32_t lyplg_type_hash_simple(const struct lyd_value *value, uint32_t hash);
+
 /**
  * @brief Implementation of ::lyplg_type_free_clb for a generic simple type.
  */
@@ -653,6 +710,11 @@ LY_ERR lyplg_type_compare_binary(const struct lyd_value *val1, const struct lyd_
 const void *lyplg_type_print_binary(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in binary type.
+ */
+uint32_t lyplg_type_hash_binary(const struct lyd_value *value, uint32_t hash);
+
 /**
  * @brief Implementation of ::lyplg_type_dup_clb for the built-in binary type.
  */
@@ -691,6 +753,11 @@ LY_ERR lyplg_type_compare_bits(const struct lyd_value *val1, const struct lyd_va
 const void *lyplg_type_print_bits(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in bits type.
+ */
+uint32_t lyplg_type_hash_bits(const struct lyd_value *value, uint32_t hash);
+
 /**
  * @brief Implementation of the ::lyplg_type_dup_clb for the built-in bits type.
  */
@@ -729,6 +796,11 @@ LY_ERR lyplg_type_compare_boolean(const struct lyd_value *val1, const struct lyd
 const void *lyplg_type_print_boolean(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in boolean type.
+ */
+uint32_t lyplg_type_hash_boolean(const struct lyd_value *value, uint32_t hash);
+
 /** @} pluginsTypesBoolean */
 
 /**
@@ -757,6 +829,11 @@ LY_ERR lyplg_type_compare_decimal64(const struct lyd_value *val1, const struct l
 const void *lyplg_type_print_decimal64(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in decimal64 type.
+ */
+uint32_t lyplg_type_hash_decimal64(const struct lyd_value *value, uint32_t hash);
+
 /** @} pluginsTypesDecimal64 */
 
 /**
@@ -791,12 +868,22 @@ LY_ERR lyplg_type_store_enum(const struct ly_ctx *ctx, const struct lysc_type *t
         uint32_t options, LY_VALUE_FORMAT format, void *prefix_data, uint32_t hints, const struct lysc_node *ctx_node,
         struct lyd_value *storage, struct lys_glob_unres *unres, struct ly_err_item **err);
 
+/**
+ * @brief Implementation of ::lyplg_type_compare_clb for the built-in enumeration type.
+ */
+LY_ERR lyplg_type_compare_enum(const struct lyd_value *val1, const struct lyd_value *val2);
+
 /**
  * @brief Implementation of ::lyplg_type_print_clb for the built-in enumeration type.
  */
 const void *lyplg_type_print_enum(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in enumeration type.
+ */
+uint32_t lyplg_type_hash_enum(const struct lyd_value *value, uint32_t hash);
+
 /** @} pluginsTypesEnumeration */
 
 /**
@@ -897,6 +984,11 @@ LY_ERR lyplg_type_compare_int(const struct lyd_value *val1, const struct lyd_val
 const void *lyplg_type_print_int(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in signed integer types.
+ */
+uint32_t lyplg_type_hash_int(const struct lyd_value *value, uint32_t hash);
+
 /**
  * @brief Implementation of ::lyplg_type_store_clb for the built-in unsigned integer types.
  */
@@ -915,6 +1007,11 @@ LY_ERR lyplg_type_compare_uint(const struct lyd_value *val1, const struct lyd_va
 const void *lyplg_type_print_uint(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in unsigned integer types.
+ */
+uint32_t lyplg_type_hash_uint(const struct lyd_value *value, uint32_t hash);
+
 /** @} pluginsTypesInteger */
 
 /**
@@ -943,6 +1040,11 @@ LY_ERR lyplg_type_compare_leafref(const struct lyd_value *val1, const struct lyd
 const void *lyplg_type_print_leafref(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in leafref type.
+ */
+uint32_t lyplg_type_hash_leafref(const struct lyd_value *value, uint32_t hash);
+
 /**
  * @brief Implementation of ::lyplg_type_dup_clb for the built-in leafref type.
  */
@@ -976,6 +1078,26 @@ LY_ERR lyplg_type_store_string(const struct ly_ctx *ctx, const struct lysc_type
         uint32_t options, LY_VALUE_FORMAT format, void *prefix_data, uint32_t hints, const struct lysc_node *ctx_node,
         struct lyd_value *storage, struct lys_glob_unres *unres, struct ly_err_item **err);
 
+/**
+ * @brief Implementation of ::lyplg_type_compare_clb for the built-in string type.
+ *
+ * Unlike ::lyplg_type_compare_simple(), supports values stored inline with ::LY_CTX_INLINE_STRINGS.
+ */
+LY_ERR lyplg_type_compare_string(const struct lyd_value *val1, const struct lyd_value *val2);
+
+/**
+ * @brief Implementation of ::lyplg_type_print_clb for the built-in string type.
+ *
+ * Unlike ::lyplg_type_print_simple(), supports values stored inline with ::LY_CTX_INLINE_STRINGS.
+ */
+const void *lyplg_type_print_string(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
+        void *prefix_data, ly_bool *dynamic, size_t *value_len);
+
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in string type.
+ */
+uint32_t lyplg_type_hash_string(const struct lyd_value *value, uint32_t hash);
+
 /** @} pluginsTypesString */
 
 /**
@@ -1004,6 +1126,11 @@ LY_ERR lyplg_type_compare_union(const struct lyd_value *val1, const struct lyd_v
 const void *lyplg_type_print_union(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *prefix_data, ly_bool *dynamic, size_t *value_len);
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the built-in union type.
+ */
+uint32_t lyplg_type_hash_union(const struct lyd_value *value, uint32_t hash);
+
 /**
  * @brief Implementation of ::lyplg_type_dup_clb for the built-in union type.
  */
@@ -16,6 +16,7 @@
 
 #include "plugins_types.h"
 
+#include <assert.h>
 #include <ctype.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -57,33 +58,36 @@ static const char b64_etable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrst
 static LY_ERR
 binary_base64_encode(const struct ly_ctx *ctx, const char *data, size_t size, char **str, size_t *str_len)
 {
-    uint32_t i;
+    const unsigned char *in = (const unsigned char *)data, *end;
+    uint32_t n;
     char *ptr;
 
     *str_len = (size + 2) / 3 * 4;
     *str = malloc(*str_len + 1);
     LY_CHECK_ERR_RET(!*str, LOGMEM(ctx), LY_EMEM);
-    if (!(*str_len)) {
-        **str = 0;
-        return LY_SUCCESS;
-    }
 
+    /* whole 3-byte groups */
     ptr = *str;
-    for (i = 0; i < size - 2; i += 3) {
-        *ptr++ = b64_etable[(data[i] >> 2) & 0x3F];
-        *ptr++ = b64_etable[((data[i] & 0x3) << 4) | ((int)(data[i + 1] & 0xF0) >> 4)];
-        *ptr++ = b64_etable[((data[i + 1] & 0xF) << 2) | ((int)(data[i + 2] & 0xC0) >> 6)];
-        *ptr++ = b64_etable[data[i + 2] & 0x3F];
+    end = in + size / 3 * 3;
+    while (in < end) {
+        n = (uint32_t)in[0] << 16 | (uint32_t)in[1] << 8 | in[2];
+        in += 3;
+        *ptr++ = b64_etable[n >> 18];
+        *ptr++ = b64_etable[(n >> 12) & 0x3F];
+        *ptr++ = b64_etable[(n >> 6) & 0x3F];
+        *ptr++ = b64_etable[n & 0x3F];
     }
-    if (i < size) {
-        *ptr++ = b64_etable[(data[i] >> 2) & 0x3F];
-        if (i == (size - 1)) {
-            *ptr++ = b64_etable[((data[i] & 0x3) << 4)];
-            *ptr++ = '=';
-        } else {
-            *ptr++ = b64_etable[((data[i] & 0x3) << 4) | ((int)(data[i + 1] & 0xF0) >> 4)];
-            *ptr++ = b64_etable[((data[i + 1] & 0xF) << 2)];
+
+    /* the rest with padding */
+    size %= 3;
+    if (size) {
+        n = (uint32_t)in[0] << 16;
+        if (size == 2) {
+            n |= (uint32_t)in[1] << 8;
         }
+        *ptr++ = b64_etable[n >> 18];
+        *ptr++ = b64_etable[(n >> 12) & 0x3F];
+        *ptr++ = (size == 2) ? b64_etable[(n >> 6) & 0x3F] : '=';
         *ptr++ = '=';
     }
     *ptr = '\0';
@@ -92,93 +96,120 @@ binary_base64_encode(const struct ly_ctx *ctx, const char *data, size_t size, ch
 }
 
 /**
- * @brief base64 decode table
+ * @brief base64 decode table, 0xFF for characters not in the base64 alphabet (including the padding)
  */
-static const int b64_dtable[256] = {
-    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
-    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 62, 63, 62, 62, 63, 52, 53, 54, 55,
-    56, 57, 58, 59, 60, 61,  0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  3,  4,  5,  6,
-    7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,  0,
-    0,  0,  0, 63,  0, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
-    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+static const uint8_t b64_dtable[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,   62, 0xFF, 0xFF, 0xFF,   63,
+    52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+    15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+    41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
 };
 
 /**
  * @brief Decode the binary value from a base64 string value.
  *
+ * The value is validated on the way so that a separate pass over it is needed only to find the error in
+ * an invalid value.
+ *
  * Reference https://tools.ietf.org/html/rfc4648#section-4
  *
  * @param[in] value Base64-encoded string value.
  * @param[in] value_len Length of @p value.
- * @param[out] data Decoded binary value.
+ * @param[out] data Decoded binary value, garbage if @p value is not valid.
  * @param[out] size Size of @p data.
+ * @param[out] valid Whether @p value is a valid base64 value.
+ * @param[out] canonical Whether a valid @p value is in the canonical form, with zero unused bits before the padding.
  * @return LY_ERR value.
  */
 static LY_ERR
-binary_base64_decode(const char *value, size_t value_len, void **data, size_t *size)
+binary_base64_decode(const char *value, size_t value_len, void **data, size_t *size, ly_bool *valid, ly_bool *canonical)
 {
-    unsigned char *ptr = (unsigned char *)value;
-    uint32_t pad_chars, octet_count;
-    char *str;
+    const unsigned char *ptr = (const unsigned char *)value, *end;
+    uint32_t pad, n, bad = 0;
+    unsigned char *str, *out;
 
-    if (!value_len || (ptr[value_len - 1] != '=')) {
-        pad_chars = 0;
+    /* learn the padding */
+    if ((value_len < 4) || (ptr[value_len - 1] != '=')) {
+        pad = 0;
     } else if (ptr[value_len - 2] == '=') {
-        pad_chars = 1;
+        pad = 2;
     } else {
-        pad_chars = 2;
+        pad = 1;
     }
 
-    octet_count = ((value_len + 3) / 4 - (pad_chars ? 1 : 0)) * 4;
-    *size = octet_count / 4 * 3 + pad_chars;
-
+    /* any trailing incomplete quantum is ignored */
+    *size = value_len / 4 * 3 - pad;
     str = malloc(*size + 1);
     LY_CHECK_RET(!str, LY_EMEM);
     str[*size] = '\0';
 
-    for (uint32_t i = 0, j = 0; i < octet_count; i += 4) {
-        int n = b64_dtable[ptr[i]] << 18 | b64_dtable[ptr[i + 1]] << 12 | b64_dtable[ptr[i + 2]] << 6 | b64_dtable[ptr[i + 3]];
-        str[j++] = n >> 16;
-        str[j++] = n >> 8 & 0xFF;
-        str[j++] = n & 0xFF;
+    /* whole 4-character quanta, without the last padded one */
+    out = str;
+    end = ptr + (value_len & ~(size_t)3) - (pad ? 4 : 0);
+    while (ptr < end) {
+        bad |= b64_dtable[ptr[0]] | b64_dtable[ptr[1]] | b64_dtable[ptr[2]] | b64_dtable[ptr[3]];
+        n = (uint32_t)b64_dtable[ptr[0]] << 18 | (uint32_t)b64_dtable[ptr[1]] << 12 |
+                (uint32_t)b64_dtable[ptr[2]] << 6 | b64_dtable[ptr[3]];
+        ptr += 4;
+        *out++ = n >> 16;
+        *out++ = n >> 8;
+        *out++ = n;
     }
-    if (pad_chars) {
-        int n = b64_dtable[ptr[octet_count]] << 18 | b64_dtable[ptr[octet_count + 1]] << 12;
-        str[*size - pad_chars] = n >> 16;
-
-        if (pad_chars == 2) {
-            n |= b64_dtable[ptr[octet_count + 2]] << 6;
-            n >>= 8 & 0xFF;
-            str[*size - pad_chars + 1] = n;
+
+    /* the last padded quantum */
+    *canonical = 1;
+    if (pad) {
+        bad |= b64_dtable[ptr[0]] | b64_dtable[ptr[1]];
+        n = (uint32_t)b64_dtable[ptr[0]] << 18 | (uint32_t)b64_dtable[ptr[1]] << 12;
+        if (pad == 1) {
+            bad |= b64_dtable[ptr[2]];
+            n |= (uint32_t)b64_dtable[ptr[2]] << 6;
+        }
+        *out++ = n >> 16;
+        if (pad == 1) {
+            *out++ = n >> 8;
+        }
+
+        /* the bits not covered by the decoded bytes must be zero in the canonical form */
+        if (n & ((pad == 1) ? 0xC0 : 0xF000)) {
+            *canonical = 0;
         }
     }
 
+    *valid = !(value_len & 3) && !(bad & 0xC0);
     *data = str;
     return LY_SUCCESS;
 }
 
 /**
- * @brief Validate a base64 string.
+ * @brief Find the error in an invalid base64 string.
  *
- * @param[in] value Value to validate.
+ * @param[in] value Value that failed to be decoded.
  * @param[in] value_len Length of @p value.
- * @param[in] type type of the value.
  * @param[out] err Error information.
  * @return LY_ERR value.
  */
 static LY_ERR
-binary_base64_validate(const char *value, size_t value_len, const struct lysc_type_bin *type, struct ly_err_item **err)
+binary_base64_validate(const char *value, size_t value_len, struct ly_err_item **err)
 {
-    uint32_t idx, pad;
+    size_t idx;
+    uint32_t pad;
 
     /* check correct characters in base64 */
     idx = 0;
-    while ((idx < value_len) &&
-            ((('A' <= value[idx]) && (value[idx] <= 'Z')) ||
-            (('a' <= value[idx]) && (value[idx] <= 'z')) ||
-            (('0' <= value[idx]) && (value[idx] <= '9')) ||
-            ('+' == value[idx]) || ('/' == value[idx]))) {
+    while ((idx < value_len) && (b64_dtable[(unsigned char)value[idx]] != 0xFF)) {
         idx++;
     }
 
@@ -202,12 +233,6 @@ binary_base64_validate(const char *value, size_t value_len, const struct lysc_ty
         return ly_err_new(err, LY_EVALID, LYVE_DATA, NULL, NULL, "Base64 encoded value length must be divisible by 4.");
     }
 
-    /* length restriction of the binary value */
-    if (type->length) {
-        const uint32_t octet_count = ((idx + pad) / 4) * 3 - pad;
-        LY_CHECK_RET(lyplg_type_validate_range(LY_TYPE_BINARY, type->length, octet_count, value, value_len, err));
-    }
-
     return LY_SUCCESS;
 }
 
@@ -220,6 +245,7 @@ lyplg_type_store_binary(const struct ly_ctx *ctx, const struct lysc_type *type,
     LY_ERR ret = LY_SUCCESS;
     struct lysc_type_bin *type_bin = (struct lysc_type_bin *)type;
     struct lyd_value_binary *val;
+    ly_bool valid, canonical;
 
     /* init storage */
     memset(storage, 0, sizeof *storage);
@@ -252,18 +278,30 @@ lyplg_type_store_binary(const struct ly_ctx *ctx, const struct lysc_type *type,
     ret = lyplg_type_check_hints(hints, value, value_len, type->basetype, NULL, err);
     LY_CHECK_GOTO(ret, cleanup);
 
+    /* get the binary value */
+    ret = binary_base64_decode(value, value_len, &val->data, &val->size, &valid, &canonical);
+    LY_CHECK_GOTO(ret, cleanup);
+
     /* validate */
     if (format != LY_VALUE_CANON) {
-        ret = binary_base64_validate(value, value_len, type_bin, err);
-        LY_CHECK_GOTO(ret, cleanup);
-    }
+        if (!valid) {
+            /* find the error */
+            ret = binary_base64_validate(value, value_len, err);
+            assert(ret);
+            goto cleanup;
+        }
 
-    /* get the binary value */
-    ret = binary_base64_decode(value, value_len, &val->data, &val->size);
-    LY_CHECK_GOTO(ret, cleanup);
+        /* length restriction of the binary value */
+        if (type_bin->length) {
+            ret = lyplg_type_validate_range(LY_TYPE_BINARY, type_bin->length, val->size, value, value_len, err);
+            LY_CHECK_GOTO(ret, cleanup);
+        }
+    }
 
     /* store canonical value */
-    if (options & LYPLG_TYPE_STORE_DYNAMIC) {
+    if (!canonical) {
+        /* non-zero bits before the padding, the canonical value is generated when printed */
+    } else if (options & LYPLG_TYPE_STORE_DYNAMIC) {
         ret = lydict_insert_zc(ctx, (char *)value, &storage->_canonical);
         options &= ~LYPLG_TYPE_STORE_DYNAMIC;
         LY_CHECK_GOTO(ret, cleanup);
@@ -327,7 +365,7 @@ lyplg_type_print_binary(const struct ly_ctx *ctx, const struct lyd_value *value,
         }
 
         /* store it */
-        if (lydict_insert_zc(ctx, ret, (const char **)&value->_canonical)) {
+        if (lyplg_type_print_cache(ctx, ret, 1, value)) {
             LOGMEM(ctx);
             return NULL;
         }
@@ -387,6 +425,15 @@ lyplg_type_free_binary(const struct ly_ctx *ctx, struct lyd_value *value)
     }
 }
 
+API uint32_t
+lyplg_type_hash_binary(const struct lyd_value *value, uint32_t hash)
+{
+    struct lyd_value_binary *val;
+
+    LYD_VALUE_GET(value, val);
+    return lyplg_type_hash_data(hash, val->data, val->size);
+}
+
 /**
  * @brief Plugin information for binray type implementation.
  *
@@ -408,6 +455,7 @@ const struct lyplg_type_record plugins_binary[] = {
         .plugin.print = lyplg_type_print_binary,
         .plugin.duplicate = lyplg_type_dup_binary,
         .plugin.free = lyplg_type_free_binary,
+        .plugin.hash = lyplg_type_hash_binary,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -59,8 +59,7 @@ lyplg_type_bits_bitmap_size(const struct lysc_type_bits *type)
     LY_CHECK_ARG_RET(NULL, type, type->basetype == LY_TYPE_BITS, 0);
 
     /* minimum needed bytes to hold all the bit positions */
-    needed_bytes = (BITS_LAST_BIT_POSITION(type) / 8) + (BITS_LAST_BIT_POSITION(type) % 8 ? 1 : 0);
-    LY_CHECK_ERR_RET(!needed_bytes, LOGINT(NULL), 0);
+    needed_bytes = (BITS_LAST_BIT_POSITION(type) / 8) + 1;
 
     if ((needed_bytes == 1) || (needed_bytes == 2)) {
         /* uint8_t or uint16_t */
@@ -138,7 +137,7 @@ bits_bit_set(char *bitmap, size_t size, uint32_t bit_position)
 static LY_ERR
 bits_str2bitmap(const char *value, size_t value_len, struct lysc_type_bits *type, char *bitmap, struct ly_err_item **err)
 {
-    size_t idx_start, idx_end;
+    size_t idx_start, idx_end, bitmap_size = lyplg_type_bits_bitmap_size(type);
     LY_ARRAY_COUNT_TYPE u;
     ly_bool found;
 
@@ -174,114 +173,59 @@ bits_str2bitmap(const char *value, size_t value_len, struct lysc_type_bits *type
         }
 
         /* check for duplication */
-        if (lyplg_type_bits_is_bit_set(bitmap, lyplg_type_bits_bitmap_size(type), type->bits[u].position)) {
+        if (lyplg_type_bits_is_bit_set(bitmap, bitmap_size, type->bits[u].position)) {
             return ly_err_new(err, LY_EVALID, LYVE_DATA, NULL, NULL, "Duplicate bit \"%s\".", type->bits[u].name);
         }
 
         /* set the bit */
-        bits_bit_set(bitmap, lyplg_type_bits_bitmap_size(type), type->bits[u].position);
+        bits_bit_set(bitmap, bitmap_size, type->bits[u].position);
     }
 
     return LY_SUCCESS;
 }
 
 /**
- * @brief Add a bit item into an array.
+ * @brief Generate canonical value from a bitmap.
  *
- * @param[in] position Bit position to add.
- * @param[in] type Bitis type to read the bit positions and names from.
- * @param[in,out] items Array of bit item pointers to add to.
- */
-static void
-bits_add_item(uint32_t position, struct lysc_type_bits *type, struct lysc_type_bitenum_item **items)
-{
-    LY_ARRAY_COUNT_TYPE u;
-
-    /* find the bit item */
-    LY_ARRAY_FOR(type->bits, u) {
-        if (type->bits[u].position == position) {
-            break;
-        }
-    }
-
-    /* add it at the end */
-    items[LY_ARRAY_COUNT(items)] = &type->bits[u];
-    LY_ARRAY_INCREMENT(items);
-}
-
-/**
- * @brief Convert a bitmap to a sized array of pointers to their bit definitions.
+ * The bits of a type are ordered by their position so the set bits are found in the canonical order by
+ * checking the bits of the type one by one.
  *
  * @param[in] bitmap Bitmap to read from.
  * @param[in] type Bits type.
- * @param[in,out] items Allocated sized array to fill with the set bits.
- */
-static void
-bits_bitmap2items(const char *bitmap, struct lysc_type_bits *type, struct lysc_type_bitenum_item **items)
-{
-    size_t i, bitmap_size = lyplg_type_bits_bitmap_size(type);
-    uint32_t bit_pos;
-    uint8_t bitmask;
-    const uint8_t *byte;
-
-    bit_pos = 0;
-    for (i = 0; i < bitmap_size; ++i) {
-        /* check this byte (but not necessarily all bits in the last byte) */
-        byte = (uint8_t *)BITS_BITMAP_BYTE(bitmap, bitmap_size, i);
-        for (bitmask = 1; bitmask; bitmask <<= 1) {
-            if (*byte & bitmask) {
-                /* add this bit */
-                bits_add_item(bit_pos, type, items);
-            }
-
-            if (bit_pos == BITS_LAST_BIT_POSITION(type)) {
-                /* we have checked the last valid bit */
-                break;
-            }
-
-            ++bit_pos;
-        }
-    }
-}
-
-/**
- * @brief Generate canonical value from ordered array of set bit items.
- *
- * @param[in] items Sized array of set bit items.
  * @param[out] canonical Canonical string value.
  * @return LY_ERR value.
  */
 static LY_ERR
-bits_items2canon(struct lysc_type_bitenum_item **items, char **canonical)
+bits_bitmap2canon(const char *bitmap, const struct lysc_type_bits *type, char **canonical)
 {
-    char *ret;
-    size_t ret_len;
+    size_t bitmap_size = lyplg_type_bits_bitmap_size(type), len = 0, name_len;
     LY_ARRAY_COUNT_TYPE u;
+    char *ptr;
 
-    *canonical = NULL;
-
-    /* init value */
-    ret = strdup("");
-    LY_CHECK_RET(!ret, LY_EMEM);
-    ret_len = 0;
-
-    LY_ARRAY_FOR(items, u) {
-        if (!ret_len) {
-            ret = ly_realloc(ret, strlen(items[u]->name) + 1);
-            LY_CHECK_RET(!ret, LY_EMEM);
-            strcpy(ret, items[u]->name);
+    /* learn the length */
+    LY_ARRAY_FOR(type->bits, u) {
+        if (lyplg_type_bits_is_bit_set(bitmap, bitmap_size, type->bits[u].position)) {
+            len += (len ? 1 : 0) + strlen(type->bits[u].name);
+        }
+    }
 
-            ret_len = strlen(ret);
-        } else {
-            ret = ly_realloc(ret, ret_len + 1 + strlen(items[u]->name) + 1);
-            LY_CHECK_RET(!ret, LY_EMEM);
-            sprintf(ret + ret_len, " %s", items[u]->name);
+    *canonical = malloc(len + 1);
+    LY_CHECK_RET(!*canonical, LY_EMEM);
 
-            ret_len += 1 + strlen(items[u]->name);
+    /* print the names */
+    ptr = *canonical;
+    LY_ARRAY_FOR(type->bits, u) {
+        if (lyplg_type_bits_is_bit_set(bitmap, bitmap_size, type->bits[u].position)) {
+            if (ptr != *canonical) {
+                *ptr++ = ' ';
+            }
+            name_len = strlen(type->bits[u].name);
+            memcpy(ptr, type->bits[u].name, name_len);
+            ptr += name_len;
         }
     }
+    *ptr = '\0';
 
-    *canonical = ret;
     return LY_SUCCESS;
 }
 
@@ -319,10 +263,6 @@ lyplg_type_store_bits(const struct ly_ctx *ctx, const struct lysc_type *type, co
             memcpy(val->bitmap, value, value_len);
         }
 
-        /* allocate and fill the bit item array */
-        LY_ARRAY_CREATE_GOTO(ctx, val->items, LY_ARRAY_COUNT(type_bits->bits), ret, cleanup);
-        bits_bitmap2items(val->bitmap, type_bits, val->items);
-
         /* success */
         goto cleanup;
     }
@@ -332,18 +272,13 @@ lyplg_type_store_bits(const struct ly_ctx *ctx, const struct lysc_type *type, co
     LY_CHECK_GOTO(ret, cleanup);
 
     /* allocate the bitmap */
-    val->bitmap = malloc(lyplg_type_bits_bitmap_size(type_bits));
+    val->bitmap = calloc(1, lyplg_type_bits_bitmap_size(type_bits));
     LY_CHECK_ERR_GOTO(!val->bitmap, ret = LY_EMEM, cleanup);
-    memset(val->bitmap, 0, lyplg_type_bits_bitmap_size(type_bits));
 
     /* fill the bitmap */
     ret = bits_str2bitmap(value, value_len, type_bits, val->bitmap, err);
     LY_CHECK_GOTO(ret, cleanup);
 
-    /* allocate and fill the bit item array */
-    LY_ARRAY_CREATE_GOTO(ctx, val->items, LY_ARRAY_COUNT(type_bits->bits), ret, cleanup);
-    bits_bitmap2items(val->bitmap, type_bits, val->items);
-
     if (format == LY_VALUE_CANON) {
         /* store canonical value */
         if (options & LYPLG_TYPE_STORE_DYNAMIC) {
@@ -407,12 +342,12 @@ lyplg_type_print_bits(const struct ly_ctx *ctx, const struct lyd_value *value, L
     /* generate canonical value if not already */
     if (!value->_canonical) {
         /* get the canonical value */
-        if (bits_items2canon(val->items, &ret)) {
+        if (bits_bitmap2canon(val->bitmap, type_bits, &ret)) {
             return NULL;
         }
 
         /* store it */
-        if (lydict_insert_zc(ctx, ret, (const char **)&value->_canonical)) {
+        if (lyplg_type_print_cache(ctx, ret, 1, value)) {
             LOGMEM(ctx);
             return NULL;
         }
@@ -433,7 +368,6 @@ lyplg_type_dup_bits(const struct ly_ctx *ctx, const struct lyd_value *original,
 {
     LY_ERR ret;
     struct lysc_type_bits *type_bits = (struct lysc_type_bits *)original->realtype;
-    LY_ARRAY_COUNT_TYPE u;
     struct lyd_value_bits *orig_val, *dup_val;
 
     memset(dup, 0, sizeof *dup);
@@ -453,13 +387,6 @@ lyplg_type_dup_bits(const struct ly_ctx *ctx, const struct lyd_value *original,
     LY_CHECK_ERR_GOTO(!dup_val->bitmap, ret = LY_EMEM, error);
     memcpy(dup_val->bitmap, orig_val->bitmap, lyplg_type_bits_bitmap_size(type_bits));
 
-    /* duplicate bit item pointers */
-    LY_ARRAY_CREATE_GOTO(ctx, dup_val->items, LY_ARRAY_COUNT(orig_val->items), ret, error);
-    LY_ARRAY_FOR(orig_val->items, u) {
-        LY_ARRAY_INCREMENT(dup_val->items);
-        dup_val->items[u] = orig_val->items[u];
-    }
-
     dup->realtype = original->realtype;
     return LY_SUCCESS;
 
@@ -478,11 +405,20 @@ lyplg_type_free_bits(const struct ly_ctx *ctx, struct lyd_value *value)
     LYD_VALUE_GET(value, val);
     if (val) {
         free(val->bitmap);
-        LY_ARRAY_FREE(val->items);
         LYPLG_TYPE_VAL_INLINE_DESTROY(val);
     }
 }
 
+API uint32_t
+lyplg_type_hash_bits(const struct lyd_value *value, uint32_t hash)
+{
+    struct lysc_type_bits *type_bits = (struct lysc_type_bits *)value->realtype;
+    struct lyd_value_bits *val;
+
+    LYD_VALUE_GET(value, val);
+    return lyplg_type_hash_data(hash, val->bitmap, lyplg_type_bits_bitmap_size(type_bits));
+}
+
 /**
  * @brief Plugin information for bits type implementation.
  *
@@ -504,6 +440,7 @@ const struct lyplg_type_record plugins_bits[] = {
         .plugin.print = lyplg_type_print_bits,
         .plugin.duplicate = lyplg_type_dup_bits,
         .plugin.free = lyplg_type_free_bits,
+        .plugin.hash = lyplg_type_hash_bits,
         .plugin.lyb_data_len = -1,
     },
     {0}
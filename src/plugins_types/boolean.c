@@ -54,14 +54,10 @@ lyplg_type_store_boolean(const struct ly_ctx *ctx, const struct lysc_type *type,
             goto cleanup;
         }
 
-        /* store value */
+        /* store value, the canonical value is generated only when needed */
         i = *(int8_t *)value;
         storage->boolean = i ? 1 : 0;
 
-        /* store canonical value, it always is */
-        ret = lydict_insert(ctx, i ? "true" : "false", 0, &storage->_canonical);
-        LY_CHECK_GOTO(ret, cleanup);
-
         /* success */
         goto cleanup;
     }
@@ -82,16 +78,6 @@ lyplg_type_store_boolean(const struct ly_ctx *ctx, const struct lysc_type *type,
     }
     storage->boolean = i;
 
-    /* store canonical value, it always is */
-    if (options & LYPLG_TYPE_STORE_DYNAMIC) {
-        ret = lydict_insert_zc(ctx, (char *)value, &storage->_canonical);
-        options &= ~LYPLG_TYPE_STORE_DYNAMIC;
-        LY_CHECK_GOTO(ret, cleanup);
-    } else {
-        ret = lydict_insert(ctx, value, value_len, &storage->_canonical);
-        LY_CHECK_GOTO(ret, cleanup);
-    }
-
 cleanup:
     if (options & LYPLG_TYPE_STORE_DYNAMIC) {
         free((char *)value);
@@ -117,7 +103,7 @@ lyplg_type_compare_boolean(const struct lyd_value *val1, const struct lyd_value
 }
 
 API const void *
-lyplg_type_print_boolean(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *value, LY_VALUE_FORMAT format,
+lyplg_type_print_boolean(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *UNUSED(prefix_data), ly_bool *dynamic, size_t *value_len)
 {
     if (format == LY_VALUE_LYB) {
@@ -128,6 +114,14 @@ lyplg_type_print_boolean(const struct ly_ctx *UNUSED(ctx), const struct lyd_valu
         return &value->boolean;
     }
 
+    /* generate canonical value if not already */
+    if (!value->_canonical) {
+        if (lyplg_type_print_cache(ctx, value->boolean ? "true" : "false", 0, value)) {
+            LOGMEM(ctx);
+            return NULL;
+        }
+    }
+
     /* use the cached canonical value */
     if (dynamic) {
         *dynamic = 0;
@@ -138,6 +132,12 @@ lyplg_type_print_boolean(const struct ly_ctx *UNUSED(ctx), const struct lyd_valu
     return value->_canonical;
 }
 
+API uint32_t
+lyplg_type_hash_boolean(const struct lyd_value *value, uint32_t hash)
+{
+    return lyplg_type_hash_data(hash, &value->boolean, sizeof value->boolean);
+}
+
 /**
  * @brief Plugin information for boolean type implementation.
  *
@@ -159,6 +159,7 @@ const struct lyplg_type_record plugins_boolean[] = {
         .plugin.print = lyplg_type_print_boolean,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_boolean,
         .plugin.lyb_data_len = 1,
     },
     {0}
@@ -198,7 +198,7 @@ lyplg_type_print_date_and_time(const struct ly_ctx *ctx, const struct lyd_value
         }
 
         /* store it */
-        if (lydict_insert_zc(ctx, ret, (const char **)&value->_canonical)) {
+        if (lyplg_type_print_cache(ctx, ret, 1, value)) {
             LOGMEM(ctx);
             return NULL;
         }
@@ -269,6 +269,19 @@ lyplg_type_free_date_and_time(const struct ly_ctx *ctx, struct lyd_value *value)
     }
 }
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for ietf-yang-types date-and-time type.
+ */
+static uint32_t
+lyplg_type_hash_date_and_time(const struct lyd_value *value, uint32_t hash)
+{
+    struct lyd_value_date_and_time *val;
+
+    LYD_VALUE_GET(value, val);
+    hash = lyplg_type_hash_data(hash, &val->time, sizeof val->time);
+    return lyplg_type_hash_data(hash, val->fractions_s, ly_strlen(val->fractions_s));
+}
+
 /**
  * @brief Plugin information for date-and-time type implementation.
  *
@@ -290,6 +303,7 @@ const struct lyplg_type_record plugins_date_and_time[] = {
         .plugin.print = lyplg_type_print_date_and_time,
         .plugin.duplicate = lyplg_type_dup_date_and_time,
         .plugin.free = lyplg_type_free_date_and_time,
+        .plugin.hash = lyplg_type_hash_date_and_time,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -38,17 +38,12 @@
  *
  * @param[in] num Decimal64 number stored in int64.
  * @param[in] type Decimal64 type with fraction digits.
- * @param[out] str Canonical string value.
- * @return LY_ERR value.
+ * @param[out] ret Buffer of ::LY_NUMBER_MAXLEN size for the canonical string value.
  */
-static LY_ERR
-decimal64_num2str(int64_t num, struct lysc_type_dec *type, char **str)
+static void
+decimal64_num2str(int64_t num, const struct lysc_type_dec *type, char *ret)
 {
-    char *ret;
-
-    /* allocate the value */
-    ret = calloc(1, LY_NUMBER_MAXLEN);
-    LY_CHECK_RET(!ret, LY_EMEM);
+    memset(ret, 0, LY_NUMBER_MAXLEN);
 
     if (num) {
         int count = sprintf(ret, "%" PRId64 " ", num);
@@ -74,9 +69,6 @@ decimal64_num2str(int64_t num, struct lysc_type_dec *type, char **str)
         /* zero */
         sprintf(ret, "0.0");
     }
-
-    *str = ret;
-    return LY_SUCCESS;
 }
 
 API LY_ERR
@@ -88,7 +80,7 @@ lyplg_type_store_decimal64(const struct ly_ctx *ctx, const struct lysc_type *typ
     struct lysc_type_dec *type_dec = (struct lysc_type_dec *)type;
     LY_ERR ret = LY_SUCCESS;
     int64_t num;
-    char *canon;
+    char canon[LY_NUMBER_MAXLEN];
 
     /* init storage */
     memset(storage, 0, sizeof *storage);
@@ -118,9 +110,8 @@ lyplg_type_store_decimal64(const struct ly_ctx *ctx, const struct lysc_type *typ
     /* store value */
     storage->dec64 = num;
 
-    /* we need canonical value for the range check */
     if (format == LY_VALUE_CANON) {
-        /* store canonical value */
+        /* store canonical value, otherwise it is generated only when needed */
         if (options & LYPLG_TYPE_STORE_DYNAMIC) {
             ret = lydict_insert_zc(ctx, (char *)value, &storage->_canonical);
             options &= ~LYPLG_TYPE_STORE_DYNAMIC;
@@ -129,20 +120,12 @@ lyplg_type_store_decimal64(const struct ly_ctx *ctx, const struct lysc_type *typ
             ret = lydict_insert(ctx, value, value_len, &storage->_canonical);
             LY_CHECK_GOTO(ret, cleanup);
         }
-    } else {
-        /* generate canonical value */
-        ret = decimal64_num2str(num, type_dec, &canon);
-        LY_CHECK_GOTO(ret, cleanup);
-
-        /* store it */
-        ret = lydict_insert_zc(ctx, canon, (const char **)&storage->_canonical);
-        LY_CHECK_GOTO(ret, cleanup);
     }
 
     if (type_dec->range) {
-        /* check range of the number */
-        ret = lyplg_type_validate_range(type->basetype, type_dec->range, num, storage->_canonical,
-                strlen(storage->_canonical), err);
+        /* check range of the number, we need canonical value for the error message */
+        decimal64_num2str(num, type_dec, canon);
+        ret = lyplg_type_validate_range(type->basetype, type_dec->range, num, canon, strlen(canon), err);
         LY_CHECK_GOTO(ret, cleanup);
     }
 
@@ -172,11 +155,12 @@ lyplg_type_compare_decimal64(const struct lyd_value *val1, const struct lyd_valu
 }
 
 API const void *
-lyplg_type_print_decimal64(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *value, LY_VALUE_FORMAT format,
+lyplg_type_print_decimal64(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *UNUSED(prefix_data), ly_bool *dynamic, size_t *value_len)
 {
     int64_t num = 0;
     void *buf;
+    char canon[LY_NUMBER_MAXLEN];
 
     if (format == LY_VALUE_LYB) {
         num = htole64(value->dec64);
@@ -201,6 +185,17 @@ lyplg_type_print_decimal64(const struct ly_ctx *UNUSED(ctx), const struct lyd_va
         }
     }
 
+    /* generate canonical value if not already */
+    if (!value->_canonical) {
+        decimal64_num2str(value->dec64, (const struct lysc_type_dec *)value->realtype, canon);
+
+        /* store it */
+        if (lyplg_type_print_cache(ctx, canon, 0, value)) {
+            LOGMEM(ctx);
+            return NULL;
+        }
+    }
+
     /* use the cached canonical value */
     if (dynamic) {
         *dynamic = 0;
@@ -211,6 +206,12 @@ lyplg_type_print_decimal64(const struct ly_ctx *UNUSED(ctx), const struct lyd_va
     return value->_canonical;
 }
 
+API uint32_t
+lyplg_type_hash_decimal64(const struct lyd_value *value, uint32_t hash)
+{
+    return lyplg_type_hash_data(hash, &value->dec64, sizeof value->dec64);
+}
+
 /**
  * @brief Plugin information for decimal64 type implementation.
  *
@@ -232,6 +233,7 @@ const struct lyplg_type_record plugins_decimal64[] = {
         .plugin.print = lyplg_type_print_decimal64,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_decimal64,
         .plugin.lyb_data_len = 8,
     },
     {0}
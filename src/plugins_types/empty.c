@@ -97,6 +97,7 @@ const struct lyplg_type_record plugins_empty[] = {
         .plugin.print = lyplg_type_print_simple,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_simple,
         .plugin.lyb_data_len = 0,
     },
     {0}
@@ -80,13 +80,9 @@ lyplg_type_store_enum(const struct ly_ctx *ctx, const struct lysc_type *type, co
             goto cleanup;
         }
 
-        /* store value */
+        /* store value, the canonical value is generated only when needed */
         storage->enum_item = &type_enum->enums[u];
 
-        /* canonical settings via dictionary due to free callback */
-        ret = lydict_insert(ctx, type_enum->enums[u].name, 0, &storage->_canonical);
-        LY_CHECK_GOTO(ret, cleanup);
-
         /* success */
         goto cleanup;
     }
@@ -110,19 +106,9 @@ lyplg_type_store_enum(const struct ly_ctx *ctx, const struct lysc_type *type, co
         goto cleanup;
     }
 
-    /* store value */
+    /* store value, the canonical value is generated only when needed */
     storage->enum_item = &type_enum->enums[u];
 
-    /* store canonical value, it always is */
-    if (options & LYPLG_TYPE_STORE_DYNAMIC) {
-        ret = lydict_insert_zc(ctx, (char *)value, &storage->_canonical);
-        options &= ~LYPLG_TYPE_STORE_DYNAMIC;
-        LY_CHECK_GOTO(ret, cleanup);
-    } else {
-        ret = lydict_insert(ctx, value, value_len, &storage->_canonical);
-        LY_CHECK_GOTO(ret, cleanup);
-    }
-
 cleanup:
     if (options & LYPLG_TYPE_STORE_DYNAMIC) {
         free((void *)value);
@@ -134,8 +120,21 @@ cleanup:
     return ret;
 }
 
+API LY_ERR
+lyplg_type_compare_enum(const struct lyd_value *val1, const struct lyd_value *val2)
+{
+    if (val1->realtype != val2->realtype) {
+        return LY_ENOT;
+    }
+
+    if (val1->enum_item != val2->enum_item) {
+        return LY_ENOT;
+    }
+    return LY_SUCCESS;
+}
+
 API const void *
-lyplg_type_print_enum(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *value, LY_VALUE_FORMAT format,
+lyplg_type_print_enum(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *UNUSED(prefix_data), ly_bool *dynamic, size_t *value_len)
 {
     int64_t prev_num = 0, num = 0;
@@ -165,6 +164,14 @@ lyplg_type_print_enum(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *
         }
     }
 
+    /* generate canonical value if not already, it is the item name */
+    if (!value->_canonical) {
+        if (lyplg_type_print_cache(ctx, value->enum_item->name, 0, value)) {
+            LOGMEM(ctx);
+            return NULL;
+        }
+    }
+
     /* use the cached canonical value */
     if (dynamic) {
         *dynamic = 0;
@@ -175,6 +182,12 @@ lyplg_type_print_enum(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *
     return value->_canonical;
 }
 
+API uint32_t
+lyplg_type_hash_enum(const struct lyd_value *value, uint32_t hash)
+{
+    return lyplg_type_hash_data(hash, &value->enum_item->value, sizeof value->enum_item->value);
+}
+
 /**
  * @brief Plugin information for enumeration type implementation.
  *
@@ -191,11 +204,12 @@ const struct lyplg_type_record plugins_enumeration[] = {
         .plugin.id = "libyang 2 - enumeration, version 1",
         .plugin.store = lyplg_type_store_enum,
         .plugin.validate = NULL,
-        .plugin.compare = lyplg_type_compare_simple,
+        .plugin.compare = lyplg_type_compare_enum,
         .plugin.sort = NULL,
         .plugin.print = lyplg_type_print_enum,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_enum,
         .plugin.lyb_data_len = 4,
     },
     {0}
@@ -344,6 +344,7 @@ const struct lyplg_type_record plugins_identityref[] = {
         .plugin.print = lyplg_type_print_identityref,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_simple,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -12,7 +12,7 @@
  *     https://opensource.org/licenses/BSD-3-Clause
  */
 
-#define _GNU_SOURCE /* asprintf, strdup */
+#define _GNU_SOURCE /* strdup */
 
 #include "plugins_types.h"
 
@@ -44,6 +44,33 @@ static size_t integer_lyb_size[] = {
     [LY_TYPE_UINT8] = 1, [LY_TYPE_UINT16] = 2, [LY_TYPE_UINT32] = 4, [LY_TYPE_UINT64] = 8
 };
 
+/**
+ * @brief Check whether a number is in a range, without creating any error.
+ *
+ * @param[in] basetype Base type of the number, unsigned numbers are cast to uint64_t.
+ * @param[in] range Range restriction.
+ * @param[in] num Number to check.
+ * @return Whether @p num is in @p range.
+ */
+static ly_bool
+integer_in_range(LY_DATA_TYPE basetype, const struct lysc_range *range, int64_t num)
+{
+    LY_ARRAY_COUNT_TYPE u;
+
+    LY_ARRAY_FOR(range->parts, u) {
+        if (basetype < LY_TYPE_DEC64) {
+            /* unsigned */
+            if (((uint64_t)num >= range->parts[u].min_u64) && ((uint64_t)num <= range->parts[u].max_u64)) {
+                return 1;
+            }
+        } else if ((num >= range->parts[u].min_64) && (num <= range->parts[u].max_64)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 API LY_ERR
 lyplg_type_store_int(const struct ly_ctx *ctx, const struct lysc_type *type, const void *value, size_t value_len,
         uint32_t options, LY_VALUE_FORMAT format, void *UNUSED(prefix_data), uint32_t hints,
@@ -53,7 +80,7 @@ lyplg_type_store_int(const struct ly_ctx *ctx, const struct lysc_type *type, con
     LY_ERR ret = LY_SUCCESS;
     int64_t num = 0;
     int base = 1;
-    char *canon = NULL;
+    char canon[LY_NUMBER_MAXLEN];
     struct lysc_type_num *type_num = (struct lysc_type_num *)type;
 
     /* init storage */
@@ -121,7 +148,7 @@ lyplg_type_store_int(const struct ly_ctx *ctx, const struct lysc_type *type, con
     }
 
     if (format == LY_VALUE_CANON) {
-        /* store canonical value */
+        /* store canonical value, otherwise it is generated only when needed */
         if (options & LYPLG_TYPE_STORE_DYNAMIC) {
             ret = lydict_insert_zc(ctx, (char *)value, &storage->_canonical);
             options &= ~LYPLG_TYPE_STORE_DYNAMIC;
@@ -130,34 +157,12 @@ lyplg_type_store_int(const struct ly_ctx *ctx, const struct lysc_type *type, con
             ret = lydict_insert(ctx, value, value_len, &storage->_canonical);
             LY_CHECK_GOTO(ret, cleanup);
         }
-    } else {
-        /* generate canonical value */
-        switch (type->basetype) {
-        case LY_TYPE_INT8:
-            LY_CHECK_ERR_GOTO(asprintf(&canon, "%" PRId8, storage->int8) == -1, ret = LY_EMEM, cleanup);
-            break;
-        case LY_TYPE_INT16:
-            LY_CHECK_ERR_GOTO(asprintf(&canon, "%" PRId16, storage->int16) == -1, ret = LY_EMEM, cleanup);
-            break;
-        case LY_TYPE_INT32:
-            LY_CHECK_ERR_GOTO(asprintf(&canon, "%" PRId32, storage->int32) == -1, ret = LY_EMEM, cleanup);
-            break;
-        case LY_TYPE_INT64:
-            LY_CHECK_ERR_GOTO(asprintf(&canon, "%" PRId64, storage->int64) == -1, ret = LY_EMEM, cleanup);
-            break;
-        default:
-            break;
-        }
-
-        /* store it */
-        ret = lydict_insert_zc(ctx, canon, (const char **)&storage->_canonical);
-        LY_CHECK_GOTO(ret, cleanup);
     }
 
-    /* validate range of the number */
-    if (type_num->range) {
-        ret = lyplg_type_validate_range(type->basetype, type_num->range, num, storage->_canonical,
-                strlen(storage->_canonical), err);
+    /* validate range of the number, it is printed only for the error message */
+    if (type_num->range && !integer_in_range(type->basetype, type_num->range, num)) {
+        sprintf(canon, "%" PRId64, num);
+        ret = lyplg_type_validate_range(type->basetype, type_num->range, num, canon, strlen(canon), err);
         LY_CHECK_GOTO(ret, cleanup);
     }
 
@@ -207,11 +212,12 @@ lyplg_type_compare_int(const struct lyd_value *val1, const struct lyd_value *val
 }
 
 API const void *
-lyplg_type_print_int(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *value, LY_VALUE_FORMAT format,
+lyplg_type_print_int(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *UNUSED(prefix_data), ly_bool *dynamic, size_t *value_len)
 {
     int64_t prev_num = 0, num = 0;
     void *buf;
+    char canon[LY_NUMBER_MAXLEN];
 
     if (format == LY_VALUE_LYB) {
         switch (value->realtype->basetype) {
@@ -252,6 +258,32 @@ lyplg_type_print_int(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *v
         }
     }
 
+    /* generate canonical value if not already */
+    if (!value->_canonical) {
+        switch (value->realtype->basetype) {
+        case LY_TYPE_INT8:
+            sprintf(canon, "%" PRId8, value->int8);
+            break;
+        case LY_TYPE_INT16:
+            sprintf(canon, "%" PRId16, value->int16);
+            break;
+        case LY_TYPE_INT32:
+            sprintf(canon, "%" PRId32, value->int32);
+            break;
+        case LY_TYPE_INT64:
+            sprintf(canon, "%" PRId64, value->int64);
+            break;
+        default:
+            return NULL;
+        }
+
+        /* store it */
+        if (lyplg_type_print_cache(ctx, canon, 0, value)) {
+            LOGMEM(ctx);
+            return NULL;
+        }
+    }
+
     /* use the cached canonical value */
     if (dynamic) {
         *dynamic = 0;
@@ -271,7 +303,7 @@ lyplg_type_store_uint(const struct ly_ctx *ctx, const struct lysc_type *type, co
     LY_ERR ret = LY_SUCCESS;
     uint64_t num = 0;
     int base = 0;
-    char *canon;
+    char canon[LY_NUMBER_MAXLEN];
     struct lysc_type_num *type_num = (struct lysc_type_num *)type;
 
     /* init storage */
@@ -334,7 +366,7 @@ lyplg_type_store_uint(const struct ly_ctx *ctx, const struct lysc_type *type, co
     }
 
     if (format == LY_VALUE_CANON) {
-        /* store canonical value */
+        /* store canonical value, otherwise it is generated only when needed */
         if (options & LYPLG_TYPE_STORE_DYNAMIC) {
             ret = lydict_insert_zc(ctx, (char *)value, &storage->_canonical);
             options &= ~LYPLG_TYPE_STORE_DYNAMIC;
@@ -343,19 +375,12 @@ lyplg_type_store_uint(const struct ly_ctx *ctx, const struct lysc_type *type, co
             ret = lydict_insert(ctx, value, value_len, &storage->_canonical);
             LY_CHECK_GOTO(ret, cleanup);
         }
-    } else {
-        /* generate canonical value */
-        LY_CHECK_ERR_GOTO(asprintf(&canon, "%" PRIu64, num) == -1, ret = LY_EMEM, cleanup);
-
-        /* store it */
-        ret = lydict_insert_zc(ctx, canon, (const char **)&storage->_canonical);
-        LY_CHECK_GOTO(ret, cleanup);
     }
 
-    /* validate range of the number */
-    if (type_num->range) {
-        ret = lyplg_type_validate_range(type->basetype, type_num->range, num, storage->_canonical,
-                strlen(storage->_canonical), err);
+    /* validate range of the number, it is printed only for the error message */
+    if (type_num->range && !integer_in_range(type->basetype, type_num->range, num)) {
+        sprintf(canon, "%" PRIu64, num);
+        ret = lyplg_type_validate_range(type->basetype, type_num->range, num, canon, strlen(canon), err);
         LY_CHECK_GOTO(ret, cleanup);
     }
 
@@ -405,11 +430,12 @@ lyplg_type_compare_uint(const struct lyd_value *val1, const struct lyd_value *va
 }
 
 API const void *
-lyplg_type_print_uint(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *value, LY_VALUE_FORMAT format,
+lyplg_type_print_uint(const struct ly_ctx *ctx, const struct lyd_value *value, LY_VALUE_FORMAT format,
         void *UNUSED(prefix_data), ly_bool *dynamic, size_t *value_len)
 {
     uint64_t num = 0;
     void *buf;
+    char canon[LY_NUMBER_MAXLEN];
 
     if (format == LY_VALUE_LYB) {
         switch (value->realtype->basetype) {
@@ -450,6 +476,32 @@ lyplg_type_print_uint(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *
         }
     }
 
+    /* generate canonical value if not already */
+    if (!value->_canonical) {
+        switch (value->realtype->basetype) {
+        case LY_TYPE_UINT8:
+            sprintf(canon, "%" PRIu8, value->uint8);
+            break;
+        case LY_TYPE_UINT16:
+            sprintf(canon, "%" PRIu16, value->uint16);
+            break;
+        case LY_TYPE_UINT32:
+            sprintf(canon, "%" PRIu32, value->uint32);
+            break;
+        case LY_TYPE_UINT64:
+            sprintf(canon, "%" PRIu64, value->uint64);
+            break;
+        default:
+            return NULL;
+        }
+
+        /* store it */
+        if (lyplg_type_print_cache(ctx, canon, 0, value)) {
+            LOGMEM(ctx);
+            return NULL;
+        }
+    }
+
     /* use the cached canonical value */
     if (dynamic) {
         *dynamic = 0;
@@ -460,6 +512,40 @@ lyplg_type_print_uint(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *
     return value->_canonical;
 }
 
+API uint32_t
+lyplg_type_hash_int(const struct lyd_value *value, uint32_t hash)
+{
+    switch (value->realtype->basetype) {
+    case LY_TYPE_INT8:
+        return lyplg_type_hash_data(hash, &value->int8, sizeof value->int8);
+    case LY_TYPE_INT16:
+        return lyplg_type_hash_data(hash, &value->int16, sizeof value->int16);
+    case LY_TYPE_INT32:
+        return lyplg_type_hash_data(hash, &value->int32, sizeof value->int32);
+    case LY_TYPE_INT64:
+        return lyplg_type_hash_data(hash, &value->int64, sizeof value->int64);
+    default:
+        return hash;
+    }
+}
+
+API uint32_t
+lyplg_type_hash_uint(const struct lyd_value *value, uint32_t hash)
+{
+    switch (value->realtype->basetype) {
+    case LY_TYPE_UINT8:
+        return lyplg_type_hash_data(hash, &value->uint8, sizeof value->uint8);
+    case LY_TYPE_UINT16:
+        return lyplg_type_hash_data(hash, &value->uint16, sizeof value->uint16);
+    case LY_TYPE_UINT32:
+        return lyplg_type_hash_data(hash, &value->uint32, sizeof value->uint32);
+    case LY_TYPE_UINT64:
+        return lyplg_type_hash_data(hash, &value->uint64, sizeof value->uint64);
+    default:
+        return hash;
+    }
+}
+
 /**
  * @brief Plugin information for integer types implementation.
  *
@@ -481,6 +567,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_uint,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_uint,
         .plugin.lyb_data_len = 1,
     }, {
         .module = "",
@@ -495,6 +582,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_uint,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_uint,
         .plugin.lyb_data_len = 2,
     }, {
         .module = "",
@@ -509,6 +597,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_uint,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_uint,
         .plugin.lyb_data_len = 4,
     }, {
         .module = "",
@@ -523,6 +612,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_uint,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_uint,
         .plugin.lyb_data_len = 8,
     }, {
         .module = "",
@@ -537,6 +627,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_int,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_int,
         .plugin.lyb_data_len = 1,
     }, {
         .module = "",
@@ -551,6 +642,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_int,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_int,
         .plugin.lyb_data_len = 2,
     }, {
         .module = "",
@@ -565,6 +657,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_int,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_int,
         .plugin.lyb_data_len = 4,
     }, {
         .module = "",
@@ -579,6 +672,7 @@ const struct lyplg_type_record plugins_integer[] = {
         .plugin.print = lyplg_type_print_int,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_int,
         .plugin.lyb_data_len = 8,
     },
     {0}
@@ -173,7 +173,7 @@ lyplg_type_print_ipv4_address_no_zone(const struct ly_ctx *ctx, const struct lyd
         }
 
         /* store it */
-        if (lydict_insert_zc(ctx, ret, (const char **)&value->_canonical)) {
+        if (lyplg_type_print_cache(ctx, ret, 1, value)) {
             LOGMEM(ctx);
             return NULL;
         }
@@ -189,6 +189,18 @@ lyplg_type_print_ipv4_address_no_zone(const struct ly_ctx *ctx, const struct lyd
     return value->_canonical;
 }
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the ipv4-address-no-zone ietf-inet-types type.
+ */
+static uint32_t
+lyplg_type_hash_ipv4_address_no_zone(const struct lyd_value *value, uint32_t hash)
+{
+    struct lyd_value_ipv4_address_no_zone *val;
+
+    LYD_VALUE_GET(value, val);
+    return lyplg_type_hash_data(hash, &val->addr, sizeof val->addr);
+}
+
 /**
  * @brief Plugin information for ipv4-address-no-zone type implementation.
  *
@@ -210,6 +222,7 @@ const struct lyplg_type_record plugins_ipv4_address_no_zone[] = {
         .plugin.print = lyplg_type_print_ipv4_address_no_zone,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_ipv4_address_no_zone,
         .plugin.lyb_data_len = 4,
     },
     {0}
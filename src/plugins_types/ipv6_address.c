@@ -283,7 +283,7 @@ lyplg_type_print_ipv6_address(const struct ly_ctx *ctx, const struct lyd_value *
         }
 
         /* store it */
-        if (lydict_insert_zc(ctx, ret, (const char **)&value->_canonical)) {
+        if (lyplg_type_print_cache(ctx, ret, 1, value)) {
             LOGMEM(ctx);
             return NULL;
         }
@@ -346,6 +346,19 @@ lyplg_type_free_ipv6_address(const struct ly_ctx *ctx, struct lyd_value *value)
     }
 }
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the ipv6-address ietf-inet-types type.
+ */
+static uint32_t
+lyplg_type_hash_ipv6_address(const struct lyd_value *value, uint32_t hash)
+{
+    struct lyd_value_ipv6_address *val;
+
+    LYD_VALUE_GET(value, val);
+    hash = lyplg_type_hash_data(hash, &val->addr, sizeof val->addr);
+    return lyplg_type_hash_data(hash, val->zone, ly_strlen(val->zone));
+}
+
 /**
  * @brief Plugin information for ipv6-address type implementation.
  *
@@ -367,6 +380,7 @@ const struct lyplg_type_record plugins_ipv6_address[] = {
         .plugin.print = lyplg_type_print_ipv6_address,
         .plugin.duplicate = lyplg_type_dup_ipv6_address,
         .plugin.free = lyplg_type_free_ipv6_address,
+        .plugin.hash = lyplg_type_hash_ipv6_address,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -261,7 +261,7 @@ lyplg_type_print_ipv6_prefix(const struct ly_ctx *ctx, const struct lyd_value *v
         sprintf(ret + strlen(ret), "/%" PRIu8, val->prefix);
 
         /* store it */
-        if (lydict_insert_zc(ctx, ret, (const char **)&value->_canonical)) {
+        if (lyplg_type_print_cache(ctx, ret, 1, value)) {
             LOGMEM(ctx);
             return NULL;
         }
@@ -319,6 +319,19 @@ lyplg_type_free_ipv6_prefix(const struct ly_ctx *ctx, struct lyd_value *value)
     LYPLG_TYPE_VAL_INLINE_DESTROY(val);
 }
 
+/**
+ * @brief Implementation of ::lyplg_type_hash_clb for the ietf-inet-types ipv6-prefix type.
+ */
+static uint32_t
+lyplg_type_hash_ipv6_prefix(const struct lyd_value *value, uint32_t hash)
+{
+    struct lyd_value_ipv6_prefix *val;
+
+    LYD_VALUE_GET(value, val);
+    hash = lyplg_type_hash_data(hash, &val->addr, sizeof val->addr);
+    return lyplg_type_hash_data(hash, &val->prefix, sizeof val->prefix);
+}
+
 /**
  * @brief Plugin information for ipv6-prefix type implementation.
  *
@@ -340,6 +353,7 @@ const struct lyplg_type_record plugins_ipv6_prefix[] = {
         .plugin.print = lyplg_type_print_ipv6_prefix,
         .plugin.duplicate = lyplg_type_dup_ipv6_prefix,
         .plugin.free = lyplg_type_free_ipv6_prefix,
+        .plugin.hash = lyplg_type_hash_ipv6_prefix,
         .plugin.lyb_data_len = LYB_VALUE_LEN,
     },
     {0}
@@ -113,6 +113,12 @@ lyplg_type_free_leafref(const struct ly_ctx *ctx, struct lyd_value *value)
     value->realtype->plugin->free(ctx, value);
 }
 
+API uint32_t
+lyplg_type_hash_leafref(const struct lyd_value *value, uint32_t hash)
+{
+    return lyplg_type_hash_value(value, hash);
+}
+
 /**
  * @brief Plugin information for leafref type implementation.
  *
@@ -134,6 +140,7 @@ const struct lyplg_type_record plugins_leafref[] = {
         .plugin.print = lyplg_type_print_leafref,
         .plugin.duplicate = lyplg_type_dup_leafref,
         .plugin.free = lyplg_type_free_leafref,
+        .plugin.hash = lyplg_type_hash_leafref,
         .plugin.lyb_data_len = -1,
     },
     {0}
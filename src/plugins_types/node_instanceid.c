@@ -253,6 +253,7 @@ const struct lyplg_type_record plugins_node_instanceid[] = {
         .plugin.print = lyplg_type_print_instanceid,
         .plugin.duplicate = lyplg_type_dup_instanceid,
         .plugin.free = lyplg_type_free_instanceid,
+        .plugin.hash = lyplg_type_hash_simple,
         .plugin.lyb_data_len = -1,
     },
     {
@@ -268,6 +269,7 @@ const struct lyplg_type_record plugins_node_instanceid[] = {
         .plugin.print = lyplg_type_print_instanceid,
         .plugin.duplicate = lyplg_type_dup_instanceid,
         .plugin.free = lyplg_type_free_instanceid,
+        .plugin.hash = lyplg_type_hash_simple,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "libyang.h"
 
@@ -62,7 +63,10 @@ lyplg_type_store_string(const struct ly_ctx *ctx, const struct lysc_type *type,
     LY_CHECK_GOTO(ret, cleanup);
 
     /* store canonical value */
-    if (options & LYPLG_TYPE_STORE_DYNAMIC) {
+    if ((ctx->flags & LY_CTX_INLINE_STRINGS) && (value_len < LYD_VALUE_FIXED_MEM_SIZE)) {
+        /* short enough to be stored inline, zero-terminated thanks to the storage initialization */
+        memcpy(storage->fixed_mem, value, value_len);
+    } else if (options & LYPLG_TYPE_STORE_DYNAMIC) {
         ret = lydict_insert_zc(ctx, (char *)value, &storage->_canonical);
         options &= ~LYPLG_TYPE_STORE_DYNAMIC;
         LY_CHECK_GOTO(ret, cleanup);
@@ -82,6 +86,54 @@ cleanup:
     return ret;
 }
 
+API LY_ERR
+lyplg_type_compare_string(const struct lyd_value *val1, const struct lyd_value *val2)
+{
+    const char *str1, *str2;
+
+    if (val1->realtype != val2->realtype) {
+        return LY_ENOT;
+    }
+
+    if (val1->_canonical && val2->_canonical) {
+        /* both in the dictionary */
+        return (val1->_canonical == val2->_canonical) ? LY_SUCCESS : LY_ENOT;
+    }
+
+    /* at least one stored inline */
+    str1 = val1->_canonical ? val1->_canonical : (const char *)val1->fixed_mem;
+    str2 = val2->_canonical ? val2->_canonical : (const char *)val2->fixed_mem;
+    return strcmp(str1, str2) ? LY_ENOT : LY_SUCCESS;
+}
+
+API const void *
+lyplg_type_print_string(const struct ly_ctx *UNUSED(ctx), const struct lyd_value *value, LY_VALUE_FORMAT UNUSED(format),
+        void *UNUSED(prefix_data), ly_bool *dynamic, size_t *value_len)
+{
+    const char *str;
+
+    /* either in the dictionary or stored inline */
+    str = value->_canonical ? value->_canonical : (const char *)value->fixed_mem;
+
+    if (dynamic) {
+        *dynamic = 0;
+    }
+    if (value_len) {
+        *value_len = strlen(str);
+    }
+    return str;
+}
+
+API uint32_t
+lyplg_type_hash_string(const struct lyd_value *value, uint32_t hash)
+{
+    const char *str;
+
+    /* either in the dictionary or stored inline */
+    str = value->_canonical ? value->_canonical : (const char *)value->fixed_mem;
+    return lyplg_type_hash_data(hash, str, strlen(str));
+}
+
 /**
  * @brief Plugin information for string type implementation.
  *
@@ -98,11 +150,12 @@ const struct lyplg_type_record plugins_string[] = {
         .plugin.id = "libyang 2 - string, version 1",
         .plugin.store = lyplg_type_store_string,
         .plugin.validate = NULL,
-        .plugin.compare = lyplg_type_compare_simple,
+        .plugin.compare = lyplg_type_compare_string,
         .plugin.sort = NULL,
-        .plugin.print = lyplg_type_print_simple,
+        .plugin.print = lyplg_type_print_string,
         .plugin.duplicate = lyplg_type_dup_simple,
         .plugin.free = lyplg_type_free_simple,
+        .plugin.hash = lyplg_type_hash_string,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -17,6 +17,7 @@
 #include "plugins_types.h"
 
 #include <assert.h>
+#include <ctype.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -26,6 +27,7 @@
 /* additional internal headers for some useful simple macros */
 #include "common.h"
 #include "compat.h"
+#include "hash_table.h"
 #include "plugins_internal.h" /* LY_TYPE_*_STR */
 
 /**
@@ -199,6 +201,87 @@ union_store_type(const struct ly_ctx *ctx, struct lysc_type *type, struct lyd_va
     return ret;
 }
 
+/**
+ * @brief Cheaply check whether a union value can be stored as a specific built-in type at all.
+ *
+ * Calling a store callback that fails is expensive because of the error information it creates, so obviously
+ * invalid values are recognized beforehand. The check never fails for a value the type store callback would accept.
+ *
+ * @param[in] type Specific union type to check.
+ * @param[in] subvalue Union subvalue structure.
+ * @return Whether the value should be tried to be stored as @p type.
+ */
+static ly_bool
+union_type_may_match(const struct lysc_type *type, const struct lyd_value_union *subvalue)
+{
+    const struct lysc_type_enum *type_enum;
+    const char *value = subvalue->original;
+    size_t value_len = subvalue->orig_len;
+    LY_ARRAY_COUNT_TYPE u;
+
+    if (subvalue->format == LY_VALUE_LYB) {
+        /* binary value, its type is known */
+        return 1;
+    }
+
+    if (type->basetype == LY_TYPE_LEAFREF) {
+        type = ((struct lysc_type_leafref *)type)->realtype;
+    }
+
+    /* skip leading whitespaces, the same as the parsing functions do */
+    for ( ; value_len && isspace(*value); ++value, --value_len) {}
+
+    if ((type->plugin->store == lyplg_type_store_int) || (type->plugin->store == lyplg_type_store_uint)) {
+        if ((type->basetype == LY_TYPE_INT64) || (type->basetype == LY_TYPE_UINT64)) {
+            if (!(subvalue->hints & LYD_VALHINT_NUM64)) {
+                return 0;
+            }
+        } else if (!(subvalue->hints & (LYD_VALHINT_DECNUM | LYD_VALHINT_OCTNUM | LYD_VALHINT_HEXNUM))) {
+            return 0;
+        }
+        if (!value_len) {
+            return 0;
+        }
+        if (!(subvalue->hints & LYD_VALHINT_HEXNUM) && !isdigit(value[0]) && (value[0] != '-') && (value[0] != '+')) {
+            return 0;
+        }
+    } else if (type->plugin->store == lyplg_type_store_decimal64) {
+        if (!(subvalue->hints & LYD_VALHINT_STRING) || !value_len) {
+            return 0;
+        }
+        if (!isdigit(value[0]) && (value[0] != '-') && (value[0] != '+')) {
+            return 0;
+        }
+    } else if (type->plugin->store == lyplg_type_store_boolean) {
+        if (!(subvalue->hints & LYD_VALHINT_BOOLEAN)) {
+            return 0;
+        }
+        if (ly_strncmp("true", subvalue->original, subvalue->orig_len) &&
+                ly_strncmp("false", subvalue->original, subvalue->orig_len)) {
+            return 0;
+        }
+    } else if (type->plugin->store == lyplg_type_store_enum) {
+        if (!(subvalue->hints & LYD_VALHINT_STRING)) {
+            return 0;
+        }
+        type_enum = (const struct lysc_type_enum *)type;
+        LY_ARRAY_FOR(type_enum->enums, u) {
+            if (!ly_strncmp(type_enum->enums[u].name, subvalue->original, subvalue->orig_len)) {
+                break;
+            }
+        }
+        if (u == LY_ARRAY_COUNT(type_enum->enums)) {
+            return 0;
+        }
+    } else if (type->plugin->store == lyplg_type_store_empty) {
+        if (!(subvalue->hints & LYD_VALHINT_EMPTY) || subvalue->orig_len) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 /**
  * @brief Find the first valid type for a union value.
  *
@@ -233,6 +316,11 @@ union_find_type(const struct ly_ctx *ctx, struct lysc_type **types, struct lyd_v
 
     /* use the first usable subtype to store the value */
     for (u = 0; u < LY_ARRAY_COUNT(types); ++u) {
+        if (!union_type_may_match(types[u], subvalue)) {
+            /* this type cannot be used, do not waste time trying to store the value */
+            continue;
+        }
+
         ret = union_store_type(ctx, types[u], subvalue, resolve, ctx_node, tree, unres, err);
         if ((ret == LY_SUCCESS) || (ret == LY_EINCOMPLETE)) {
             break;
@@ -313,6 +401,217 @@ lyb_fill_subvalue(const struct ly_ctx *ctx, struct lysc_type_union *type_u, cons
     return ret;
 }
 
+/**
+ * @brief Record of a union value shared by several data nodes, see ::LY_CTX_INTERN_VALUES.
+ */
+struct union_pool_rec {
+    struct lyd_value_union *val;    /**< shared union value */
+    uint32_t refcount;              /**< number of data values using it */
+};
+
+/**
+ * @brief Free a union value.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] val Union value to free.
+ */
+static void
+union_value_free(const struct ly_ctx *ctx, struct lyd_value_union *val)
+{
+    if (val->value.realtype) {
+        val->value.realtype->plugin->free(ctx, &val->value);
+    }
+    lyplg_type_prefix_data_free(val->format, val->prefix_data);
+    free(val->original);
+
+    LYPLG_TYPE_VAL_INLINE_DESTROY(val);
+}
+
+/**
+ * @brief Hash table equal callback for the shared union values.
+ *
+ * Values are equal if they were stored from the same original value for the same node
+ * and the selected subtype considers them equal.
+ */
+static ly_bool
+union_pool_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_value_union *val1, *val2;
+
+    val1 = ((struct union_pool_rec *)val1_p)->val;
+    val2 = ((struct union_pool_rec *)val2_p)->val;
+
+    if (val1 == val2) {
+        return 1;
+    }
+
+    if ((val1->ctx_node != val2->ctx_node) || (val1->format != val2->format) || (val1->orig_len != val2->orig_len) ||
+            memcmp(val1->original, val2->original, val1->orig_len)) {
+        return 0;
+    }
+    if (val1->value.realtype != val2->value.realtype) {
+        return 0;
+    }
+    return val1->value.realtype->plugin->compare(&val1->value, &val2->value) ? 0 : 1;
+}
+
+/**
+ * @brief Check whether a union value can be shared.
+ *
+ * Only values that are never resolved again (their subtype has no validation callback) can be shared.
+ *
+ * @param[in] val Union value.
+ * @return Whether the value can be shared.
+ */
+static ly_bool
+union_pool_sharable(const struct lyd_value_union *val)
+{
+    return val->value.realtype && !val->value.realtype->plugin->validate;
+}
+
+/**
+ * @brief Find the shared record of a union value, the pool must be locked.
+ *
+ * @param[in] ctx libyang context with the pool.
+ * @param[in] val Union value to find.
+ * @param[out] hash Optional hash of @p val.
+ * @return Shared record of @p val itself, NULL if it is not shared.
+ */
+static struct union_pool_rec *
+union_pool_find(const struct ly_ctx *ctx, struct lyd_value_union *val, uint32_t *hash)
+{
+    struct union_pool_rec rec, *match;
+    uint32_t h;
+
+    h = lyplg_type_hash_data(0, &val->ctx_node, sizeof val->ctx_node);
+    h = lyplg_type_hash_value(&val->value, h);
+    h = lyplg_type_hash_data(h, NULL, 0);
+    if (hash) {
+        *hash = h;
+    }
+
+    rec.val = val;
+    if (!ctx->val_pool || lyht_find(ctx->val_pool, &rec, h, (void **)&match) || (match->val != val)) {
+        return NULL;
+    }
+    return match;
+}
+
+/**
+ * @brief Share a newly stored union value with the other equal values in the context pool.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in,out] storage Stored union value, its union value may be replaced by the shared one.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+union_pool_share(const struct ly_ctx *ctx, struct lyd_value *storage)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct ly_ctx *pool_ctx = (struct ly_ctx *)ctx;
+    struct lyd_value_union *val = storage->subvalue;
+    struct union_pool_rec rec, *match;
+    uint32_t hash;
+
+    if (!union_pool_sharable(val)) {
+        return LY_SUCCESS;
+    }
+
+    /* generate the canonical value now, a shared value must never change */
+    if (!val->value._canonical && !val->value.realtype->plugin->print(ctx, &val->value, LY_VALUE_CANON, NULL, NULL, NULL)) {
+        return LY_EINT;
+    }
+
+    pthread_mutex_lock(&pool_ctx->val_pool_lock);
+
+    if (!pool_ctx->val_pool) {
+        pool_ctx->val_pool = lyht_new(LYHT_MIN_SIZE, sizeof rec, union_pool_equal_cb, NULL, 1);
+        LY_CHECK_ERR_GOTO(!pool_ctx->val_pool, LOGMEM(ctx); ret = LY_EMEM, cleanup);
+    }
+
+    /* get the hash, the new value cannot be found */
+    union_pool_find(ctx, val, &hash);
+
+    rec.val = val;
+    rec.refcount = 1;
+    ret = lyht_insert(pool_ctx->val_pool, &rec, hash, (void **)&match);
+    if (ret == LY_EEXIST) {
+        /* use the shared value */
+        ++match->refcount;
+        union_value_free(ctx, val);
+        storage->subvalue = match->val;
+        ret = LY_SUCCESS;
+    }
+
+cleanup:
+    pthread_mutex_unlock(&pool_ctx->val_pool_lock);
+    return ret;
+}
+
+/**
+ * @brief Add a reference to a union value, if shared.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] val Union value.
+ * @return Whether @p val is shared and was referenced.
+ */
+static ly_bool
+union_pool_ref(const struct ly_ctx *ctx, struct lyd_value_union *val)
+{
+    struct ly_ctx *pool_ctx = (struct ly_ctx *)ctx;
+    struct union_pool_rec *match;
+
+    if (!ctx->val_pool || !union_pool_sharable(val)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool_ctx->val_pool_lock);
+    match = union_pool_find(ctx, val, NULL);
+    if (match) {
+        ++match->refcount;
+    }
+    pthread_mutex_unlock(&pool_ctx->val_pool_lock);
+
+    return match ? 1 : 0;
+}
+
+/**
+ * @brief Remove a reference to a union value, if shared. The last reference frees it.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in] val Union value.
+ * @return Whether @p val is shared and was unreferenced.
+ */
+static ly_bool
+union_pool_unref(const struct ly_ctx *ctx, struct lyd_value_union *val)
+{
+    struct ly_ctx *pool_ctx = (struct ly_ctx *)ctx;
+    struct union_pool_rec rec, *match;
+    uint32_t hash;
+    ly_bool shared = 0, last = 0;
+
+    if (!ctx || !ctx->val_pool || !union_pool_sharable(val)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool_ctx->val_pool_lock);
+    match = union_pool_find(ctx, val, &hash);
+    if (match) {
+        shared = 1;
+        if (!--match->refcount) {
+            rec = *match;
+            lyht_remove(pool_ctx->val_pool, &rec, hash);
+            last = 1;
+        }
+    }
+    pthread_mutex_unlock(&pool_ctx->val_pool_lock);
+
+    if (last) {
+        union_value_free(ctx, val);
+    }
+    return shared;
+}
+
 API LY_ERR
 lyplg_type_store_union(const struct ly_ctx *ctx, const struct lysc_type *type, const void *value, size_t value_len,
         uint32_t options, LY_VALUE_FORMAT format, void *prefix_data, uint32_t hints, const struct lysc_node *ctx_node,
@@ -352,6 +651,13 @@ lyplg_type_store_union(const struct ly_ctx *ctx, const struct lysc_type *type, c
         LY_CHECK_GOTO((ret != LY_SUCCESS) && (ret != LY_EINCOMPLETE), cleanup);
     }
 
+    if (!ret && (ctx->flags & LY_CTX_INTERN_VALUES)) {
+        /* share the value with the other equal values */
+        ret = union_pool_share(ctx, storage);
+        LY_CHECK_GOTO(ret, cleanup);
+        subvalue = storage->subvalue;
+    }
+
     /* store canonical value, if any (use the specific type value) */
     ret = lydict_insert(ctx, subvalue->value._canonical, 0, &storage->_canonical);
     LY_CHECK_GOTO(ret, cleanup);
@@ -519,7 +825,7 @@ lyplg_type_print_union(const struct ly_ctx *ctx, const struct lyd_value *value,
     ret = (void *)subvalue->value.realtype->plugin->print(ctx, &subvalue->value, format, prefix_data, dynamic, value_len);
     if (!value->_canonical && (format == LY_VALUE_CANON)) {
         /* the canonical value is supposed to be stored now */
-        lydict_insert(ctx, subvalue->value._canonical, 0, (const char **)&value->_canonical);
+        lyplg_type_print_cache(ctx, subvalue->value._canonical, 0, value);
     }
 
     return ret;
@@ -538,6 +844,12 @@ lyplg_type_dup_union(const struct ly_ctx *ctx, const struct lyd_value *original,
     ret = lydict_insert(ctx, original->_canonical, 0, &dup->_canonical);
     LY_CHECK_GOTO(ret, cleanup);
 
+    if (union_pool_ref(ctx, orig_val)) {
+        /* shared value */
+        dup->subvalue = orig_val;
+        return LY_SUCCESS;
+    }
+
     dup_val = calloc(1, sizeof *dup_val);
     LY_CHECK_ERR_GOTO(!dup_val, LOGMEM(ctx); ret = LY_EMEM, cleanup);
     dup->subvalue = dup_val;
@@ -576,17 +888,18 @@ lyplg_type_free_union(const struct ly_ctx *ctx, struct lyd_value *value)
     lydict_remove(ctx, value->_canonical);
     value->_canonical = NULL;
     LYD_VALUE_GET(value, val);
-    if (val) {
-        if (val->value.realtype) {
-            val->value.realtype->plugin->free(ctx, &val->value);
-        }
-        lyplg_type_prefix_data_free(val->format, val->prefix_data);
-        free(val->original);
-
-        LYPLG_TYPE_VAL_INLINE_DESTROY(val);
+    if (val && !union_pool_unref(ctx, val)) {
+        union_value_free(ctx, val);
     }
 }
 
+API uint32_t
+lyplg_type_hash_union(const struct lyd_value *value, uint32_t hash)
+{
+    /* equal unions have the same value type, enough to hash the value */
+    return lyplg_type_hash_value(&value->subvalue->value, hash);
+}
+
 /**
  * @brief Plugin information for union type implementation.
  *
@@ -608,6 +921,7 @@ const struct lyplg_type_record plugins_union[] = {
         .plugin.print = lyplg_type_print_union,
         .plugin.duplicate = lyplg_type_dup_union,
         .plugin.free = lyplg_type_free_union,
+        .plugin.hash = lyplg_type_hash_union,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -443,6 +443,7 @@ const struct lyplg_type_record plugins_xpath10[] = {
         .plugin.print = lyplg_type_print_xpath10,
         .plugin.duplicate = lyplg_type_dup_xpath10,
         .plugin.free = lyplg_type_free_xpath10,
+        .plugin.hash = lyplg_type_hash_simple,
         .plugin.lyb_data_len = -1,
     },
     {0}
@@ -827,6 +827,106 @@ lys_compile_expr_implement(const struct ly_ctx *ctx, const struct lyxp_expr *exp
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Learn the evaluation order of all the when conditions of a node and of the ones they depend on.
+ *
+ * A when condition is ordered after all the when conditions of the nodes referenced in it and after the
+ * when conditions of the data parents of its node so that all can be evaluated in a single pass.
+ *
+ * @param[in] node Node to learn for, with its choice and case parents.
+ * @return Greatest evaluation order of the when conditions of @p node and its ancestors, 0 if there are none.
+ */
+static uint32_t
+lys_compile_when_order(const struct lysc_node *node)
+{
+    const struct lysc_node *iter;
+    struct lysc_when **whens;
+    struct lyxp_expr *cond;
+    LY_ARRAY_COUNT_TYPE u, v;
+    uint32_t order = 0, dep_order, dep;
+
+    if (!node) {
+        return 0;
+    }
+
+    iter = node;
+    do {
+        whens = lysc_node_when(iter);
+        LY_ARRAY_FOR(whens, u) {
+            cond = whens[u]->cond;
+            if (!cond->when_order) {
+                /* prevents infinite recursion should there be a cyclic dependency */
+                cond->when_order = 1;
+
+                /* data parents are always evaluated first */
+                dep_order = lys_compile_when_order(lysc_data_parent(node));
+
+                /* referenced nodes */
+                LY_ARRAY_FOR(cond->atoms, v) {
+                    if (cond->atoms[v].scnode != node) {
+                        dep = lys_compile_when_order(cond->atoms[v].scnode);
+                        if (dep > dep_order) {
+                            dep_order = dep;
+                        }
+                    }
+                }
+
+                cond->when_order = dep_order + 1;
+            }
+            if (cond->when_order > order) {
+                order = cond->when_order;
+            }
+        }
+
+        iter = iter->parent;
+    } while (iter && (iter->nodetype & (LYS_CASE | LYS_CHOICE)));
+
+    if (!order) {
+        /* no when, only the parents */
+        order = lys_compile_when_order(lysc_data_parent(node));
+    }
+
+    return order;
+}
+
+/**
+ * @brief Remember the schema nodes a when or must expression depends on, for incremental validation.
+ *
+ * @param[in] ctx Compile context.
+ * @param[in] exp Expression to store the atoms in.
+ * @param[in] ctx_scnode Context node @p exp was atomized with, NULL for the root.
+ * @param[in] set Set returned by ::lyxp_atomize() for @p exp.
+ * @param[in] unres Global unres structure.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lys_compile_unres_expr_atoms(struct lysc_ctx *ctx, struct lyxp_expr *exp, const struct lysc_node *ctx_scnode,
+        const struct lyxp_set *set, const struct lys_glob_unres *unres)
+{
+    const struct lysc_node *iter;
+    LY_ARRAY_COUNT_TYPE u;
+
+    LY_CHECK_RET(lyxp_expr_set_atoms(ctx->ctx, exp, ctx_scnode, set));
+
+    if (!unres->ds_unres.disabled.count) {
+        return LY_SUCCESS;
+    }
+
+    LY_ARRAY_FOR(exp->atoms, u) {
+        for (iter = exp->atoms[u].scnode; iter; iter = iter->parent) {
+            if (ly_set_contains(&unres->ds_unres.disabled, (void *)iter, NULL)) {
+                /* disabled nodes are freed, consider the dependencies unknown */
+                LY_ARRAY_FREE(exp->atoms);
+                exp->atoms = NULL;
+                exp->atomized = 0;
+                return LY_SUCCESS;
+            }
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
 /**
  * @brief Check when expressions of a node on a complete compiled schema tree.
  *
@@ -873,6 +973,10 @@ lys_compile_unres_when(struct lysc_ctx *ctx, const struct lysc_node *node, struc
             goto cleanup;
         }
 
+        /* remember the dependencies for incremental validation */
+        ret = lys_compile_unres_expr_atoms(ctx, whens[u]->cond, whens[u]->context, &tmp_set, unres);
+        LY_CHECK_GOTO(ret, cleanup);
+
         ctx->path[0] = '\0';
         lysc_path(node, LYSC_PATH_LOG, ctx->path, LYSC_CTX_BUFSIZE);
         for (i = 0; i < tmp_set.used; ++i) {
@@ -961,6 +1065,10 @@ lys_compile_unres_must(struct lysc_ctx *ctx, const struct lysc_node *node, const
             goto cleanup;
         }
 
+        /* remember the dependencies for incremental validation */
+        ret = lys_compile_unres_expr_atoms(ctx, musts[u].cond, node, &tmp_set, unres);
+        LY_CHECK_GOTO(ret, cleanup);
+
         ctx->path[0] = '\0';
         lysc_path(node, LYSC_PATH_LOG, ctx->path, LYSC_CTX_BUFSIZE);
         for (i = 0; i < tmp_set.used; ++i) {
@@ -1425,9 +1533,16 @@ resolve_all:
         LOG_LOCBACK(1, 0, 0, 0);
         LY_CHECK_RET(ret);
 
+        LY_CHECK_RET(ly_set_add(&ds_unres->whens_done, node, 1, NULL));
         ly_set_rm_index(&ds_unres->whens, i, NULL);
     }
 
+    /* learn the evaluation order of when, all their dependencies are known now */
+    for (i = 0; i < ds_unres->whens_done.count; ++i) {
+        lys_compile_when_order(ds_unres->whens_done.objs[i]);
+    }
+    ly_set_erase(&ds_unres->whens_done, NULL);
+
     /* check must */
     while (ds_unres->musts.count) {
         i = ds_unres->musts.count - 1;
@@ -1536,6 +1651,7 @@ lys_compile_unres_depset_erase(const struct ly_ctx *ctx, struct lys_glob_unres *
     uint32_t i;
 
     ly_set_erase(&unres->ds_unres.whens, NULL);
+    ly_set_erase(&unres->ds_unres.whens_done, NULL);
     for (i = 0; i < unres->ds_unres.musts.count; ++i) {
         lysc_unres_must_free(unres->ds_unres.musts.objs[i]);
     }
@@ -1550,6 +1666,116 @@ lys_compile_unres_depset_erase(const struct ly_ctx *ctx, struct lys_glob_unres *
     ly_set_erase(&unres->ds_unres.disabled_bitenums, NULL);
 }
 
+/**
+ * @brief Check whether a module imports (in the module or any of its submodules) a module from a set.
+ *
+ * @param[in] mod Module to examine.
+ * @param[in] mod_set Set of modules to look for.
+ * @return Whether any of the modules is imported or not.
+ */
+static ly_bool
+lys_compile_depset_imports_any(const struct lys_module *mod, const struct ly_set *mod_set)
+{
+    const struct lysp_import *imports;
+    LY_ARRAY_COUNT_TYPE u, v;
+
+    imports = mod->parsed->imports;
+    LY_ARRAY_FOR(imports, u) {
+        if (ly_set_contains(mod_set, imports[u].module, NULL)) {
+            return 1;
+        }
+    }
+    LY_ARRAY_FOR(mod->parsed->includes, v) {
+        imports = mod->parsed->includes[v].submodule->imports;
+        LY_ARRAY_FOR(imports, u) {
+            if (ly_set_contains(mod_set, imports[u].module, NULL)) {
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Check whether a module is augmented or deviated by a module from a set.
+ *
+ * @param[in] mod Module to examine.
+ * @param[in] mod_set Set of modules to look for.
+ * @return Whether any of the modules augments/deviates @p mod or not.
+ */
+static ly_bool
+lys_compile_depset_amended_by_any(const struct lys_module *mod, const struct ly_set *mod_set)
+{
+    LY_ARRAY_COUNT_TYPE u;
+
+    LY_ARRAY_FOR(mod->augmented_by, u) {
+        if (ly_set_contains(mod_set, mod->augmented_by[u], NULL)) {
+            return 1;
+        }
+    }
+    LY_ARRAY_FOR(mod->deviated_by, u) {
+        if (ly_set_contains(mod_set, mod->deviated_by[u], NULL)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Mark all the modules in a dependency set affected by the modules to be (re)compiled.
+ *
+ * Instead of recompiling the whole dep set, only the modules that may reference compiled nodes of a (re)compiled
+ * module are (re)compiled as well. That is any module importing (even transitively, through not-implemented modules,
+ * which may define groupings or typedefs) a (re)compiled module, because of leafref targets, if-features and
+ * disabled nodes, and any module augmented or deviated by a (re)compiled module, because the amends are applied
+ * when compiling the target module.
+ *
+ * @param[in] dep_set Dependency set to update.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lys_compile_depset_mark_affected(struct ly_set *dep_set)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lys_module *mod;
+    struct ly_set affected = {0};
+    uint32_t i;
+    ly_bool found;
+
+    /* start with the changed modules */
+    for (i = 0; i < dep_set->count; ++i) {
+        mod = dep_set->objs[i];
+        if (mod->to_compile) {
+            LY_CHECK_GOTO(ret = ly_set_add(&affected, mod, 1, NULL), cleanup);
+        }
+    }
+
+    /* find the closure of all the affected modules */
+    do {
+        found = 0;
+        for (i = 0; i < dep_set->count; ++i) {
+            mod = dep_set->objs[i];
+            if (ly_set_contains(&affected, mod, NULL)) {
+                continue;
+            }
+
+            if (lys_compile_depset_imports_any(mod, &affected) || lys_compile_depset_amended_by_any(mod, &affected)) {
+                LY_CHECK_GOTO(ret = ly_set_add(&affected, mod, 1, NULL), cleanup);
+                if (mod->implemented) {
+                    mod->to_compile = 1;
+                }
+                found = 1;
+            }
+        }
+    } while (found);
+
+cleanup:
+    ly_set_erase(&affected, NULL);
+    return ret;
+}
+
 /**
  * @brief Compile all flagged modules in a dependency set, recursively if recompilation is needed.
  *
@@ -1565,6 +1791,9 @@ lys_compile_depset_r(struct ly_ctx *ctx, struct ly_set *dep_set, struct lys_glob
     struct lys_module *mod;
     uint32_t i;
 
+    /* learn which other modules need to be (re)compiled because of the changed ones */
+    LY_CHECK_RET(lys_compile_depset_mark_affected(dep_set));
+
     for (i = 0; i < dep_set->count; ++i) {
         mod = dep_set->objs[i];
         if (!mod->to_compile) {
@@ -1573,6 +1802,8 @@ lys_compile_depset_r(struct ly_ctx *ctx, struct ly_set *dep_set, struct lys_glob
         }
         assert(mod->implemented);
 
+        LOGDBG(LY_LDGDEPSETS, "%s module \"%s\".", mod->compiled ? "recompiling" : "compiling", mod->name);
+
         /* free the compiled module, if any */
         lysc_module_free(mod->compiled);
         mod->compiled = NULL;
@@ -1705,6 +1936,58 @@ lys_compile_unres_mod_erase(struct lysc_ctx *ctx, ly_bool error)
     }
 }
 
+/**
+ * @brief Compile all the non-instantiated groupings of a module and its submodules to validate them.
+ *
+ * @param[in] ctx Compile context of the module.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lys_compile_unused_groupings(struct lysc_ctx *ctx)
+{
+    struct lysp_module *sp = ctx->cur_mod->parsed;
+    struct lysp_submodule *submod;
+    struct lysp_node *pnode;
+    struct lysp_node_grp *grp;
+    LY_ARRAY_COUNT_TYPE u;
+    LY_ERR ret = LY_SUCCESS;
+
+    ctx->compile_opts |= LYS_COMPILE_GROUPING;
+    LY_LIST_FOR(sp->groupings, grp) {
+        if (!(grp->flags & LYS_USED_GRP)) {
+            LY_CHECK_GOTO(ret = lys_compile_grouping(ctx, NULL, grp), cleanup);
+        }
+    }
+    LY_LIST_FOR(sp->data, pnode) {
+        LY_LIST_FOR((struct lysp_node_grp *)lysp_node_groupings(pnode), grp) {
+            if (!(grp->flags & LYS_USED_GRP)) {
+                LY_CHECK_GOTO(ret = lys_compile_grouping(ctx, pnode, grp), cleanup);
+            }
+        }
+    }
+    LY_ARRAY_FOR(sp->includes, u) {
+        submod = sp->includes[u].submodule;
+        ctx->pmod = (struct lysp_module *)submod;
+
+        LY_LIST_FOR(submod->groupings, grp) {
+            if (!(grp->flags & LYS_USED_GRP)) {
+                LY_CHECK_GOTO(ret = lys_compile_grouping(ctx, NULL, grp), cleanup);
+            }
+        }
+        LY_LIST_FOR(submod->data, pnode) {
+            LY_LIST_FOR((struct lysp_node_grp *)lysp_node_groupings(pnode), grp) {
+                if (!(grp->flags & LYS_USED_GRP)) {
+                    LY_CHECK_GOTO(ret = lys_compile_grouping(ctx, pnode, grp), cleanup);
+                }
+            }
+        }
+    }
+
+cleanup:
+    ctx->pmod = sp;
+    return ret;
+}
+
 LY_ERR
 lys_compile(struct lys_module *mod, struct lys_depset_unres *unres)
 {
@@ -1713,7 +1996,6 @@ lys_compile(struct lys_module *mod, struct lys_depset_unres *unres)
     struct lysp_module *sp;
     struct lysp_submodule *submod;
     struct lysp_node *pnode;
-    struct lysp_node_grp *grp;
     LY_ARRAY_COUNT_TYPE u;
     LY_ERR ret = LY_SUCCESS;
 
@@ -1781,39 +2063,11 @@ lys_compile(struct lys_module *mod, struct lys_depset_unres *unres)
     }
     ctx.pmod = sp;
 
-    /* validate non-instantiated groupings from the parsed schema,
-     * without it we would accept even the schemas with invalid grouping specification */
-    ctx.compile_opts |= LYS_COMPILE_GROUPING;
-    LY_LIST_FOR(sp->groupings, grp) {
-        if (!(grp->flags & LYS_USED_GRP)) {
-            LY_CHECK_GOTO(ret = lys_compile_grouping(&ctx, NULL, grp), cleanup);
-        }
-    }
-    LY_LIST_FOR(sp->data, pnode) {
-        LY_LIST_FOR((struct lysp_node_grp *)lysp_node_groupings(pnode), grp) {
-            if (!(grp->flags & LYS_USED_GRP)) {
-                LY_CHECK_GOTO(ret = lys_compile_grouping(&ctx, pnode, grp), cleanup);
-            }
-        }
-    }
-    LY_ARRAY_FOR(sp->includes, u) {
-        submod = sp->includes[u].submodule;
-        ctx.pmod = (struct lysp_module *)submod;
-
-        LY_LIST_FOR(submod->groupings, grp) {
-            if (!(grp->flags & LYS_USED_GRP)) {
-                LY_CHECK_GOTO(ret = lys_compile_grouping(&ctx, NULL, grp), cleanup);
-            }
-        }
-        LY_LIST_FOR(submod->data, pnode) {
-            LY_LIST_FOR((struct lysp_node_grp *)lysp_node_groupings(pnode), grp) {
-                if (!(grp->flags & LYS_USED_GRP)) {
-                    LY_CHECK_GOTO(ret = lys_compile_grouping(&ctx, pnode, grp), cleanup);
-                }
-            }
-        }
+    if (!(ctx.ctx->flags & LY_CTX_SKIP_UNUSED_GROUPINGS)) {
+        /* validate non-instantiated groupings from the parsed schema,
+         * without it we would accept even the schemas with invalid grouping specification */
+        LY_CHECK_GOTO(ret = lys_compile_unused_groupings(&ctx), cleanup);
     }
-    ctx.pmod = sp;
 
     LOG_LOCBACK(0, 0, 1, 0);
 
@@ -62,6 +62,7 @@ struct lysc_ctx {
  */
 struct lys_depset_unres {
     struct ly_set whens;                /**< nodes with when to check */
+    struct ly_set whens_done;           /**< nodes with checked when to learn the evaluation order of */
     struct ly_set musts;                /**< set of musts to check */
     struct ly_set leafrefs;             /**< to validate target of leafrefs */
     struct ly_set dflts;                /**< set of incomplete default values */
@@ -275,7 +276,8 @@ LY_ERR lys_compile_expr_implement(const struct ly_ctx *ctx, const struct lyxp_ex
  * 2) implement it (perform one-time compilation tasks - compile identities and add reference to augment/deviation
  *    target modules, implement those as well, ::_lys_set_implemented())
  * 3) create dep set of the module (::lys_unres_dep_sets_create())
- * 4) (re)compile all the modules in the dep set and collect unres (::lys_compile_dep_set_r())
+ * 4) mark all the modules in the dep set affected by the changed modules (modules importing them or amended by them),
+ *    (re)compile them and collect unres (::lys_compile_dep_set_r())
  * 5) resolve unres (lys_compile_unres_depset() - static), new modules may be implemented like in 2) and if
  *    require recompilation, free all compiled modules and do 4)
  * 6) all modules that needed to be (re)compiled are now, with all their dependencies
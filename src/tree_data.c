@@ -1567,6 +1567,9 @@ _lyd_change_term(struct lyd_node *term, const void *value, size_t value_len, LY_
             lyd_hash(lyd_parent(term));
             LY_CHECK_GOTO(ret = lyd_insert_hash(lyd_parent(term)), cleanup);
         } /* else leaf that is not a key, its value is not used for its hash so it does not change */
+
+        /* update unique index */
+        lyd_val_uniq_idx_change(term, 0);
     }
 
     /* retrun value */
@@ -2236,7 +2239,7 @@ lyd_new_implicit_tree(struct lyd_node *tree, uint32_t implicit_options, struct l
     }
 
     /* resolve when and remove any invalid defaults */
-    LY_CHECK_GOTO(ret = lyd_validate_unres(&tree, NULL, &node_when, &node_exts, NULL, NULL, diff), cleanup);
+    LY_CHECK_GOTO(ret = lyd_validate_unres(&tree, NULL, 0, &node_when, &node_exts, NULL, NULL, diff), cleanup);
 
 cleanup:
     ly_set_erase(&node_when, NULL);
@@ -2303,7 +2306,7 @@ lyd_new_implicit_module(struct lyd_node **tree, const struct lys_module *module,
     LY_CHECK_GOTO(ret = lyd_new_implicit_r(NULL, tree, NULL, module, &node_when, &node_exts, NULL, implicit_options, diff), cleanup);
 
     /* resolve when and remove any invalid defaults */
-    LY_CHECK_GOTO(ret = lyd_validate_unres(tree, module, &node_when, &node_exts, NULL, NULL, diff), cleanup);
+    LY_CHECK_GOTO(ret = lyd_validate_unres(tree, module, 0, &node_when, &node_exts, NULL, NULL, diff), cleanup);
 
     /* process nested nodes */
     LY_LIST_FOR(*tree, root) {
@@ -2600,6 +2603,9 @@ lyd_insert_node(struct lyd_node *parent, struct lyd_node **first_sibling_p, stru
         /* now we can insert even the list into its parent HT */
         lyd_insert_hash(parent);
     }
+
+    /* update unique index */
+    lyd_val_uniq_idx_change(node, 0);
 }
 
 /**
@@ -2735,6 +2741,7 @@ lyd_insert_before(struct lyd_node *sibling, struct lyd_node *node)
     lyd_unlink_tree(node);
     lyd_insert_before_node(sibling, node);
     lyd_insert_hash(node);
+    lyd_val_uniq_idx_change(node, 0);
 
     return LY_SUCCESS;
 }
@@ -2754,6 +2761,7 @@ lyd_insert_after(struct lyd_node *sibling, struct lyd_node *node)
     lyd_unlink_tree(node);
     lyd_insert_after_node(sibling, node);
     lyd_insert_hash(node);
+    lyd_val_uniq_idx_change(node, 0);
 
     return LY_SUCCESS;
 }
@@ -2778,8 +2786,9 @@ lyd_unlink_tree(struct lyd_node *node)
         return;
     }
 
-    /* update hashes while still linked into the tree */
+    /* update hashes and unique index while still linked into the tree */
     lyd_unlink_hash(node);
+    lyd_val_uniq_idx_change(node, 1);
 
     /* unlink from siblings */
     if (node->prev->next) {
@@ -3742,6 +3751,7 @@ lyd_merge_sibling_r(struct lyd_node **first_trg, struct lyd_node *parent_trg, co
                 type->plugin->free(LYD_CTX(match_trg), &((struct lyd_node_term *)match_trg)->value);
                 LY_CHECK_RET(type->plugin->duplicate(LYD_CTX(match_trg), &((struct lyd_node_term *)sibling_src)->value,
                         &((struct lyd_node_term *)match_trg)->value));
+                lyd_val_uniq_idx_change(match_trg, 0);
 
                 /* copy flags and add LYD_NEW */
                 match_trg->flags = sibling_src->flags | ((options & LYD_MERGE_WITH_FLAGS) ? 0 : LYD_NEW);
@@ -4479,8 +4489,9 @@ lyd_eval_xpath2(const struct lyd_node *ctx_node, const char *xpath, const struct
     ret = lyxp_expr_parse((struct ly_ctx *)LYD_CTX(ctx_node), xpath, 0, 1, &exp);
     LY_CHECK_GOTO(ret, cleanup);
 
-    /* evaluate expression */
-    ret = lyxp_eval(LYD_CTX(ctx_node), exp, NULL, LY_VALUE_JSON, NULL, ctx_node, ctx_node, vars, &xp_set, LYXP_IGNORE_WHEN);
+    /* evaluate expression, only its boolean value is needed */
+    ret = lyxp_eval(LYD_CTX(ctx_node), exp, NULL, LY_VALUE_JSON, NULL, ctx_node, ctx_node, vars, &xp_set,
+            LYXP_IGNORE_WHEN | LYXP_EXISTS);
     LY_CHECK_GOTO(ret, cleanup);
 
     /* transform into boolean */
@@ -40,6 +40,7 @@ struct ly_set;
 struct lyd_node;
 struct lyd_node_opaq;
 struct lyd_node_term;
+struct lyd_uniq_idx;
 struct timespec;
 struct lyxp_var;
 
@@ -606,9 +607,8 @@ struct lyd_value_union {
 struct lyd_value_bits {
     char *bitmap;                           /**< bitmap of size ::lyplg_type_bits_bitmap_size(), if its value is
                                                 cast to an integer type of the corresponding size, can be used
-                                                directly as a bitmap */
-    struct lysc_type_bitenum_item **items;  /**< list of set pointers to the specification of the set
-                                                bits ([sized array](@ref sizedarrays)) */
+                                                directly as a bitmap, use ::lyplg_type_bits_is_bit_set() to check
+                                                the bits of the type (::lysc_type_bits.bits) */
 };
 
 /**
@@ -770,7 +770,10 @@ struct lyd_node {
                                           itself. In case of the first node, this pointer points to the last
                                           node in the list. */
     struct lyd_meta *meta;           /**< pointer to the list of metadata of this node */
-    void *priv;                      /**< private user data, not used by libyang */
+#ifdef LYD_NODE_PRIV
+    void *priv;                      /**< private user data, not used by libyang, available only if libyang is
+                                          built with ENABLE_DATA_NODE_PRIV (default) */
+#endif
 };
 
 /**
@@ -794,13 +797,17 @@ struct lyd_node_inner {
                                                  itself. In case of the first node, this pointer points to the last
                                                  node in the list. */
             struct lyd_meta *meta;          /**< pointer to the list of metadata of this node */
+#ifdef LYD_NODE_PRIV
             void *priv;                     /**< private user data, not used by libyang */
+#endif
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
     struct lyd_node *child;          /**< pointer to the first child node. */
     struct hash_table *children_ht;  /**< hash table with all the direct children (except keys for a list, lists without keys) */
 #define LYD_HT_MIN_ITEMS 4           /**< minimal number of children to create ::lyd_node_inner.children_ht hash table. */
+    struct lyd_uniq_idx *uniq_idx;   /**< indexes of the unique values of the direct child list instances, maintained
+                                          only with the ::LY_CTX_UNIQUE_INDEX context option */
 };
 
 /**
@@ -824,7 +831,9 @@ struct lyd_node_term {
                                                  itself. In case of the first node, this pointer points to the last
                                                  node in the list. */
             struct lyd_meta *meta;          /**< pointer to the list of metadata of this node */
+#ifdef LYD_NODE_PRIV
             void *priv;                     /**< private user data, not used by libyang */
+#endif
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
@@ -864,7 +873,9 @@ struct lyd_node_any {
                                                  itself. In case of the first node, this pointer points to the last
                                                  node in the list. */
             struct lyd_meta *meta;          /**< pointer to the list of metadata of this node */
+#ifdef LYD_NODE_PRIV
             void *priv;                     /**< private user data, not used by libyang */
+#endif
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
@@ -954,7 +965,9 @@ struct lyd_node_opaq {
                                                  itself. In case of the first node, this pointer points to the last
                                                  node in the list. */
             struct lyd_meta *meta;          /**< always NULL */
+#ifdef LYD_NODE_PRIV
             void *priv;                     /**< private user data, not used by libyang */
+#endif
         };
     };                                      /**< common part corresponding to ::lyd_node */
 
@@ -24,6 +24,7 @@
 #include "tree_data.h"
 #include "tree_data_internal.h"
 #include "tree_schema.h"
+#include "validation.h"
 
 static void
 lyd_free_meta(struct lyd_meta *meta, ly_bool siblings)
@@ -164,7 +165,8 @@ lyd_free_subtree(struct lyd_node *node, ly_bool top)
         lydict_remove(LYD_CTX(opaq), opaq->value);
         ly_free_prefix_data(opaq->format, opaq->val_prefix_data);
     } else if (node->schema->nodetype & LYD_NODE_INNER) {
-        /* remove children hash table in case of inner data node */
+        /* remove unique indexes and children hash table in case of inner data node */
+        lyd_val_uniq_idx_free((struct lyd_node_inner *)node);
         lyht_free(((struct lyd_node_inner *)node)->children_ht);
         ((struct lyd_node_inner *)node)->children_ht = NULL;
 
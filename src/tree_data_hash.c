@@ -30,9 +30,6 @@ LY_ERR
 lyd_hash(struct lyd_node *node)
 {
     struct lyd_node *iter;
-    const void *hash_key;
-    ly_bool dyn;
-    size_t key_len;
 
     if (!node->schema) {
         return LY_SUCCESS;
@@ -55,22 +52,14 @@ lyd_hash(struct lyd_node *node)
             for (iter = list->child; iter && iter->schema && (iter->schema->flags & LYS_KEY); iter = iter->next) {
                 struct lyd_node_term *key = (struct lyd_node_term *)iter;
 
-                hash_key = key->value.realtype->plugin->print(NULL, &key->value, LY_VALUE_LYB, NULL, &dyn, &key_len);
-                node->hash = dict_hash_multi(node->hash, hash_key, key_len);
-                if (dyn) {
-                    free((void *)hash_key);
-                }
+                node->hash = lyplg_type_hash_value(&key->value, node->hash);
             }
         }
     } else if (node->schema->nodetype == LYS_LEAFLIST) {
         /* leaf-list adds its hash key */
         struct lyd_node_term *llist = (struct lyd_node_term *)node;
 
-        hash_key = llist->value.realtype->plugin->print(NULL, &llist->value, LY_VALUE_LYB, NULL, &dyn, &key_len);
-        node->hash = dict_hash_multi(node->hash, hash_key, key_len);
-        if (dyn) {
-            free((void *)hash_key);
-        }
+        node->hash = lyplg_type_hash_value(&llist->value, node->hash);
     }
 
     /* finish the hash */
@@ -16,6 +16,7 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -854,58 +855,139 @@ ly_format2str(LY_VALUE_FORMAT format)
     return NULL;
 }
 
-API LY_ERR
-ly_time_str2time(const char *value, time_t *time, char **fractions_s)
+/**
+ * @brief Get the number of days since the epoch (1970-01-01) of a proleptic Gregorian calendar date.
+ *
+ * Out-of-range months and days are normalized the same way as by timegm(3), so "2005-02-29" is the same
+ * day as "2005-03-01".
+ *
+ * @param[in] year Year.
+ * @param[in] mon Month, 1 - 12.
+ * @param[in] mday Day of the month, 1 - 31.
+ * @return Days since the epoch, negative for dates before it.
+ */
+static int64_t
+ly_time_days_from_civil(int64_t year, int64_t mon, int64_t mday)
 {
-    struct tm tm = {0};
-    uint32_t i, frac_len;
-    const char *frac;
-    int64_t shift, shift_m;
-    time_t t;
+    int64_t era, yoe, doy, doe;
 
-    LY_CHECK_ARG_RET(NULL, value, time, LY_EINVAL);
+    /* normalize the month */
+    --mon;
+    year += (mon >= 0) ? mon / 12 : (mon - 11) / 12;
+    mon = ((mon % 12) + 12) % 12;
+
+    /* years start in March so that the leap day is the last day of a year */
+    if (mon < 2) {
+        --year;
+    }
+    era = ((year >= 0) ? year : year - 399) / 400;
+    yoe = year - era * 400;
+    doy = (153 * ((mon > 1) ? mon - 2 : mon + 10) + 2) / 5 + mday - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief Get the proleptic Gregorian calendar date of a number of days since the epoch (1970-01-01).
+ *
+ * @param[in] days Days since the epoch.
+ * @param[out] year Year.
+ * @param[out] mon Month, 1 - 12.
+ * @param[out] mday Day of the month, 1 - 31.
+ */
+static void
+ly_time_civil_from_days(int64_t days, int64_t *year, int32_t *mon, int32_t *mday)
+{
+    int64_t era, doe, yoe, doy, mp;
+
+    days += 719468;
+    era = ((days >= 0) ? days : days - 146096) / 146097;
+    doe = days - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+
+    *mday = doy - (153 * mp + 2) / 5 + 1;
+    *mon = (mp < 10) ? mp + 3 : mp - 9;
+    *year = yoe + era * 400 + (*mon <= 2);
+}
+
+/**
+ * @brief Parse a fixed number of decimal digits.
+ *
+ * @param[in] str String with at least @p len digits.
+ * @param[in] len Number of digits to parse.
+ * @return Parsed number.
+ */
+static int64_t
+ly_time_parse_digits(const char *str, uint32_t len)
+{
+    int64_t num = 0;
+    uint32_t i;
+
+    for (i = 0; i < len; ++i) {
+        num = num * 10 + (str[i] - '0');
+    }
+
+    return num;
+}
 
-    tm.tm_year = atoi(&value[0]) - 1900;
-    tm.tm_mon = atoi(&value[5]) - 1;
-    tm.tm_mday = atoi(&value[8]);
-    tm.tm_hour = atoi(&value[11]);
-    tm.tm_min = atoi(&value[14]);
-    tm.tm_sec = atoi(&value[17]);
+/**
+ * @brief Convert date-and-time from string to UNIX timestamp without copying the fractions of a second.
+ *
+ * @param[in] value Valid string date-and-time value.
+ * @param[out] time UNIX timestamp.
+ * @param[out] frac Fractions of a second in @p value, NULL if none.
+ * @param[out] frac_len Length of @p frac.
+ */
+static void
+ly_time_str2time_frac(const char *value, time_t *time, const char **frac, uint32_t *frac_len)
+{
+    int64_t t, shift;
+    uint32_t i;
 
-    t = timegm(&tm);
+    /* YYYY-MM-DDThh:mm:ss, checked by the date-and-time pattern */
+    t = ly_time_days_from_civil(ly_time_parse_digits(&value[0], 4), ly_time_parse_digits(&value[5], 2),
+            ly_time_parse_digits(&value[8], 2)) * 86400;
+    t += ly_time_parse_digits(&value[11], 2) * 3600 + ly_time_parse_digits(&value[14], 2) * 60 +
+            ly_time_parse_digits(&value[17], 2);
     i = 19;
 
     /* fractions of a second */
+    *frac = NULL;
+    *frac_len = 0;
     if (value[i] == '.') {
         ++i;
-        frac = &value[i];
-        for (frac_len = 0; isdigit(frac[frac_len]); ++frac_len) {}
-
-        i += frac_len;
-    } else {
-        frac = NULL;
+        *frac = &value[i];
+        while (isdigit(value[i])) {
+            ++i;
+        }
+        *frac_len = &value[i] - *frac;
     }
 
-    /* apply offset */
-    if ((value[i] == 'Z') || (value[i] == 'z')) {
-        /* zero shift */
-        shift = 0;
-    } else {
-        shift = strtol(&value[i], NULL, 10);
-        shift = shift * 60 * 60; /* convert from hours to seconds */
-        shift_m = strtol(&value[i + 4], NULL, 10) * 60; /* includes conversion from minutes to seconds */
-        /* correct sign */
-        if (shift < 0) {
-            shift_m *= -1;
+    /* apply offset, we have to shift to the opposite way to correct the time */
+    if ((value[i] != 'Z') && (value[i] != 'z')) {
+        shift = ly_time_parse_digits(&value[i + 1], 2) * 3600 + ly_time_parse_digits(&value[i + 4], 2) * 60;
+        if (value[i] == '-') {
+            shift = -shift;
         }
-        /* connect hours and minutes of the shift */
-        shift = shift + shift_m;
+        t -= shift;
     }
 
-    /* we have to shift to the opposite way to correct the time */
-    t -= shift;
-
     *time = t;
+}
+
+API LY_ERR
+ly_time_str2time(const char *value, time_t *time, char **fractions_s)
+{
+    const char *frac;
+    uint32_t frac_len;
+
+    LY_CHECK_ARG_RET(NULL, value, time, LY_EINVAL);
+
+    ly_time_str2time_frac(value, time, &frac, &frac_len);
+
     if (fractions_s) {
         if (frac) {
             *fractions_s = strndup(frac, frac_len);
@@ -921,35 +1003,28 @@ API LY_ERR
 ly_time_time2str(time_t time, const char *fractions_s, char **str)
 {
     struct tm tm;
-    char zoneshift[8];
-    int32_t zonediff_h, zonediff_m;
+    int64_t t, days, year;
+    int32_t mon, mday, secs, zonediff;
 
     LY_CHECK_ARG_RET(NULL, str, LY_EINVAL);
 
-    /* initialize the local timezone */
+    /* initialize the local timezone and learn its offset, the only information needed from libc */
     tzset();
-
-    /* convert */
     if (!localtime_r(&time, &tm)) {
         return LY_ESYS;
     }
+    zonediff = tm.tm_gmtoff;
 
-    /* get timezone offset */
-    if (tm.tm_gmtoff == 0) {
-        /* time is Zulu (UTC) */
-        zonediff_h = 0;
-        zonediff_m = 0;
-    } else {
-        /* timezone offset */
-        zonediff_h = tm.tm_gmtoff / 60 / 60;
-        zonediff_m = tm.tm_gmtoff / 60 % 60;
-    }
-    sprintf(zoneshift, "%+03d:%02d", zonediff_h, zonediff_m);
+    /* convert the local time */
+    t = (int64_t)time + zonediff;
+    days = ((t >= 0) ? t : t - 86399) / 86400;
+    secs = t - days * 86400;
+    ly_time_civil_from_days(days, &year, &mon, &mday);
 
     /* print */
-    if (asprintf(str, "%04d-%02d-%02dT%02d:%02d:%02d%s%s%s",
-            tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
-            fractions_s ? "." : "", fractions_s ? fractions_s : "", zoneshift) == -1) {
+    if (asprintf(str, "%04" PRId64 "-%02d-%02dT%02d:%02d:%02d%s%s%c%02d:%02d", year, mon, mday, secs / 3600,
+            secs / 60 % 60, secs % 60, fractions_s ? "." : "", fractions_s ? fractions_s : "", (zonediff < 0) ? '-' : '+',
+            abs(zonediff) / 3600, abs(zonediff) / 60 % 60) == -1) {
         return LY_EMEM;
     }
 
@@ -959,27 +1034,17 @@ ly_time_time2str(time_t time, const char *fractions_s, char **str)
 API LY_ERR
 ly_time_str2ts(const char *value, struct timespec *ts)
 {
-    LY_ERR rc;
-    char *fractions_s, frac_buf[10];
-    int frac_len;
+    const char *frac;
+    uint32_t frac_len, i;
 
     LY_CHECK_ARG_RET(NULL, value, ts, LY_EINVAL);
 
-    rc = ly_time_str2time(value, &ts->tv_sec, &fractions_s);
-    LY_CHECK_RET(rc);
+    ly_time_str2time_frac(value, &ts->tv_sec, &frac, &frac_len);
 
-    /* convert fractions of a second to nanoseconds */
-    if (fractions_s) {
-        /* init frac_buf with zeroes */
-        memset(frac_buf, '0', 9);
-        frac_buf[9] = '\0';
-
-        frac_len = strlen(fractions_s);
-        memcpy(frac_buf, fractions_s, frac_len > 9 ? 9 : frac_len);
-        ts->tv_nsec = atol(frac_buf);
-        free(fractions_s);
-    } else {
-        ts->tv_nsec = 0;
+    /* convert fractions of a second to nanoseconds, directly from the value */
+    ts->tv_nsec = 0;
+    for (i = 0; i < 9; ++i) {
+        ts->tv_nsec = ts->tv_nsec * 10 + ((i < frac_len) ? frac[i] - '0' : 0);
     }
 
     return LY_SUCCESS;
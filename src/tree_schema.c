@@ -1015,10 +1015,7 @@ LY_ERR
 lys_unres_dep_sets_create(struct ly_ctx *ctx, struct ly_set *main_set, struct lys_module *mod)
 {
     LY_ERR ret = LY_SUCCESS;
-    struct lys_module *m;
     struct ly_set *dep_set = NULL, *ctx_set = NULL, aux_set = {0};
-    uint32_t i;
-    ly_bool found;
 
     assert(!main_set->count);
 
@@ -1047,26 +1044,6 @@ lys_unres_dep_sets_create(struct ly_ctx *ctx, struct ly_set *main_set, struct ly
         ly_set_erase(&aux_set, NULL);
         assert(dep_set->count);
 
-        /* check whether there is any module that will be (re)compiled */
-        found = 0;
-        for (i = 0; i < dep_set->count; ++i) {
-            m = dep_set->objs[i];
-            if (m->to_compile) {
-                found = 1;
-                break;
-            }
-        }
-
-        if (found) {
-            /* if there is, all the implemented modules need to be recompiled */
-            for (i = 0; i < dep_set->count; ++i) {
-                m = dep_set->objs[i];
-                if (m->implemented) {
-                    m->to_compile = 1;
-                }
-            }
-        }
-
         /* add the dep set into main set */
         LY_CHECK_GOTO(ret = ly_set_add(main_set, dep_set, 1, NULL), cleanup);
         dep_set = NULL;
@@ -1079,12 +1056,13 @@ lys_unres_dep_sets_create(struct ly_ctx *ctx, struct ly_set *main_set, struct ly
 
 #ifndef NDEBUG
     LOGDBG(LY_LDGDEPSETS, "dep sets created (%" PRIu32 "):", main_set->count);
-    for (i = 0; i < main_set->count; ++i) {
+    for (uint32_t i = 0; i < main_set->count; ++i) {
         struct ly_set *iter_set = main_set->objs[i];
 
         LOGDBG(LY_LDGDEPSETS, "dep set #%" PRIu32 ":", i);
         for (uint32_t j = 0; j < iter_set->count; ++j) {
-            m = iter_set->objs[j];
+            struct lys_module *m = iter_set->objs[j];
+
             LOGDBG(LY_LDGDEPSETS, "\t%s", m->name);
         }
     }
@@ -1178,13 +1156,14 @@ lys_set_implemented(struct lys_module *mod, const char **features)
     struct lys_glob_unres *unres = &mod->ctx->unres;
 
     LY_CHECK_ARG_RET(NULL, mod, LY_EINVAL);
+    LY_CHECK_CTX_FROZEN_RET(mod->ctx, LY_EDENIED);
 
     /* implement */
     ret = _lys_set_implemented(mod, features, unres);
     LY_CHECK_GOTO(ret, cleanup);
 
     if (!(mod->ctx->flags & LY_CTX_EXPLICIT_COMPILE)) {
-        /* create dep set for the module and mark all the modules that will be (re)compiled */
+        /* create dep set for the module */
         LY_CHECK_GOTO(ret = lys_unres_dep_sets_create(mod->ctx, &unres->dep_sets, mod), cleanup);
 
         /* (re)compile the whole dep set (other dep sets will have no modules marked for compilation) */
@@ -1757,6 +1736,7 @@ lys_parse(struct ly_ctx *ctx, struct ly_in *in, LYS_INFORMAT format, const char
         *module = NULL;
     }
     LY_CHECK_ARG_RET(NULL, ctx, in, LY_EINVAL);
+    LY_CHECK_CTX_FROZEN_RET(ctx, LY_EDENIED);
 
     format = lys_parse_get_format(in, format);
     LY_CHECK_ARG_RET(ctx, format, LY_EINVAL);
@@ -1773,7 +1753,7 @@ lys_parse(struct ly_ctx *ctx, struct ly_in *in, LYS_INFORMAT format, const char
     LY_CHECK_GOTO(ret, cleanup);
 
     if (!(ctx->flags & LY_CTX_EXPLICIT_COMPILE)) {
-        /* create dep set for the module and mark all the modules that will be (re)compiled */
+        /* create dep set for the module */
         LY_CHECK_GOTO(ret = lys_unres_dep_sets_create(ctx, &ctx->unres.dep_sets, mod), cleanup);
 
         /* (re)compile the whole dep set (other dep sets will have no modules marked for compilation) */
@@ -169,6 +169,9 @@ struct lys_yang_parser_ctx {
     struct ly_in *in;                /**< input handler for the parser */
     uint64_t indent;                 /**< current position on the line for YANG indentation */
     uint32_t depth;                  /**< current number of nested blocks, see ::LY_MAX_BLOCK_DEPTH */
+    uint8_t dropped_text[LY_MAX_BLOCK_DEPTH + 1]; /**< description (0x01) and reference (0x02) statements not stored
+                                          because of ::LY_CTX_NO_DESCRIPTIONS in each of the currently nested blocks,
+                                          to detect their duplicates */
 };
 
 /**
@@ -557,7 +560,7 @@ LY_ERR _lys_set_implemented(struct lys_module *mod, const char **features, struc
 
 /**
  * @brief Create dependency sets for all modules in a context.
- * Also sets to_compile flags for all the modules that should be (re)compiled.
+ * The to_compile flags of the modules affected by the changed modules are set when compiling the dep set.
  *
  * @param[in] ctx Context to use.
  * @param[in,out] main_set Set of dependency module sets.
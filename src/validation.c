@@ -17,10 +17,12 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "common.h"
 #include "compat.h"
@@ -31,6 +33,7 @@
 #include "parser_internal.h"
 #include "plugins_exts.h"
 #include "plugins_exts/metadata.h"
+#include "plugins_internal.h"
 #include "plugins_types.h"
 #include "set.h"
 #include "tree.h"
@@ -110,12 +113,107 @@ cleanup:
     return ret;
 }
 
+/**
+ * @brief Cached result of a when or must condition shared by several data nodes.
+ */
+struct lyd_val_cond_rec {
+    const struct lyxp_expr *cond;   /**< evaluated condition */
+    const struct lysc_node *schema; /**< schema node of the condition */
+    const struct lyd_node *parent;  /**< parent of the context node for ::LYXP_CTX_DEP_PARENT conditions */
+    ly_bool result;                 /**< condition result */
+};
+
+/**
+ * @brief Callback for checking cached condition equality.
+ *
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_val_cond_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    struct lyd_val_cond_rec *rec1 = val1_p, *rec2 = val2_p;
+
+    return (rec1->cond == rec2->cond) && (rec1->schema == rec2->schema) && (rec1->parent == rec2->parent);
+}
+
+/**
+ * @brief Evaluate a when or must condition. Conditions that do not depend on the context node itself are
+ * evaluated only once for all the data nodes sharing the same context (see ::lyxp_expr.ctx_dep).
+ *
+ * The cached results are valid only while the data tree is not modified.
+ *
+ * @param[in] cond Condition to evaluate.
+ * @param[in] prefixes Compiled prefixes of @p cond.
+ * @param[in] schema Schema node of the condition, its module is the current module.
+ * @param[in] ctx_node Context node.
+ * @param[in] tree Data tree.
+ * @param[in,out] cache Cache of condition results, is created if needed. NULL to not use it.
+ * @param[out] result Boolean result of @p cond.
+ * @return LY_SUCCESS on success.
+ * @return LY_EINCOMPLETE if a referenced node does not have its when evaluated.
+ * @return LY_ERR value on error.
+ */
+static LY_ERR
+lyd_validate_cond(const struct lyxp_expr *cond, struct lysc_prefix *prefixes, const struct lysc_node *schema,
+        const struct lyd_node *ctx_node, const struct lyd_node *tree, struct hash_table **cache, ly_bool *result)
+{
+    LY_ERR ret;
+    const struct ly_ctx *ctx = schema->module->ctx;
+    struct lyxp_set xp_set;
+    struct lyd_val_cond_rec rec = {0}, *match;
+    uint32_t hash = 0;
+
+    if (cond->ctx_dep == LYXP_CTX_DEP_NODE) {
+        /* cannot be shared */
+        cache = NULL;
+    }
+
+    if (cache) {
+        rec.cond = cond;
+        rec.schema = schema;
+        if ((cond->ctx_dep == LYXP_CTX_DEP_PARENT) && ctx_node) {
+            rec.parent = lyd_parent(ctx_node);
+        }
+        hash = dict_hash_multi(0, (const char *)&rec.cond, sizeof rec.cond);
+        hash = dict_hash_multi(hash, (const char *)&rec.schema, sizeof rec.schema);
+        hash = dict_hash_multi(hash, (const char *)&rec.parent, sizeof rec.parent);
+        hash = dict_hash_multi(hash, NULL, 0);
+
+        if (*cache && !lyht_find(*cache, &rec, hash, (void **)&match)) {
+            /* already evaluated */
+            *result = match->result;
+            return LY_SUCCESS;
+        }
+    }
+
+    /* evaluate the condition, only its boolean value is needed */
+    memset(&xp_set, 0, sizeof xp_set);
+    ret = lyxp_eval(ctx, cond, schema->module, LY_VALUE_SCHEMA_RESOLVED, prefixes, ctx_node, tree, NULL, &xp_set,
+            LYXP_SCHEMA | LYXP_EXISTS);
+    LY_CHECK_RET(ret);
+    lyxp_set_cast(&xp_set, LYXP_SET_BOOLEAN);
+    *result = xp_set.val.bln;
+
+    if (cache) {
+        /* remember the result */
+        if (!*cache) {
+            *cache = lyht_new(LYHT_MIN_SIZE, sizeof rec, lyd_val_cond_equal_cb, NULL, 1);
+            LY_CHECK_ERR_RET(!*cache, LOGMEM(ctx), LY_EMEM);
+        }
+        rec.result = *result;
+        LY_CHECK_RET(lyht_insert(*cache, &rec, hash, NULL));
+    }
+
+    return LY_SUCCESS;
+}
+
 /**
  * @brief Evaluate all relevant "when" conditions of a node.
  *
  * @param[in] tree Data tree.
  * @param[in] node Node whose relevant when conditions will be evaluated.
  * @param[in] schema Schema node of @p node. It may not be possible to use directly if @p node is opaque.
+ * @param[in,out] cache Cache of condition results, NULL to not use it.
  * @param[out] disabled First when that evaluated false, if any.
  * @return LY_SUCCESS on success.
  * @return LY_EINCOMPLETE if a referenced node does not have its when evaluated.
@@ -123,11 +221,10 @@ cleanup:
  */
 static LY_ERR
 lyd_validate_node_when(const struct lyd_node *tree, const struct lyd_node *node, const struct lysc_node *schema,
-        const struct lysc_when **disabled)
+        struct hash_table **cache, const struct lysc_when **disabled)
 {
-    LY_ERR ret;
     const struct lyd_node *ctx_node;
-    struct lyxp_set xp_set;
+    ly_bool result;
     LY_ARRAY_COUNT_TYPE u;
 
     assert(!node->schema || (node->schema == schema));
@@ -148,16 +245,10 @@ lyd_validate_node_when(const struct lyd_node *tree, const struct lyd_node *node,
                 ctx_node = lyd_parent(node);
             }
 
-            /* evaluate when */
-            memset(&xp_set, 0, sizeof xp_set);
-            ret = lyxp_eval(LYD_CTX(node), when->cond, schema->module, LY_VALUE_SCHEMA_RESOLVED, when->prefixes,
-                    ctx_node, tree, NULL, &xp_set, LYXP_SCHEMA);
-            lyxp_set_cast(&xp_set, LYXP_SET_BOOLEAN);
-
-            /* return error or LY_EINCOMPLETE for dependant unresolved when */
-            LY_CHECK_RET(ret);
+            /* evaluate when, return error or LY_EINCOMPLETE for dependant unresolved when */
+            LY_CHECK_RET(lyd_validate_cond(when->cond, when->prefixes, schema, ctx_node, tree, cache, &result));
 
-            if (!xp_set.val.bln) {
+            if (!result) {
                 /* false when */
                 *disabled = when;
                 return LY_SUCCESS;
@@ -170,45 +261,211 @@ lyd_validate_node_when(const struct lyd_node *tree, const struct lyd_node *node,
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Get the evaluation order of the when conditions of a node.
+ *
+ * @param[in] schema Schema node of the node with when conditions.
+ * @return Evaluation order, see ::lyxp_expr.when_order.
+ */
+static uint32_t
+lyd_validate_when_order(const struct lysc_node *schema)
+{
+    struct lysc_when **whens;
+    LY_ARRAY_COUNT_TYPE u;
+    uint32_t order = 0;
+
+    do {
+        whens = lysc_node_when(schema);
+        LY_ARRAY_FOR(whens, u) {
+            if (whens[u]->cond->when_order > order) {
+                order = whens[u]->cond->when_order;
+            }
+        }
+        schema = schema->parent;
+    } while (schema && (schema->nodetype & (LYS_CASE | LYS_CHOICE)));
+
+    return order;
+}
+
+/**
+ * @brief Sort nodes with when conditions by their evaluation order, keeping the order of nodes with the same one.
+ *
+ * @param[in,out] node_when Set with nodes with when conditions.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_when_sort(struct ly_set *node_when)
+{
+    LY_ERR ret = LY_SUCCESS;
+    uint32_t i, max_order = 0, *orders = NULL, *starts = NULL;
+    void **objs = NULL;
+
+    orders = malloc(node_when->count * sizeof *orders);
+    LY_CHECK_ERR_GOTO(!orders, LOGMEM(NULL); ret = LY_EMEM, cleanup);
+    for (i = 0; i < node_when->count; ++i) {
+        orders[i] = lyd_validate_when_order(node_when->dnodes[i]->schema);
+        if (orders[i] > max_order) {
+            max_order = orders[i];
+        }
+    }
+    if (!max_order) {
+        /* nothing to sort */
+        goto cleanup;
+    }
+
+    /* counting sort, learn the first index of every order */
+    starts = calloc(max_order + 2, sizeof *starts);
+    objs = malloc(node_when->size * sizeof *objs);
+    LY_CHECK_ERR_GOTO(!starts || !objs, LOGMEM(NULL); ret = LY_EMEM, cleanup);
+    for (i = 0; i < node_when->count; ++i) {
+        ++starts[orders[i] + 1];
+    }
+    for (i = 1; i <= max_order + 1; ++i) {
+        starts[i] += starts[i - 1];
+    }
+    for (i = 0; i < node_when->count; ++i) {
+        objs[starts[orders[i]]++] = node_when->objs[i];
+    }
+
+    free(node_when->objs);
+    node_when->objs = objs;
+    objs = NULL;
+
+cleanup:
+    free(orders);
+    free(starts);
+    free(objs);
+    return ret;
+}
+
+/**
+ * @brief Callback for comparing pointers in a hash table.
+ *
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_val_ptr_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    return *(void **)val1_p == *(void **)val2_p;
+}
+
+/**
+ * @brief Get the hash of a pointer.
+ *
+ * @param[in] obj Pointer to hash.
+ * @return Hash of @p obj.
+ */
+static uint32_t
+lyd_val_ptr_hash(const void *obj)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&obj, sizeof obj);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Add an object into a set unless it already is in it.
+ *
+ * @param[in] set Set to add into.
+ * @param[in,out] ht Hash table of all the objects in @p set, created if NULL.
+ * @param[in] obj Object to add.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_set_add(struct ly_set *set, struct hash_table **ht, void *obj)
+{
+    LY_ERR r;
+    uint32_t i;
+
+    if (!*ht) {
+        /* hash the objects already in the set */
+        *ht = lyht_new(LYHT_MIN_SIZE, sizeof obj, lyd_val_ptr_equal_cb, NULL, 1);
+        LY_CHECK_ERR_RET(!*ht, LOGMEM(NULL), LY_EMEM);
+
+        for (i = 0; i < set->count; ++i) {
+            r = lyht_insert(*ht, &set->objs[i], lyd_val_ptr_hash(set->objs[i]), NULL);
+            LY_CHECK_RET(r && (r != LY_EEXIST), r);
+        }
+    }
+
+    r = lyht_insert(*ht, &obj, lyd_val_ptr_hash(obj), NULL);
+    if (r == LY_EEXIST) {
+        /* already added */
+        return LY_SUCCESS;
+    }
+    LY_CHECK_RET(r);
+
+    return ly_set_add(set, obj, 1, NULL);
+}
+
+/**
+ * @brief Check whether a node is in an autodeleted subtree.
+ *
+ * @param[in] node Node to check.
+ * @param[in] node_del_ht Hash table of autodeleted subtrees, NULL if there are none.
+ * @return Whether @p node was autodeleted.
+ */
+static ly_bool
+lyd_validate_when_deleted(const struct lyd_node *node, struct hash_table *node_del_ht)
+{
+    if (!node_del_ht) {
+        return 0;
+    }
+
+    while (node->parent) {
+        node = lyd_parent(node);
+    }
+    return !lyht_find(node_del_ht, &node, lyd_val_ptr_hash(node), NULL);
+}
+
 /**
  * @brief Evaluate when conditions of collected unres nodes.
  *
+ * The nodes are expected to be ordered so that the when conditions they depend on are evaluated first, any
+ * remaining in @p node_when depend on when conditions not yet resolved.
+ *
  * @param[in,out] tree Data tree, is updated if some nodes are autodeleted.
  * @param[in] mod Module of the @p tree to take into consideration when deleting @p tree and moving it.
  * If set, it is expected @p tree should point to the first node of @p mod. Otherwise it will simply be
  * the first top-level sibling.
  * @param[in] node_when Set with nodes with "when" conditions.
  * @param[in,out] node_types Set with nodes with unresolved types, remove any with false "when" parents.
+ * @param[in,out] node_del Set of unlinked autodeleted subtrees to free.
+ * @param[in,out] node_del_ht Hash table of @p node_del, created when the first subtree is autodeleted.
+ * @param[in,out] cache Cache of condition results, is cleared if some nodes are autodeleted.
  * @param[in,out] diff Validation diff.
  * @return LY_SUCCESS on success.
  * @return LY_ERR value on error.
  */
 static LY_ERR
 lyd_validate_unres_when(struct lyd_node **tree, const struct lys_module *mod, struct ly_set *node_when,
-        struct ly_set *node_types, struct lyd_node **diff)
+        struct ly_set *node_types, struct ly_set *node_del, struct hash_table **node_del_ht, struct hash_table **cache,
+        struct lyd_node **diff)
 {
-    LY_ERR ret;
-    uint32_t i, idx;
+    LY_ERR ret = LY_SUCCESS;
+    uint32_t i, j, idx;
     const struct lysc_when *disabled;
     struct lyd_node *node = NULL, *elem;
 
-    if (!node_when->count) {
-        return LY_SUCCESS;
-    }
-
-    i = node_when->count;
-    do {
-        --i;
+    for (i = 0, j = 0; i < node_when->count; ++i) {
         node = node_when->dnodes[i];
+        if (lyd_validate_when_deleted(node, *node_del_ht)) {
+            /* a parent was autodeleted */
+            continue;
+        }
+
         LOG_LOCSET(node->schema, node, NULL, NULL);
 
         /* evaluate all when expressions that affect this node's existence */
-        ret = lyd_validate_node_when(*tree, node, node->schema, &disabled);
+        ret = lyd_validate_node_when(*tree, node, node->schema, cache, &disabled);
         if (!ret) {
             if (disabled) {
                 /* when false */
                 if (node->flags & LYD_WHEN_TRUE) {
-                    /* autodelete */
+                    /* autodelete, the cached results may no longer be valid */
+                    lyht_free(*cache);
+                    *cache = NULL;
                     lyd_del_move_root(tree, node, mod);
                     if (diff) {
                         /* add into diff */
@@ -226,8 +483,9 @@ lyd_validate_unres_when(struct lyd_node **tree, const struct lys_module *mod, st
                         }
                     }
 
-                    /* free */
-                    lyd_free_tree(node);
+                    /* unlink, freed once no other nodes in the set can be in the subtree */
+                    lyd_unlink_tree(node);
+                    LY_CHECK_GOTO(ret = lyd_val_set_add(node_del, node_del_ht, node), error);
                 } else {
                     /* invalid data */
                     LOGVAL(LYD_CTX(node), LY_VCODE_NOWHEN, disabled->cond->expr);
@@ -239,16 +497,20 @@ lyd_validate_unres_when(struct lyd_node **tree, const struct lys_module *mod, st
                 node->flags |= LYD_WHEN_TRUE;
             }
 
-            /* remove this node from the set, its when was resolved */
-            ly_set_rm_index(node_when, i, NULL);
-        } else if (ret != LY_EINCOMPLETE) {
+            /* this node's when was resolved */
+        } else if (ret == LY_EINCOMPLETE) {
+            /* depends on an unresolved when, keep it in the set */
+            node_when->dnodes[j++] = node;
+            ret = LY_SUCCESS;
+        } else {
             /* error */
             goto error;
         }
 
         LOG_LOCBACK(1, 1, 0, 0);
-    } while (i);
+    }
 
+    node_when->count = j;
     return LY_SUCCESS;
 
 error:
@@ -307,9 +569,164 @@ lysc_node_ext_tovalidate(struct ly_set *node_exts, struct lyd_node *node)
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Number of incomplete values resolved by a thread at once, see ::LYD_VALIDATE_MULTI_THREAD.
+ */
+#define LYD_VAL_MT_CHUNK 256
+
+/**
+ * @brief Shared state of threads resolving incomplete values.
+ */
+struct lyd_val_mt {
+    struct lyd_node_term **nodes;   /**< nodes with the values to resolve */
+    uint32_t count;                 /**< number of @p nodes */
+    const struct lyd_node *tree;    /**< data tree to resolve the values in */
+    uint32_t next_chunk;            /**< next chunk of @p nodes to resolve */
+    ly_bool failed;                 /**< whether resolving any value failed */
+    pthread_mutex_t lock;           /**< lock for @p failed */
+};
+
+/**
+ * @brief Thread resolving chunks of incomplete values.
+ *
+ * The values are resolved without logging, a failure is only recorded and stops all the threads.
+ *
+ * @param[in] arg Shared state ::lyd_val_mt.
+ * @return NULL.
+ */
+static void *
+lyd_validate_unres_types_mt_thread(void *arg)
+{
+    struct lyd_val_mt *mt = arg;
+    struct lyd_node_term *node;
+    struct lysc_type *type;
+    struct ly_err_item *err;
+    uint32_t chunk, chunks, i, end;
+    ly_bool failed;
+
+    chunks = (mt->count + LYD_VAL_MT_CHUNK - 1) / LYD_VAL_MT_CHUNK;
+    while ((chunk = LY_ATOMIC_INC_BARRIER(mt->next_chunk)) < chunks) {
+        pthread_mutex_lock(&mt->lock);
+        failed = mt->failed;
+        pthread_mutex_unlock(&mt->lock);
+        if (failed) {
+            break;
+        }
+
+        i = chunk * LYD_VAL_MT_CHUNK;
+        end = (mt->count - i > LYD_VAL_MT_CHUNK) ? i + LYD_VAL_MT_CHUNK : mt->count;
+        for ( ; i < end; ++i) {
+            node = mt->nodes[i];
+            type = ((struct lysc_node_leaf *)node->schema)->type;
+            err = NULL;
+            if (type->plugin->validate(LYD_CTX(node), type, &node->node, mt->tree, &node->value, &err)) {
+                ly_err_free(err);
+
+                pthread_mutex_lock(&mt->lock);
+                mt->failed = 1;
+                pthread_mutex_unlock(&mt->lock);
+                break;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Resolve incomplete leafref and instance-identifier values on several threads.
+ *
+ * Resolving these values only reads the data tree so they can be resolved in any order. Other values
+ * (such as unions, which store the resolved value) are left in @p node_types to be resolved sequentially.
+ * If any value fails to be resolved, all the values are left in @p node_types so that resolving them sequentially
+ * reports the same error as without threads.
+ *
+ * @param[in] tree Data tree.
+ * @param[in,out] node_types Set with nodes with unresolved types, resolved nodes are removed.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_unres_types_mt(const struct lyd_node *tree, struct ly_set *node_types)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyd_val_mt mt = {0};
+    struct lyd_node_term *node;
+    struct lysc_type *type;
+    pthread_t *threads = NULL;
+    uint32_t i, j, thread_count;
+    long cpus;
+
+    /* count the values that can be resolved in parallel */
+    for (i = 0; i < node_types->count; ++i) {
+        node = node_types->objs[i];
+        type = ((struct lysc_node_leaf *)node->schema)->type;
+        if ((type->plugin->validate == lyplg_type_validate_leafref) ||
+                (type->plugin->validate == lyplg_type_validate_instanceid)) {
+            ++mt.count;
+        }
+    }
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if ((mt.count < 2 * LYD_VAL_MT_CHUNK) || (cpus < 2)) {
+        /* not worth it */
+        return LY_SUCCESS;
+    }
+    thread_count = (mt.count + LYD_VAL_MT_CHUNK - 1) / LYD_VAL_MT_CHUNK;
+    if (thread_count > (uint32_t)cpus) {
+        thread_count = cpus;
+    }
+
+    mt.nodes = malloc(mt.count * sizeof *mt.nodes);
+    threads = malloc((thread_count - 1) * sizeof *threads);
+    LY_CHECK_ERR_GOTO(!mt.nodes || !threads, LOGMEM(LYD_CTX(tree)); ret = LY_EMEM, cleanup);
+    for (i = 0, j = 0; i < node_types->count; ++i) {
+        node = node_types->objs[i];
+        type = ((struct lysc_node_leaf *)node->schema)->type;
+        if ((type->plugin->validate == lyplg_type_validate_leafref) ||
+                (type->plugin->validate == lyplg_type_validate_instanceid)) {
+            mt.nodes[j++] = node;
+        }
+    }
+    mt.tree = tree;
+    pthread_mutex_init(&mt.lock, NULL);
+
+    /* the current thread resolves values as well */
+    for (i = 0; i < thread_count - 1; ++i) {
+        if (pthread_create(&threads[i], NULL, lyd_validate_unres_types_mt_thread, &mt)) {
+            break;
+        }
+    }
+    thread_count = i;
+    lyd_validate_unres_types_mt_thread(&mt);
+    for (i = 0; i < thread_count; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&mt.lock);
+
+    if (mt.failed) {
+        /* resolve all the values sequentially to log the error */
+        goto cleanup;
+    }
+
+    /* keep only the unresolved nodes, in the same order */
+    for (i = 0, j = 0; i < node_types->count; ++i) {
+        node = node_types->objs[i];
+        type = ((struct lysc_node_leaf *)node->schema)->type;
+        if ((type->plugin->validate != lyplg_type_validate_leafref) &&
+                (type->plugin->validate != lyplg_type_validate_instanceid)) {
+            node_types->objs[j++] = node;
+        }
+    }
+    node_types->count = j;
+
+cleanup:
+    free(mt.nodes);
+    free(threads);
+    return ret;
+}
+
 LY_ERR
-lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, struct ly_set *node_when, struct ly_set *node_exts,
-        struct ly_set *node_types, struct ly_set *meta_types, struct lyd_node **diff)
+lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, uint32_t val_opts, struct ly_set *node_when,
+        struct ly_set *node_exts, struct ly_set *node_types, struct ly_set *meta_types, struct lyd_node **diff)
 {
     LY_ERR ret = LY_SUCCESS;
     uint32_t i;
@@ -317,11 +734,26 @@ lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, struct
     if (node_when) {
         /* evaluate all when conditions */
         uint32_t prev_count;
+        struct hash_table *cache = NULL, *node_del_ht = NULL;
+        struct ly_set node_del = {0};
+
+        /* in the order of their dependencies so that a single pass is normally enough */
+        if (node_when->count > 1) {
+            LY_CHECK_RET(lyd_validate_when_sort(node_when));
+        }
+
         do {
             prev_count = node_when->count;
-            LY_CHECK_RET(lyd_validate_unres_when(tree, mod, node_when, node_types, diff));
+            ret = lyd_validate_unres_when(tree, mod, node_when, node_types, &node_del, &node_del_ht, &cache, diff);
             /* there must have been some when conditions resolved */
-        } while (prev_count > node_when->count);
+        } while (!ret && node_when->count && (prev_count > node_when->count));
+        lyht_free(cache);
+        lyht_free(node_del_ht);
+        for (i = 0; i < node_del.count; ++i) {
+            lyd_free_tree(node_del.dnodes[i]);
+        }
+        ly_set_erase(&node_del, NULL);
+        LY_CHECK_RET(ret);
 
         /* there could have been no cyclic when dependencies, checked during compilation */
         assert(!node_when->count);
@@ -344,6 +776,11 @@ lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, struct
         } while (i);
     }
 
+    if (node_types && node_types->count && (val_opts & LYD_VALIDATE_MULTI_THREAD)) {
+        /* resolve the values that do not depend on each other first */
+        LY_CHECK_RET(lyd_validate_unres_types_mt(*tree, node_types));
+    }
+
     if (node_types && node_types->count) {
         /* finish incompletely validated terminal values (traverse from the end for efficient set removal) */
         i = node_types->count;
@@ -786,7 +1223,7 @@ lyd_validate_dummy_when(const struct lyd_node *first, const struct lyd_node *par
     }
 
     /* evaluate all when */
-    ret = lyd_validate_node_when(tree, dummy, snode, disabled);
+    ret = lyd_validate_node_when(tree, dummy, snode, NULL, disabled);
     if (ret == LY_EINCOMPLETE) {
         /* all other when must be resolved by now */
         LOGINT(snode->module->ctx);
@@ -1058,299 +1495,1537 @@ uniquecheck:
 }
 
 /**
- * @brief Validate list unique leaves.
+ * @brief Hash the values of a list unique.
  *
- * @param[in] first First sibling to search in.
- * @param[in] snode Schema node to validate.
- * @param[in] uniques List unique arrays to validate.
- * @return LY_ERR value.
+ * @param[in] uniq Unique leaves.
+ * @param[in] inst List instance.
+ * @param[out] hash Hash of the unique values.
+ * @return Whether all the unique values are set and @p hash was generated.
  */
-static LY_ERR
-lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode, const struct lysc_node_leaf ***uniques)
+static ly_bool
+lyd_val_uniq_hash(const struct lysc_node_leaf **uniq, const struct lyd_node *inst, uint32_t *hash)
 {
     const struct lyd_node *diter;
-    struct ly_set *set;
-    LY_ARRAY_COUNT_TYPE u, v, x = 0;
-    LY_ERR ret = LY_SUCCESS;
-    uint32_t hash, i, size = 0;
-    size_t key_len;
-    ly_bool dyn;
-    const void *hash_key;
-    void *cb_data;
-    struct hash_table **uniqtables = NULL;
     struct lyd_value *val;
-    struct ly_ctx *ctx = snode->module->ctx;
-
-    assert(uniques);
-
-    /* get all list instances */
-    LY_CHECK_RET(ly_set_new(&set));
-    LY_LIST_FOR(first, diter) {
-        if (diter->schema == snode) {
-            ret = ly_set_add(set, (void *)diter, 1, NULL);
-            LY_CHECK_GOTO(ret, cleanup);
-        }
-    }
+    LY_ARRAY_COUNT_TYPE v;
 
-    if (set->count == 2) {
-        /* simple comparison */
-        if (lyd_val_uniq_list_equal(&set->objs[0], &set->objs[1], 0, (void *)0)) {
-            /* instance duplication */
-            ret = LY_EVALID;
-            goto cleanup;
+    *hash = 0;
+    for (v = 0; v < LY_ARRAY_COUNT(uniq); v++) {
+        diter = lyd_val_uniq_find_leaf(uniq[v], inst);
+        if (diter) {
+            val = &((struct lyd_node_term *)diter)->value;
+        } else {
+            /* use default value */
+            val = uniq[v]->dflt;
         }
-    } else if (set->count > 2) {
-        /* use hashes for comparison */
-        /* first, allocate the table, the size depends on number of items in the set,
-         * the following code detects number of upper zero bits in the items' counter value ... */
-        for (i = (sizeof set->count * CHAR_BIT) - 1; i > 0; i--) {
-            size = set->count << i;
-            size = size >> i;
-            if (size == set->count) {
-                break;
-            }
+        if (!val) {
+            /* unique item not present nor has default value */
+            return 0;
         }
-        LY_CHECK_ERR_GOTO(!i, LOGINT(ctx); ret = LY_EINT, cleanup);
-        /* ... and then we convert it to the position of the highest non-zero bit ... */
-        i = (sizeof set->count * CHAR_BIT) - i;
-        /* ... and by using it to shift 1 to the left we get the closest sufficient hash table size */
-        size = 1 << i;
 
-        uniqtables = malloc(LY_ARRAY_COUNT(uniques) * sizeof *uniqtables);
-        LY_CHECK_ERR_GOTO(!uniqtables, LOGMEM(ctx); ret = LY_EMEM, cleanup);
-        x = LY_ARRAY_COUNT(uniques);
-        for (v = 0; v < x; v++) {
-            cb_data = (void *)(uintptr_t)(v + 1L);
-            uniqtables[v] = lyht_new(size, sizeof(struct lyd_node *), lyd_val_uniq_list_equal, cb_data, 0);
-            LY_CHECK_ERR_GOTO(!uniqtables[v], LOGMEM(ctx); ret = LY_EMEM, cleanup);
-        }
+        /* add the value into the hash */
+        *hash = lyplg_type_hash_value(val, *hash);
+    }
+
+    /* finish the hash value */
+    *hash = dict_hash_multi(*hash, NULL, 0);
+    return 1;
+}
+
+/**
+ * @brief Record of a list instance in a unique index.
+ */
+struct lyd_uniq_inst {
+    struct lyd_node *inst;      /**< list instance, NULL if it was removed and the record is only in the dirty set */
+    ly_bool dirty;              /**< whether the record is in the dirty set */
+    struct {
+        uint32_t hash;          /**< hash of the unique values */
+        ly_bool inserted;       /**< whether the instance is inserted into the unique table with the hash */
+    } uniq[];                   /**< item for each unique of the list */
+};
+
+/**
+ * @brief Unique index of the instances of a list in a data parent, see ::LY_CTX_UNIQUE_INDEX.
+ */
+struct lyd_uniq_idx {
+    const struct lysc_node_list *slist; /**< list schema node */
+    struct hash_table **uniqtables;     /**< hash table with the instances for each unique of the list */
+    struct hash_table *insts;           /**< records (struct lyd_uniq_inst *) of all the list instances */
+    struct ly_set dirty;                /**< records of the instances changed since the last validation */
+    uint64_t invalidations;             /**< number of instance changes that were recorded */
+    uint64_t rehashes;                  /**< number of instances whose unique values were hashed */
+    struct lyd_uniq_idx *next;          /**< index of another list in the same parent */
+};
+
+/**
+ * @brief Callback for comparing 2 list instances in a unique index table by their pointers.
+ *
+ * Implementation of ::lyht_value_equal_cb. Used for removing the instances and resizing the tables because
+ * the values of the instances may have changed (or been freed) since they were inserted.
+ */
+static ly_bool
+lyd_val_uniq_ptr_equal(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    return *(struct lyd_node **)val1_p == *(struct lyd_node **)val2_p;
+}
+
+/**
+ * @brief Callback for comparing 2 instance records of a unique index.
+ *
+ * Implementation of ::lyht_value_equal_cb.
+ */
+static ly_bool
+lyd_val_uniq_inst_equal(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    return (*(struct lyd_uniq_inst **)val1_p)->inst == (*(struct lyd_uniq_inst **)val2_p)->inst;
+}
+
+/**
+ * @brief Get the hash of an instance record of a unique index.
+ *
+ * @param[in] inst List instance of the record.
+ * @return Record hash.
+ */
+static uint32_t
+lyd_val_uniq_inst_hash(const struct lyd_node *inst)
+{
+    uint32_t hash;
+
+    hash = dict_hash_multi(0, (const char *)&inst, sizeof inst);
+    return dict_hash_multi(hash, NULL, 0);
+}
+
+/**
+ * @brief Find the record of a list instance in a unique index.
+ *
+ * @param[in] idx Unique index.
+ * @param[in] inst List instance.
+ * @return Found record, NULL if there is none.
+ */
+static struct lyd_uniq_inst *
+lyd_val_uniq_inst_find(const struct lyd_uniq_idx *idx, const struct lyd_node *inst)
+{
+    struct lyd_uniq_inst key = {.inst = (struct lyd_node *)inst}, *key_p = &key, **match;
+
+    if (lyht_find(idx->insts, &key_p, lyd_val_uniq_inst_hash(inst), (void **)&match)) {
+        return NULL;
+    }
+    return *match;
+}
+
+/**
+ * @brief Remove a list instance from all the unique tables of an index.
+ *
+ * @param[in] idx Unique index.
+ * @param[in] rec Record of the instance.
+ */
+static void
+lyd_val_uniq_inst_unhash(struct lyd_uniq_idx *idx, struct lyd_uniq_inst *rec)
+{
+    LY_ARRAY_COUNT_TYPE u;
+
+    LY_ARRAY_FOR(idx->slist->uniques, u) {
+        if (rec->uniq[u].inserted) {
+            lyht_set_cb(idx->uniqtables[u], lyd_val_uniq_ptr_equal);
+            lyht_remove(idx->uniqtables[u], &rec->inst, rec->uniq[u].hash);
+            lyht_set_cb(idx->uniqtables[u], lyd_val_uniq_list_equal);
+            rec->uniq[u].inserted = 0;
+        }
+    }
+}
+
+/**
+ * @brief Mark a list instance changed in a unique index, create its record if needed.
+ *
+ * @param[in] idx Unique index.
+ * @param[in] inst List instance.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_uniq_inst_mark(struct lyd_uniq_idx *idx, struct lyd_node *inst)
+{
+    struct lyd_uniq_inst *rec;
+    LY_ERR ret;
+
+    rec = lyd_val_uniq_inst_find(idx, inst);
+    if (!rec) {
+        /* new instance */
+        rec = calloc(1, sizeof *rec + LY_ARRAY_COUNT(idx->slist->uniques) * sizeof *rec->uniq);
+        LY_CHECK_RET(!rec, LY_EMEM);
+        rec->inst = inst;
+
+        ret = lyht_insert(idx->insts, &rec, lyd_val_uniq_inst_hash(inst), NULL);
+        LY_CHECK_ERR_RET(ret, free(rec), ret);
+    }
+
+    if (!rec->dirty) {
+        LY_CHECK_RET(ly_set_add(&idx->dirty, rec, 1, NULL));
+        rec->dirty = 1;
+    }
+    ++idx->invalidations;
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Remove a list instance from a unique index.
+ *
+ * @param[in] idx Unique index.
+ * @param[in] inst List instance, its subtree may already be freed.
+ */
+static void
+lyd_val_uniq_inst_remove(struct lyd_uniq_idx *idx, struct lyd_node *inst)
+{
+    struct lyd_uniq_inst *rec;
+
+    rec = lyd_val_uniq_inst_find(idx, inst);
+    if (!rec) {
+        return;
+    }
+
+    lyht_remove(idx->insts, &rec, lyd_val_uniq_inst_hash(inst));
+    lyd_val_uniq_inst_unhash(idx, rec);
+    if (rec->dirty) {
+        /* freed with the dirty set */
+        rec->inst = NULL;
+    } else {
+        free(rec);
+    }
+    ++idx->invalidations;
+}
+
+/**
+ * @brief Free a unique index.
+ *
+ * @param[in] idx Unique index to free.
+ * @param[in] parent Data parent of the indexed instances.
+ */
+static void
+lyd_val_uniq_idx_free_single(struct lyd_uniq_idx *idx, const struct lyd_node_inner *parent)
+{
+    struct lyd_node *first, *iter;
+    struct lyd_uniq_inst *rec;
+    LY_ARRAY_COUNT_TYPE u;
+    uint32_t i;
+
+    /* records of the removed instances */
+    for (i = 0; i < idx->dirty.count; ++i) {
+        rec = idx->dirty.objs[i];
+        if (!rec->inst) {
+            free(rec);
+        }
+    }
+    ly_set_erase(&idx->dirty, NULL);
+
+    /* records of all the linked instances */
+    if (idx->insts) {
+        lyd_find_sibling_val(parent->child, &idx->slist->node, NULL, 0, &first);
+        LYD_LIST_FOR_INST(first, &idx->slist->node, iter) {
+            free(lyd_val_uniq_inst_find(idx, iter));
+        }
+        lyht_free(idx->insts);
+    }
+
+    if (idx->uniqtables) {
+        LY_ARRAY_FOR(idx->slist->uniques, u) {
+            lyht_free(idx->uniqtables[u]);
+        }
+        free(idx->uniqtables);
+    }
+    free(idx);
+}
+
+void
+lyd_val_uniq_idx_free(struct lyd_node_inner *parent)
+{
+    struct lyd_uniq_idx *idx;
+
+    while ((idx = parent->uniq_idx)) {
+        parent->uniq_idx = idx->next;
+        lyd_val_uniq_idx_free_single(idx, parent);
+    }
+}
+
+/**
+ * @brief Free one unique index of a data parent, it is created again by the next validation.
+ *
+ * @param[in] parent Data parent.
+ * @param[in] idx Unique index of @p parent to free.
+ */
+static void
+lyd_val_uniq_idx_drop(struct lyd_node_inner *parent, struct lyd_uniq_idx *idx)
+{
+    struct lyd_uniq_idx **idx_p;
+
+    for (idx_p = &parent->uniq_idx; *idx_p != idx; idx_p = &(*idx_p)->next) {}
+    *idx_p = idx->next;
+    lyd_val_uniq_idx_free_single(idx, parent);
+}
+
+/**
+ * @brief Find the unique index of a list in a data parent.
+ *
+ * @param[in] parent Data parent.
+ * @param[in] snode List schema node.
+ * @return Found unique index, NULL if there is none.
+ */
+static struct lyd_uniq_idx *
+lyd_val_uniq_idx_find(const struct lyd_node_inner *parent, const struct lysc_node *snode)
+{
+    struct lyd_uniq_idx *idx;
+
+    for (idx = parent->uniq_idx; idx && (&idx->slist->node != snode); idx = idx->next) {}
+    return idx;
+}
+
+void
+lyd_val_uniq_idx_change(struct lyd_node *node, ly_bool unlink)
+{
+    struct lyd_node *inst;
+    struct lyd_uniq_idx *idx;
+
+    if (!node->schema) {
+        return;
+    }
+
+    if (node->schema->nodetype == LYS_LIST) {
+        /* the list instance itself */
+        inst = node;
+    } else if ((node->schema->nodetype == LYS_CONTAINER) ||
+            ((node->schema->nodetype == LYS_LEAF) && (node->schema->flags & LYS_UNIQUE))) {
+        /* find the list instance whose unique values may have changed */
+        for (inst = lyd_parent(node); inst && inst->schema && (inst->schema->nodetype == LYS_CONTAINER);
+                inst = lyd_parent(inst)) {}
+        if (!inst || !inst->schema || (inst->schema->nodetype != LYS_LIST)) {
+            return;
+        }
+
+        /* the instance itself remains */
+        unlink = 0;
+    } else {
+        return;
+    }
+
+    if (!inst->parent || !inst->parent->schema) {
+        /* no index for top-level lists or lists in opaque nodes */
+        return;
+    }
+    idx = lyd_val_uniq_idx_find(inst->parent, inst->schema);
+    if (!idx) {
+        return;
+    }
+
+    if (unlink) {
+        lyd_val_uniq_inst_remove(idx, inst);
+    } else if (lyd_val_uniq_inst_mark(idx, inst)) {
+        /* the index cannot be updated, it will be created again */
+        lyd_val_uniq_idx_drop(inst->parent, idx);
+    }
+}
+
+/**
+ * @brief Create a unique index of list instances.
+ *
+ * @param[in] parent Data parent of the instances.
+ * @param[in] first First list instance.
+ * @param[out] idx_p Created unique index, added into @p parent.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_uniq_idx_new(struct lyd_node_inner *parent, struct lyd_node *first, struct lyd_uniq_idx **idx_p)
+{
+    struct lyd_uniq_idx *idx;
+    struct lyd_node *iter;
+    LY_ARRAY_COUNT_TYPE u;
+    LY_ERR ret = LY_SUCCESS;
+
+    idx = calloc(1, sizeof *idx);
+    LY_CHECK_RET(!idx, LY_EMEM);
+    idx->slist = (struct lysc_node_list *)first->schema;
+    idx->next = parent->uniq_idx;
+    parent->uniq_idx = idx;
+
+    idx->uniqtables = calloc(LY_ARRAY_COUNT(idx->slist->uniques), sizeof *idx->uniqtables);
+    LY_CHECK_ERR_GOTO(!idx->uniqtables, ret = LY_EMEM, cleanup);
+    LY_ARRAY_FOR(idx->slist->uniques, u) {
+        idx->uniqtables[u] = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyd_node *), lyd_val_uniq_list_equal,
+                (void *)(uintptr_t)(u + 1L), 1);
+        LY_CHECK_ERR_GOTO(!idx->uniqtables[u], ret = LY_EMEM, cleanup);
+    }
+    idx->insts = lyht_new(LYHT_MIN_SIZE, sizeof(struct lyd_uniq_inst *), lyd_val_uniq_inst_equal, NULL, 1);
+    LY_CHECK_ERR_GOTO(!idx->insts, ret = LY_EMEM, cleanup);
+
+    /* all the instances need to be hashed */
+    LYD_LIST_FOR_INST(first, first->schema, iter) {
+        LY_CHECK_GOTO(ret = lyd_val_uniq_inst_mark(idx, iter), cleanup);
+    }
+
+cleanup:
+    if (ret) {
+        lyd_val_uniq_idx_drop(parent, idx);
+    } else {
+        *idx_p = idx;
+    }
+    return ret;
+}
+
+/**
+ * @brief Validate list unique leaves using the unique index of the list instances, see ::LY_CTX_UNIQUE_INDEX.
+ *
+ * Only the instances changed since the last validation are hashed again.
+ *
+ * @param[in] parent Data parent of the list instances.
+ * @param[in] first First sibling to search in.
+ * @param[in] snode Schema node to validate.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_unique_idx(struct lyd_node_inner *parent, const struct lyd_node *first, const struct lysc_node *snode)
+{
+    struct lyd_uniq_idx *idx;
+    struct lyd_uniq_inst *rec;
+    struct lyd_node *inst;
+    LY_ARRAY_COUNT_TYPE u;
+    LY_ERR ret = LY_SUCCESS;
+    uint32_t i, j;
+
+    idx = lyd_val_uniq_idx_find(parent, snode);
+    if (!idx) {
+        if (lyd_find_sibling_val(first, snode, NULL, 0, &inst)) {
+            /* no instances */
+            return LY_SUCCESS;
+        }
+        LY_CHECK_ERR_RET(lyd_val_uniq_idx_new(parent, inst, &idx), LOGMEM(snode->module->ctx), LY_EMEM);
+    }
+
+    /* remove the previous hashes of all the changed instances first so that they are not compared with their
+     * previous values... */
+    for (i = 0; i < idx->dirty.count; ++i) {
+        rec = idx->dirty.objs[i];
+        if (rec->inst) {
+            lyd_val_uniq_inst_unhash(idx, rec);
+        }
+    }
+
+    /* ... and then insert them with their current values */
+    for (i = j = 0; i < idx->dirty.count; ++i) {
+        rec = idx->dirty.objs[i];
+        if (!rec->inst) {
+            /* removed instance */
+            free(rec);
+            continue;
+        }
+
+        for (u = 0; !ret && (u < LY_ARRAY_COUNT(idx->slist->uniques)); ++u) {
+            if (!lyd_val_uniq_hash((const struct lysc_node_leaf **)idx->slist->uniques[u], rec->inst,
+                    &rec->uniq[u].hash)) {
+                /* skip this unique since its values are incomplete */
+                continue;
+            }
+
+            ret = lyht_insert_with_resize_cb(idx->uniqtables[u], &rec->inst, rec->uniq[u].hash, lyd_val_uniq_ptr_equal,
+                    NULL);
+            if (ret == LY_EEXIST) {
+                /* instance duplication */
+                ret = LY_EVALID;
+            } else if (!ret) {
+                rec->uniq[u].inserted = 1;
+            }
+        }
+        if (u == LY_ARRAY_COUNT(idx->slist->uniques)) {
+            /* hashed */
+            ++idx->rehashes;
+            if (!ret) {
+                rec->dirty = 0;
+                continue;
+            }
+        }
+
+        /* keep the instance for the next validation */
+        idx->dirty.objs[j++] = rec;
+    }
+    idx->dirty.count = j;
+
+    return ret;
+}
+
+/**
+ * @brief Validate list unique leaves.
+ *
+ * @param[in] first First sibling to search in.
+ * @param[in] snode Schema node to validate.
+ * @param[in] uniques List unique arrays to validate.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_unique(const struct lyd_node *first, const struct lysc_node *snode, const struct lysc_node_leaf ***uniques)
+{
+    const struct lyd_node *diter;
+    struct ly_set *set;
+    LY_ARRAY_COUNT_TYPE u, v, x = 0;
+    LY_ERR ret = LY_SUCCESS;
+    uint32_t hash, i, size = 0;
+    void *cb_data;
+    struct hash_table **uniqtables = NULL;
+    struct ly_ctx *ctx = snode->module->ctx;
+
+    assert(uniques);
+
+    if ((ctx->flags & LY_CTX_UNIQUE_INDEX) && first && first->parent) {
+        /* only the changed instances are checked */
+        return lyd_validate_unique_idx(first->parent, first, snode);
+    }
+
+    /* get all list instances */
+    LY_CHECK_RET(ly_set_new(&set));
+    LY_LIST_FOR(first, diter) {
+        if (diter->schema == snode) {
+            ret = ly_set_add(set, (void *)diter, 1, NULL);
+            LY_CHECK_GOTO(ret, cleanup);
+        }
+    }
+
+    if (set->count == 2) {
+        /* simple comparison */
+        if (lyd_val_uniq_list_equal(&set->objs[0], &set->objs[1], 0, (void *)0)) {
+            /* instance duplication */
+            ret = LY_EVALID;
+            goto cleanup;
+        }
+    } else if (set->count > 2) {
+        /* use hashes for comparison */
+        /* first, allocate the table, the size depends on number of items in the set,
+         * the following code detects number of upper zero bits in the items' counter value ... */
+        for (i = (sizeof set->count * CHAR_BIT) - 1; i > 0; i--) {
+            size = set->count << i;
+            size = size >> i;
+            if (size == set->count) {
+                break;
+            }
+        }
+        LY_CHECK_ERR_GOTO(!i, LOGINT(ctx); ret = LY_EINT, cleanup);
+        /* ... and then we convert it to the position of the highest non-zero bit ... */
+        i = (sizeof set->count * CHAR_BIT) - i;
+        /* ... and by using it to shift 1 to the left we get the closest sufficient hash table size */
+        size = 1 << i;
+
+        uniqtables = malloc(LY_ARRAY_COUNT(uniques) * sizeof *uniqtables);
+        LY_CHECK_ERR_GOTO(!uniqtables, LOGMEM(ctx); ret = LY_EMEM, cleanup);
+        x = LY_ARRAY_COUNT(uniques);
+        for (v = 0; v < x; v++) {
+            cb_data = (void *)(uintptr_t)(v + 1L);
+            uniqtables[v] = lyht_new(size, sizeof(struct lyd_node *), lyd_val_uniq_list_equal, cb_data, 0);
+            LY_CHECK_ERR_GOTO(!uniqtables[v], LOGMEM(ctx); ret = LY_EMEM, cleanup);
+        }
 
         for (i = 0; i < set->count; i++) {
             /* loop for unique - get the hash for the instances */
             for (u = 0; u < x; u++) {
-                val = NULL;
-                for (v = hash = 0; v < LY_ARRAY_COUNT(uniques[u]); v++) {
-                    diter = lyd_val_uniq_find_leaf(uniques[u][v], set->objs[i]);
-                    if (diter) {
-                        val = &((struct lyd_node_term *)diter)->value;
-                    } else {
-                        /* use default value */
-                        val = uniques[u][v]->dflt;
-                    }
-                    if (!val) {
-                        /* unique item not present nor has default value */
-                        break;
-                    }
+                if (!lyd_val_uniq_hash(uniques[u], set->objs[i], &hash)) {
+                    /* skip this list instance since its unique set is incomplete */
+                    continue;
+                }
+
+                /* insert into the hashtable */
+                ret = lyht_insert(uniqtables[u], &set->objs[i], hash, NULL);
+                if (ret == LY_EEXIST) {
+                    /* instance duplication */
+                    ret = LY_EVALID;
+                }
+                LY_CHECK_GOTO(ret != LY_SUCCESS, cleanup);
+            }
+        }
+    }
+
+cleanup:
+    ly_set_free(set, NULL);
+    for (v = 0; v < x; v++) {
+        if (!uniqtables[v]) {
+            /* failed when allocating uniquetables[j], following j are not allocated */
+            break;
+        }
+        lyht_free(uniqtables[v]);
+    }
+    free(uniqtables);
+
+    return ret;
+}
+
+/**
+ * @brief Validate data siblings based on generic schema node restrictions, recursively for schema-only nodes.
+ *
+ * @param[in] first First sibling to search in.
+ * @param[in] parent Data parent.
+ * @param[in] sparent Schema parent of the nodes to check.
+ * @param[in] mod Module of the nodes to check.
+ * @param[in] val_opts Validation options, see @ref datavalidationoptions.
+ * @param[in] int_opts Internal parser options.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_siblings_schema_r(const struct lyd_node *first, const struct lyd_node *parent,
+        const struct lysc_node *sparent, const struct lysc_module *mod, uint32_t val_opts, uint32_t int_opts)
+{
+    LY_ERR ret = LY_SUCCESS;
+    const struct lysc_node *snode = NULL, *scase;
+    struct lysc_node_list *slist;
+    struct lysc_node_leaflist *sllist;
+    uint32_t getnext_opts;
+
+    getnext_opts = LYS_GETNEXT_WITHCHOICE | (int_opts & LYD_INTOPT_REPLY ? LYS_GETNEXT_OUTPUT : 0);
+
+    /* disabled nodes are skipped by lys_getnext */
+    while ((snode = lys_getnext(snode, sparent, mod, getnext_opts))) {
+        if ((val_opts & LYD_VALIDATE_NO_STATE) && (snode->flags & LYS_CONFIG_R)) {
+            continue;
+        }
+
+        LOG_LOCSET(snode, NULL, NULL, NULL);
+
+        /* check min-elements and max-elements */
+        if (snode->nodetype == LYS_LIST) {
+            slist = (struct lysc_node_list *)snode;
+            if (slist->min || slist->max) {
+                ret = lyd_validate_minmax(first, parent, snode, slist->min, slist->max);
+                LY_CHECK_GOTO(ret, error);
+            }
+        } else if (snode->nodetype == LYS_LEAFLIST) {
+            sllist = (struct lysc_node_leaflist *)snode;
+            if (sllist->min || sllist->max) {
+                ret = lyd_validate_minmax(first, parent, snode, sllist->min, sllist->max);
+                LY_CHECK_GOTO(ret, error);
+            }
+
+        } else if (snode->flags & LYS_MAND_TRUE) {
+            /* check generic mandatory existence */
+            ret = lyd_validate_mandatory(first, parent, snode);
+            LY_CHECK_GOTO(ret, error);
+        }
+
+        /* check unique */
+        if (snode->nodetype == LYS_LIST) {
+            slist = (struct lysc_node_list *)snode;
+            if (slist->uniques) {
+                ret = lyd_validate_unique(first, snode, (const struct lysc_node_leaf ***)slist->uniques);
+                LY_CHECK_GOTO(ret, error);
+            }
+        }
+
+        if (snode->nodetype == LYS_CHOICE) {
+            /* find the existing case, if any */
+            LY_LIST_FOR(lysc_node_child(snode), scase) {
+                if (lys_getnext_data(NULL, first, NULL, scase, NULL)) {
+                    /* validate only this case */
+                    ret = lyd_validate_siblings_schema_r(first, parent, scase, mod, val_opts, int_opts);
+                    LY_CHECK_GOTO(ret, error);
+                    break;
+                }
+            }
+        }
+
+        LOG_LOCBACK(1, 0, 0, 0);
+    }
+
+    return LY_SUCCESS;
+
+error:
+    LOG_LOCBACK(1, 0, 0, 0);
+    return ret;
+}
+
+/**
+ * @brief Validate obsolete nodes, only warnings are printed.
+ *
+ * @param[in] node Node to check.
+ */
+static void
+lyd_validate_obsolete(const struct lyd_node *node)
+{
+    const struct lysc_node *snode;
+
+    snode = node->schema;
+    do {
+        if (snode->flags & LYS_STATUS_OBSLT) {
+            LOGWRN(snode->module->ctx, "Obsolete schema node \"%s\" instantiated in data.", snode->name);
+            break;
+        }
+
+        snode = snode->parent;
+    } while (snode && (snode->nodetype & (LYS_CHOICE | LYS_CASE)));
+}
+
+/**
+ * @brief Validate must conditions of a data node.
+ *
+ * @param[in] node Node to validate.
+ * @param[in] int_opts Internal parser options.
+ * @param[in,out] cache Cache of condition results.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_must(const struct lyd_node *node, uint32_t int_opts, struct hash_table **cache)
+{
+    LY_ERR ret;
+    ly_bool result;
+    struct lysc_must *musts;
+    const struct lyd_node *tree;
+    const struct lysc_node *schema;
+    const char *emsg, *eapptag;
+    LY_ARRAY_COUNT_TYPE u;
+
+    assert((int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_REPLY)) != (LYD_INTOPT_RPC | LYD_INTOPT_REPLY));
+    assert((int_opts & (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY)) != (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY));
+
+    if (node->schema->nodetype & (LYS_ACTION | LYS_RPC)) {
+        if (int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_ACTION)) {
+            schema = &((struct lysc_node_action *)node->schema)->input.node;
+        } else if (int_opts & LYD_INTOPT_REPLY) {
+            schema = &((struct lysc_node_action *)node->schema)->output.node;
+        } else {
+            LOGINT_RET(LYD_CTX(node));
+        }
+    } else {
+        schema = node->schema;
+    }
+    musts = lysc_node_musts(schema);
+    if (!musts) {
+        /* no must to evaluate */
+        return LY_SUCCESS;
+    }
+
+    /* find first top-level node */
+    for (tree = node; tree->parent; tree = lyd_parent(tree)) {}
+    tree = lyd_first_sibling(tree);
+
+    LY_ARRAY_FOR(musts, u) {
+        /* evaluate must */
+        ret = lyd_validate_cond(musts[u].cond, musts[u].prefixes, node->schema, node, tree, cache, &result);
+        if (ret == LY_EINCOMPLETE) {
+            LOGINT_RET(LYD_CTX(node));
+        } else if (ret) {
+            return ret;
+        }
+
+        /* check the result */
+        if (!result) {
+            /* use specific error information */
+            emsg = musts[u].emsg;
+            eapptag = musts[u].eapptag ? musts[u].eapptag : "must-violation";
+            if (emsg) {
+                LOGVAL_APPTAG(LYD_CTX(node), eapptag, LYVE_DATA, "%s", emsg);
+            } else {
+                LOGVAL_APPTAG(LYD_CTX(node), eapptag, LY_VCODE_NOMUST, musts[u].cond->expr);
+            }
+            return LY_EVALID;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Validate restrictions of a data node itself, the data tree must be final when calling this function.
+ *
+ * @param[in] node Node to validate.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[in] int_opts Internal parser options.
+ * @param[in,out] cache Cache of condition results.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_final_node(const struct lyd_node *node, uint32_t val_opts, uint32_t int_opts, struct hash_table **cache)
+{
+    LY_ERR ret = LY_SUCCESS;
+    const char *innode = NULL;
+
+    LOG_LOCSET(node->schema, node, NULL, NULL);
+
+    /* opaque data */
+    if (!node->schema) {
+        LOGVAL(LYD_CTX(node), LYVE_DATA, "Invalid opaque node \"%s\" found.", ((struct lyd_node_opaq *)node)->name.name);
+        LOG_LOCBACK(0, 1, 0, 0);
+        return LY_EVALID;
+    }
+
+    /* no state/input/output data */
+    if ((val_opts & LYD_VALIDATE_NO_STATE) && (node->schema->flags & LYS_CONFIG_R)) {
+        innode = "state";
+        goto unexpected_node;
+    } else if ((int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_ACTION)) && (node->schema->flags & LYS_IS_OUTPUT)) {
+        innode = "output";
+        goto unexpected_node;
+    } else if ((int_opts & LYD_INTOPT_REPLY) && (node->schema->flags & LYS_IS_INPUT)) {
+        innode = "input";
+        goto unexpected_node;
+    }
+
+    /* obsolete data */
+    lyd_validate_obsolete(node);
+
+    /* node's musts */
+    ret = lyd_validate_must(node, int_opts, cache);
+
+    /* node value was checked by plugins */
+
+    LOG_LOCBACK(1, 1, 0, 0);
+    return ret;
+
+unexpected_node:
+    LOGVAL(LYD_CTX(node), LY_VCODE_UNEXPNODE, innode, node->schema->name);
+    LOG_LOCBACK(1, 1, 0, 0);
+    return LY_EVALID;
+}
+
+/**
+ * @brief Set the default flag of a non-presence container with only default children.
+ *
+ * @param[in] node Node to update.
+ */
+static void
+lyd_validate_np_cont_dflt(struct lyd_node *node)
+{
+    struct lyd_node *child;
+
+    if (!node->schema || (node->schema->nodetype != LYS_CONTAINER) || (node->schema->flags & LYS_PRESENCE)) {
+        return;
+    }
+
+    LY_LIST_FOR(lyd_child(node), child) {
+        if (!(child->flags & LYD_DEFAULT)) {
+            return;
+        }
+    }
+    node->flags |= LYD_DEFAULT;
+}
+
+/**
+ * @brief Perform all remaining validation tasks, the data tree must be final when calling this function.
+ *
+ * @param[in] first First sibling.
+ * @param[in] parent Data parent.
+ * @param[in] sparent Schema parent of the siblings, NULL for top-level siblings.
+ * @param[in] mod Module of the siblings, NULL for nested siblings.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[in] int_opts Internal parser options.
+ * @param[in,out] cache Cache of condition results.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_final_r(struct lyd_node *first, const struct lyd_node *parent, const struct lysc_node *sparent,
+        const struct lys_module *mod, uint32_t val_opts, uint32_t int_opts, struct hash_table **cache)
+{
+    struct lyd_node *node;
+
+    /* validate all restrictions of nodes themselves */
+    LY_LIST_FOR(first, node) {
+        if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
+            /* all top-level data from this module checked */
+            break;
+        }
+
+        LY_CHECK_RET(lyd_validate_final_node(node, val_opts, int_opts, cache));
+    }
+
+    /* validate schema-based restrictions */
+    LY_CHECK_RET(lyd_validate_siblings_schema_r(first, parent, sparent, mod ? mod->compiled : NULL, val_opts, int_opts));
+
+    LY_LIST_FOR(first, node) {
+        if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
+            /* all top-level data from this module checked */
+            break;
+        }
+
+        /* validate all children recursively */
+        LY_CHECK_RET(lyd_validate_final_r(lyd_child(node), node, node->schema, NULL, val_opts, int_opts, cache));
+
+        /* set default for containers */
+        lyd_validate_np_cont_dflt(node);
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Validate the whole data subtree.
+ *
+ * @param[in] root Subtree root.
+ * @param[in,out] node_when Set for nodes with when conditions.
+ * @param[in,out] node_exts Set for nodes and extension instances with validation plugin callback.
+ * @param[in,out] node_types Set for unres node types.
+ * @param[in,out] meta_types Set for unres metadata types.
+ * @param[in] impl_opts Implicit options, see @ref implicitoptions.
+ * @param[in,out] diff Validation diff.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_validate_subtree(struct lyd_node *root, struct ly_set *node_when, struct ly_set *node_exts, struct ly_set *node_types,
+        struct ly_set *meta_types, uint32_t impl_opts, struct lyd_node **diff)
+{
+    const struct lyd_meta *meta;
+    struct lyd_node *node;
+
+    LYD_TREE_DFS_BEGIN(root, node) {
+        if (!node->schema) {
+            goto next_node;
+        }
+
+        LY_LIST_FOR(node->meta, meta) {
+            if ((*(const struct lysc_type **)meta->annotation->substmts[ANNOTATION_SUBSTMT_TYPE].storage)->plugin->validate) {
+                /* metadata type resolution */
+                LY_CHECK_RET(ly_set_add(meta_types, (void *)meta, 1, NULL));
+            }
+        }
+
+        if ((node->schema->nodetype & LYD_NODE_TERM) && ((struct lysc_node_leaf *)node->schema)->type->plugin->validate) {
+            /* node type resolution */
+            LY_CHECK_RET(ly_set_add(node_types, (void *)node, 1, NULL));
+        } else if (node->schema->nodetype & LYD_NODE_INNER) {
+            /* new node validation, autodelete */
+            LY_CHECK_RET(lyd_validate_new(lyd_node_child_p(node), node->schema, NULL, diff));
+
+            /* add nested defaults */
+            LY_CHECK_RET(lyd_new_implicit_r(node, lyd_node_child_p(node), NULL, NULL, NULL, NULL, NULL, impl_opts, diff));
+        }
+
+        if (lysc_has_when(node->schema)) {
+            /* when evaluation */
+            LY_CHECK_RET(ly_set_add(node_when, (void *)node, 1, NULL));
+        }
+        LY_CHECK_RET(lysc_node_ext_tovalidate(node_exts, node));
+
+next_node:
+        LYD_TREE_DFS_END(root, node);
+    }
+
+    return LY_SUCCESS;
+}
+
+LY_ERR
+lyd_validate(struct lyd_node **tree, const struct lys_module *module, const struct ly_ctx *ctx, uint32_t val_opts,
+        ly_bool validate_subtree, struct ly_set *node_when_p, struct ly_set *node_exts_p,
+        struct ly_set *node_types_p, struct ly_set *meta_types_p, struct lyd_node **diff)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct lyd_node *first, *next, **first2, *iter;
+    const struct lys_module *mod;
+    struct ly_set node_types = {0}, meta_types = {0}, node_when = {0}, node_exts = {0};
+    struct hash_table *cache = NULL;
+    uint32_t i = 0;
+
+    assert(tree && ctx);
+    assert((node_when_p && node_exts_p && node_types_p && meta_types_p) ||
+            (!node_when_p && !node_exts_p && !node_types_p && !meta_types_p));
+
+    if (!node_when_p) {
+        node_when_p = &node_when;
+        node_exts_p = &node_exts;
+        node_types_p = &node_types;
+        meta_types_p = &meta_types;
+    }
+
+    next = *tree;
+    while (1) {
+        if (val_opts & LYD_VALIDATE_PRESENT) {
+            mod = lyd_data_next_module(&next, &first);
+        } else {
+            mod = lyd_mod_next_module(next, module, ctx, &i, &first);
+        }
+        if (!mod) {
+            break;
+        }
+        if (!first || (first == *tree)) {
+            /* make sure first2 changes are carried to tree */
+            first2 = tree;
+        } else {
+            first2 = &first;
+        }
+
+        /* validate new top-level nodes of this module, autodelete */
+        ret = lyd_validate_new(first2, NULL, mod, diff);
+        LY_CHECK_GOTO(ret, cleanup);
+
+        /* add all top-level defaults for this module, if going to validate subtree, do not add into unres sets
+         * (lyd_validate_subtree() adds all the nodes in that case) */
+        ret = lyd_new_implicit_r(NULL, first2, NULL, mod, validate_subtree ? NULL : node_when_p, validate_subtree ? NULL : node_exts_p,
+                validate_subtree ? NULL : node_types_p, (val_opts & LYD_VALIDATE_NO_STATE) ? LYD_IMPLICIT_NO_STATE : 0, diff);
+        LY_CHECK_GOTO(ret, cleanup);
+
+        /* our first module node pointer may no longer be the first */
+        first = *first2;
+        lyd_first_module_sibling(&first, mod);
+        if (!first || (first == *tree)) {
+            first2 = tree;
+        } else {
+            first2 = &first;
+        }
+
+        if (validate_subtree) {
+            /* process nested nodes */
+            LY_LIST_FOR(*first2, iter) {
+                if (lyd_owner_module(iter) != mod) {
+                    break;
+                }
+
+                ret = lyd_validate_subtree(iter, node_when_p, node_exts_p, node_types_p, meta_types_p,
+                        (val_opts & LYD_VALIDATE_NO_STATE) ? LYD_IMPLICIT_NO_STATE : 0, diff);
+                LY_CHECK_GOTO(ret, cleanup);
+            }
+        }
+
+        /* finish incompletely validated terminal values/attributes and when conditions */
+        ret = lyd_validate_unres(first2, mod, val_opts, node_when_p, node_exts_p, node_types_p, meta_types_p, diff);
+        LY_CHECK_GOTO(ret, cleanup);
+
+        /* perform final validation that assumes the data tree is final */
+        ret = lyd_validate_final_r(*first2, NULL, NULL, mod, val_opts, 0, &cache);
+        lyht_free(cache);
+        cache = NULL;
+        LY_CHECK_GOTO(ret, cleanup);
+    }
+
+cleanup:
+    ly_set_erase(&node_when, NULL);
+    ly_set_erase(&node_exts, NULL);
+    ly_set_erase(&node_types, NULL);
+    ly_set_erase(&meta_types, NULL);
+    return ret;
+}
+
+API LY_ERR
+lyd_validate_all(struct lyd_node **tree, const struct ly_ctx *ctx, uint32_t val_opts, struct lyd_node **diff)
+{
+    LY_CHECK_ARG_RET(NULL, tree, *tree || ctx, LY_EINVAL);
+    if (!ctx) {
+        ctx = LYD_CTX(*tree);
+    }
+    if (diff) {
+        *diff = NULL;
+    }
+
+    return lyd_validate(tree, NULL, ctx, val_opts, 1, NULL, NULL, NULL, NULL, diff);
+}
+
+API LY_ERR
+lyd_validate_module(struct lyd_node **tree, const struct lys_module *module, uint32_t val_opts, struct lyd_node **diff)
+{
+    LY_CHECK_ARG_RET(NULL, tree, *tree || module, LY_EINVAL);
+    if (diff) {
+        *diff = NULL;
+    }
+
+    return lyd_validate(tree, module, (*tree) ? LYD_CTX(*tree) : module->ctx, val_opts, 1, NULL, NULL, NULL, NULL, diff);
+}
+
+/**
+ * @brief Incremental validation context, see ::lyd_validate_diff().
+ */
+struct lyd_val_diff_ctx {
+    struct ly_set snodes;       /**< changed schema nodes */
+    struct ly_set parents;      /**< data parents whose children restrictions are to be validated */
+    struct ly_set mods;         /**< modules whose top-level restrictions are to be validated */
+    struct ly_set roots;        /**< changed subtrees to be validated whole */
+    struct ly_set ancestors;    /**< all the ancestors of the changed subtrees */
+    struct ly_set uniques;      /**< first list instances whose unique restrictions were validated */
+    struct ly_set musts;        /**< nodes with must restrictions depending on the changes */
+    struct ly_set node_when;    /**< nodes with when conditions to evaluate */
+    struct ly_set node_exts;    /**< nodes and extension instances with validation plugin callback */
+    struct ly_set node_types;   /**< nodes with types to resolve */
+    struct ly_set meta_types;   /**< metadata with types to resolve */
+
+    struct hash_table *parents_ht;      /**< hash table of parents */
+    struct hash_table *roots_ht;        /**< hash table of roots */
+    struct hash_table *ancestors_ht;    /**< hash table of ancestors */
+    struct hash_table *uniques_ht;      /**< hash table of uniques */
+    struct hash_table *when_ht;         /**< hash table of node_when */
+    struct hash_table *types_ht;        /**< hash table of node_types */
+};
+
+/**
+ * @brief Compare data nodes by their depth so that the deepest nodes are sorted first.
+ *
+ * Implementation of qsort compar callback.
+ */
+static int
+lyd_val_diff_depth_cmp(const void *ptr1, const void *ptr2)
+{
+    const struct lyd_node *node1 = *(const struct lyd_node **)ptr1, *node2 = *(const struct lyd_node **)ptr2;
+    uint32_t depth1 = 0, depth2 = 0;
+
+    for ( ; node1; node1 = lyd_parent(node1)) {
+        ++depth1;
+    }
+    for ( ; node2; node2 = lyd_parent(node2)) {
+        ++depth2;
+    }
+
+    return (depth1 < depth2) - (depth1 > depth2);
+}
+
+/**
+ * @brief Check whether a schema node referenced by an expression may be affected by the changed schema nodes.
+ *
+ * @param[in] atom Referenced schema node.
+ * @param[in] val Whether the value of @p atom is used.
+ * @param[in] changed Set of changed schema nodes.
+ * @return Whether the expression depends on the changes.
+ */
+static ly_bool
+lyd_val_diff_atom_match(const struct lysc_node *atom, ly_bool val, const struct ly_set *changed)
+{
+    const struct lysc_node *iter;
+    uint32_t i;
+
+    for (i = 0; i < changed->count; ++i) {
+        /* the changed node itself or any of its descendants is referenced */
+        for (iter = atom; iter; iter = iter->parent) {
+            if (iter == changed->snodes[i]) {
+                return 1;
+            }
+        }
 
-                    /* get hash key */
-                    hash_key = val->realtype->plugin->print(NULL, val, LY_VALUE_LYB, NULL, &dyn, &key_len);
-                    hash = dict_hash_multi(hash, hash_key, key_len);
-                    if (dyn) {
-                        free((void *)hash_key);
-                    }
-                }
-                if (!val) {
-                    /* skip this list instance since its unique set is incomplete */
-                    continue;
+        if (val) {
+            /* value of an ancestor of the changed node is used */
+            for (iter = changed->snodes[i]->parent; iter; iter = iter->parent) {
+                if (iter == atom) {
+                    return 1;
                 }
+            }
+        }
+    }
 
-                /* finish the hash value */
-                hash = dict_hash_multi(hash, NULL, 0);
+    return 0;
+}
 
-                /* insert into the hashtable */
-                ret = lyht_insert(uniqtables[u], &set->objs[i], hash, NULL);
-                if (ret == LY_EEXIST) {
-                    /* instance duplication */
-                    ret = LY_EVALID;
-                }
-                LY_CHECK_GOTO(ret != LY_SUCCESS, cleanup);
+/**
+ * @brief Check whether an expression of a when or must may depend on the changed schema nodes.
+ *
+ * @param[in] exp Expression with learned atoms, see ::lyxp_expr_set_atoms().
+ * @param[in] changed Set of changed schema nodes.
+ * @param[out] self Optional, set if the expression depends on the changes only through its own context node.
+ * @return Whether the expression depends on the changes.
+ */
+static ly_bool
+lyd_val_diff_expr_match(const struct lyxp_expr *exp, const struct ly_set *changed, ly_bool *self)
+{
+    LY_ARRAY_COUNT_TYPE u;
+    ly_bool match = 0;
+
+    if (self) {
+        *self = 1;
+    }
+
+    if (!exp->atomized) {
+        /* unknown dependencies */
+        goto match_any;
+    }
+
+    LY_ARRAY_FOR(exp->atoms, u) {
+        if (lyd_val_diff_atom_match(exp->atoms[u].scnode, exp->atoms[u].val, changed)) {
+            if (!exp->atoms[u].self) {
+                goto match_any;
             }
+            match = 1;
         }
     }
 
-cleanup:
-    ly_set_free(set, NULL);
-    for (v = 0; v < x; v++) {
-        if (!uniqtables[v]) {
-            /* failed when allocating uniquetables[j], following j are not allocated */
-            break;
+    return match;
+
+match_any:
+    if (self) {
+        *self = 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Check whether validation of a value of a type may depend on other data.
+ *
+ * @param[in] type Type to check.
+ * @return Whether the value validation may depend on other data.
+ */
+static ly_bool
+lyd_val_diff_type_refs(const struct lysc_type *type)
+{
+    struct lysc_type **types;
+    LY_ARRAY_COUNT_TYPE u;
+
+    if (!type->plugin->validate) {
+        return 0;
+    } else if (type->plugin->validate == lyplg_type_validate_leafref) {
+        return ((struct lysc_type_leafref *)type)->require_instance;
+    } else if (type->plugin->validate == lyplg_type_validate_union) {
+        types = ((struct lysc_type_union *)type)->types;
+        LY_ARRAY_FOR(types, u) {
+            if (lyd_val_diff_type_refs(types[u])) {
+                return 1;
+            }
         }
-        lyht_free(uniqtables[v]);
+        return 0;
     }
-    free(uniqtables);
 
-    return ret;
+    /* instance-identifier or a custom validation */
+    return 1;
 }
 
 /**
- * @brief Validate data siblings based on generic schema node restrictions, recursively for schema-only nodes.
+ * @brief Check whether validation of a value of a type may depend on the changed schema nodes.
  *
- * @param[in] first First sibling to search in.
- * @param[in] parent Data parent.
- * @param[in] sparent Schema parent of the nodes to check.
- * @param[in] mod Module of the nodes to check.
- * @param[in] val_opts Validation options, see @ref datavalidationoptions.
- * @param[in] int_opts Internal parser options.
+ * @param[in] snode Term schema node with the type.
+ * @param[in] type Type to check.
+ * @param[in] changed Set of changed schema nodes.
+ * @param[out] match Whether the value validation depends on the changes.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_validate_siblings_schema_r(const struct lyd_node *first, const struct lyd_node *parent,
-        const struct lysc_node *sparent, const struct lysc_module *mod, uint32_t val_opts, uint32_t int_opts)
+lyd_val_diff_type_match(const struct lysc_node *snode, const struct lysc_type *type, const struct ly_set *changed,
+        ly_bool *match)
 {
     LY_ERR ret = LY_SUCCESS;
-    const struct lysc_node *snode = NULL, *scase;
-    struct lysc_node_list *slist;
-    struct lysc_node_leaflist *sllist;
-    uint32_t getnext_opts;
+    struct lysc_type_leafref *lref;
+    struct lysc_type **types;
+    struct lyxp_set set;
+    LY_ARRAY_COUNT_TYPE u;
+    uint32_t i;
 
-    getnext_opts = LYS_GETNEXT_WITHCHOICE | (int_opts & LYD_INTOPT_REPLY ? LYS_GETNEXT_OUTPUT : 0);
+    *match = 0;
+    memset(&set, 0, sizeof set);
 
-    /* disabled nodes are skipped by lys_getnext */
-    while ((snode = lys_getnext(snode, sparent, mod, getnext_opts))) {
-        if ((val_opts & LYD_VALIDATE_NO_STATE) && (snode->flags & LYS_CONFIG_R)) {
-            continue;
-        }
+    if (!lyd_val_diff_type_refs(type)) {
+        /* no references */
+        return LY_SUCCESS;
+    }
 
-        LOG_LOCSET(snode, NULL, NULL, NULL);
+    if (type->plugin->validate == lyplg_type_validate_leafref) {
+        /* the target path must not reference any changed node */
+        lref = (struct lysc_type_leafref *)type;
+        ret = lyxp_atomize(snode->module->ctx, lref->path, snode->module, LY_VALUE_SCHEMA_RESOLVED, lref->prefixes,
+                snode, &set, LYXP_SCNODE);
+        LY_CHECK_GOTO(ret, cleanup);
 
-        /* check min-elements and max-elements */
-        if (snode->nodetype == LYS_LIST) {
-            slist = (struct lysc_node_list *)snode;
-            if (slist->min || slist->max) {
-                ret = lyd_validate_minmax(first, parent, snode, slist->min, slist->max);
-                LY_CHECK_GOTO(ret, error);
+        for (i = 0; (i < set.used) && !*match; ++i) {
+            if ((set.val.scnodes[i].type == LYXP_NODE_ELEM) && (set.val.scnodes[i].in_ctx != LYXP_SET_SCNODE_START) &&
+                    (set.val.scnodes[i].in_ctx != LYXP_SET_SCNODE_START_USED)) {
+                *match = lyd_val_diff_atom_match(set.val.scnodes[i].scnode,
+                        set.val.scnodes[i].in_ctx == LYXP_SET_SCNODE_ATOM_VAL, changed);
             }
-        } else if (snode->nodetype == LYS_LEAFLIST) {
-            sllist = (struct lysc_node_leaflist *)snode;
-            if (sllist->min || sllist->max) {
-                ret = lyd_validate_minmax(first, parent, snode, sllist->min, sllist->max);
-                LY_CHECK_GOTO(ret, error);
+        }
+    } else if (type->plugin->validate == lyplg_type_validate_union) {
+        types = ((struct lysc_type_union *)type)->types;
+        LY_ARRAY_FOR(types, u) {
+            LY_CHECK_RET(lyd_val_diff_type_match(snode, types[u], changed, match));
+            if (*match) {
+                break;
             }
+        }
+    } else {
+        /* may depend on any node */
+        *match = 1;
+    }
 
-        } else if (snode->flags & LYS_MAND_TRUE) {
-            /* check generic mandatory existence */
-            ret = lyd_validate_mandatory(first, parent, snode);
-            LY_CHECK_GOTO(ret, error);
+cleanup:
+    lyxp_set_free_content(&set);
+    return ret;
+}
+
+/**
+ * @brief Collect all the data instances of a schema node.
+ *
+ * @param[in] tree Any top-level data sibling.
+ * @param[in] snode Schema node, for a choice or case the instances of all its data nodes are collected.
+ * @param[in,out] set Set to add the instances into.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_diff_instances(const struct lyd_node *tree, const struct lysc_node *snode, struct ly_set *set)
+{
+    LY_ERR ret = LY_SUCCESS;
+    struct ly_set parents = {0};
+    const struct lysc_node *sparent;
+    struct lyd_node *match;
+    uint32_t i;
+
+    if (snode->nodetype & (LYS_CHOICE | LYS_CASE)) {
+        LY_LIST_FOR(lysc_node_child(snode), sparent) {
+            LY_CHECK_RET(lyd_val_diff_instances(tree, sparent, set));
         }
+        return LY_SUCCESS;
+    }
 
-        /* check unique */
-        if (snode->nodetype == LYS_LIST) {
-            slist = (struct lysc_node_list *)snode;
-            if (slist->uniques) {
-                ret = lyd_validate_unique(first, snode, (const struct lysc_node_leaf ***)slist->uniques);
-                LY_CHECK_GOTO(ret, error);
-            }
+    sparent = lysc_data_parent(snode);
+    if (!sparent) {
+        /* top-level instances */
+        LYD_LIST_FOR_INST(lyd_first_sibling(tree), snode, match) {
+            LY_CHECK_RET(ly_set_add(set, match, 1, NULL));
         }
+        return LY_SUCCESS;
+    }
 
-        if (snode->nodetype == LYS_CHOICE) {
-            /* find the existing case, if any */
-            LY_LIST_FOR(lysc_node_child(snode), scase) {
-                if (lys_getnext_data(NULL, first, NULL, scase, NULL)) {
-                    /* validate only this case */
-                    ret = lyd_validate_siblings_schema_r(first, parent, scase, mod, val_opts, int_opts);
-                    LY_CHECK_GOTO(ret, error);
-                    break;
-                }
-            }
+    /* instances in all the parent instances */
+    LY_CHECK_RET(lyd_val_diff_instances(tree, sparent, &parents));
+    for (i = 0; i < parents.count; ++i) {
+        LYD_LIST_FOR_INST(lyd_child(parents.dnodes[i]), snode, match) {
+            ret = ly_set_add(set, match, 1, NULL);
+            LY_CHECK_GOTO(ret, cleanup);
         }
+    }
 
-        LOG_LOCBACK(1, 0, 0, 0);
+cleanup:
+    ly_set_erase(&parents, NULL);
+    return ret;
+}
+
+/**
+ * @brief Get the first top-level data sibling of a module to validate.
+ *
+ * @param[in] tree Data tree.
+ * @param[in] mod Module of the siblings.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[out] first First sibling of @p mod, if any.
+ * @return Pointer to the first sibling to be modified, NULL if the module data are not validated.
+ */
+static struct lyd_node **
+lyd_val_diff_mod_first(struct lyd_node **tree, const struct lys_module *mod, uint32_t val_opts, struct lyd_node **first)
+{
+    *first = *tree;
+    lyd_first_module_sibling(first, mod);
+    if ((!*first || (lyd_owner_module(*first) != mod)) && (val_opts & LYD_VALIDATE_PRESENT)) {
+        /* no data of this module */
+        return NULL;
     }
 
-    return LY_SUCCESS;
+    return (!*first || (*first == *tree)) ? tree : first;
+}
 
-error:
-    LOG_LOCBACK(1, 0, 0, 0);
-    return ret;
+/**
+ * @brief Check whether instances of a schema node may be created implicitly.
+ *
+ * @param[in] snode Schema node to check.
+ * @return Whether @p snode is a default leaf or leaf-list, NP container, choice with a default case, or a default case.
+ */
+static ly_bool
+lyd_val_diff_is_implicit(const struct lysc_node *snode)
+{
+    switch (snode->nodetype) {
+    case LYS_CONTAINER:
+        return !(snode->flags & LYS_PRESENCE);
+    case LYS_LEAF:
+        return ((struct lysc_node_leaf *)snode)->dflt ? 1 : 0;
+    case LYS_LEAFLIST:
+        return ((struct lysc_node_leaflist *)snode)->dflts ? 1 : 0;
+    case LYS_CHOICE:
+        return ((struct lysc_node_choice *)snode)->dflt ? 1 : 0;
+    case LYS_CASE:
+        return (((struct lysc_node_choice *)snode->parent)->dflt == (struct lysc_node_case *)snode) ? 1 : 0;
+    default:
+        return 0;
+    }
 }
 
 /**
- * @brief Validate obsolete nodes, only warnings are printed.
+ * @brief Create implicit instances of a schema node whose when condition depends on the changes, they may not
+ * have existed before. The created nodes are added for validation.
  *
- * @param[in] node Node to check.
+ * @param[in,out] tree Data tree.
+ * @param[in] snode Schema node that may be implicit, see ::lyd_val_diff_is_implicit().
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[in,out] vctx Incremental validation context.
+ * @param[in,out] diff Validation diff.
+ * @return LY_ERR value.
  */
-static void
-lyd_validate_obsolete(const struct lyd_node *node)
+static LY_ERR
+lyd_val_diff_implicit(struct lyd_node **tree, const struct lysc_node *snode, uint32_t val_opts,
+        struct lyd_val_diff_ctx *vctx, struct lyd_node **diff)
 {
-    const struct lysc_node *snode;
+    LY_ERR ret = LY_SUCCESS;
+    struct ly_set parents = {0}, node_when = {0}, node_types = {0};
+    const struct lysc_node *sparent;
+    struct lyd_node *node, *first, **first2;
+    uint32_t i, impl_opts;
 
-    snode = node->schema;
-    do {
-        if (snode->flags & LYS_STATUS_OBSLT) {
-            LOGWRN(snode->module->ctx, "Obsolete schema node \"%s\" instantiated in data.", snode->name);
-            break;
+    impl_opts = (val_opts & LYD_VALIDATE_NO_STATE) ? LYD_IMPLICIT_NO_STATE : 0;
+
+    sparent = lysc_data_parent(snode);
+    if (sparent && (sparent->nodetype == LYS_CONTAINER) && !(sparent->flags & LYS_PRESENCE)) {
+        /* the NP container parents may be missing as well */
+        LY_CHECK_RET(lyd_val_diff_implicit(tree, sparent, val_opts, vctx, diff));
+    }
+
+    if (sparent) {
+        /* implicit children of all the parent instances */
+        LY_CHECK_GOTO(ret = lyd_val_diff_instances(*tree, sparent, &parents), cleanup);
+        for (i = 0; i < parents.count; ++i) {
+            node = parents.dnodes[i];
+            ret = lyd_new_implicit_r(node, lyd_node_child_p(node), NULL, NULL, &node_when, &vctx->node_exts,
+                    &node_types, impl_opts, diff);
+            LY_CHECK_GOTO(ret, cleanup);
+
+            LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->parents, &vctx->parents_ht, node), cleanup);
+            LY_LIST_FOR(lyd_child(node), first) {
+                if (first->flags & LYD_DEFAULT) {
+                    LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->roots, &vctx->roots_ht, first), cleanup);
+                }
+            }
         }
+    } else if ((first2 = lyd_val_diff_mod_first(tree, snode->module, val_opts, &first))) {
+        /* top-level implicit nodes of the module */
+        ret = lyd_new_implicit_r(NULL, first2, NULL, snode->module, &node_when, &vctx->node_exts, &node_types,
+                impl_opts, diff);
+        LY_CHECK_GOTO(ret, cleanup);
 
-        snode = snode->parent;
-    } while (snode && (snode->nodetype & (LYS_CHOICE | LYS_CASE)));
+        LY_CHECK_GOTO(ret = ly_set_add(&vctx->mods, snode->module, 0, NULL), cleanup);
+        lyd_val_diff_mod_first(tree, snode->module, val_opts, &first);
+        for (node = first; node && (lyd_owner_module(node) == snode->module); node = node->next) {
+            if (node->flags & LYD_DEFAULT) {
+                LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->roots, &vctx->roots_ht, node), cleanup);
+            }
+        }
+    }
+
+    /* the created nodes must not be added twice */
+    for (i = 0; i < node_when.count; ++i) {
+        LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->node_when, &vctx->when_ht, node_when.objs[i]), cleanup);
+    }
+    for (i = 0; i < node_types.count; ++i) {
+        LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->node_types, &vctx->types_ht, node_types.objs[i]), cleanup);
+    }
+
+cleanup:
+    ly_set_erase(&parents, NULL);
+    ly_set_erase(&node_when, NULL);
+    ly_set_erase(&node_types, NULL);
+    return ret;
 }
 
 /**
- * @brief Validate must conditions of a data node.
+ * @brief Collect data nodes with restrictions of a schema node that depend on the changes.
  *
- * @param[in] node Node to validate.
- * @param[in] int_opts Internal parser options.
+ * @param[in,out] tree Data tree.
+ * @param[in] snode Schema node to check.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[in,out] vctx Incremental validation context.
+ * @param[in,out] diff Validation diff.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_validate_must(const struct lyd_node *node, uint32_t int_opts)
+lyd_val_diff_node_deps(struct lyd_node **tree, const struct lysc_node *snode, uint32_t val_opts,
+        struct lyd_val_diff_ctx *vctx, struct lyd_node **diff)
 {
-    LY_ERR ret;
-    struct lyxp_set xp_set;
+    LY_ERR ret = LY_SUCCESS;
+    struct ly_set inst = {0};
+    struct lysc_when **whens;
     struct lysc_must *musts;
-    const struct lyd_node *tree;
-    const struct lysc_node *schema;
-    const char *emsg, *eapptag;
+    const struct lysc_node *sparent;
     LY_ARRAY_COUNT_TYPE u;
+    ly_bool match = 0, self, must_self;
+    uint32_t i;
 
-    assert((int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_REPLY)) != (LYD_INTOPT_RPC | LYD_INTOPT_REPLY));
-    assert((int_opts & (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY)) != (LYD_INTOPT_ACTION | LYD_INTOPT_REPLY));
+    /* when */
+    whens = lysc_node_when(snode);
+    LY_ARRAY_FOR(whens, u) {
+        if ((match = lyd_val_diff_expr_match(whens[u]->cond, &vctx->snodes, NULL))) {
+            break;
+        }
+    }
+    if (match) {
+        if (lyd_val_diff_is_implicit(snode)) {
+            /* the when may now be true for nodes that do not exist */
+            LY_CHECK_GOTO(ret = lyd_val_diff_implicit(tree, snode, val_opts, vctx, diff), cleanup);
+        }
+
+        LY_CHECK_GOTO(ret = lyd_val_diff_instances(*tree, snode, &inst), cleanup);
+        for (i = 0; i < inst.count; ++i) {
+            LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->node_when, &vctx->when_ht, inst.objs[i]), cleanup);
+        }
+        ly_set_clean(&inst, NULL);
+
+        if ((snode->nodetype & (LYS_CHOICE | LYS_CASE)) || (snode->flags & LYS_MAND_TRUE) ||
+                ((snode->nodetype == LYS_LIST) && ((struct lysc_node_list *)snode)->min) ||
+                ((snode->nodetype == LYS_LEAFLIST) && ((struct lysc_node_leaflist *)snode)->min)) {
+            /* the nodes may now be required to exist */
+            if ((sparent = lysc_data_parent(snode))) {
+                LY_CHECK_GOTO(ret = lyd_val_diff_instances(*tree, sparent, &inst), cleanup);
+                for (i = 0; i < inst.count; ++i) {
+                    LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->parents, &vctx->parents_ht, inst.objs[i]), cleanup);
+                }
+                ly_set_clean(&inst, NULL);
+            } else {
+                LY_CHECK_GOTO(ret = ly_set_add(&vctx->mods, snode->module, 0, NULL), cleanup);
+            }
+        }
+    }
 
-    if (node->schema->nodetype & (LYS_ACTION | LYS_RPC)) {
-        if (int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_ACTION)) {
-            schema = &((struct lysc_node_action *)node->schema)->input.node;
-        } else if (int_opts & LYD_INTOPT_REPLY) {
-            schema = &((struct lysc_node_action *)node->schema)->output.node;
-        } else {
-            LOGINT_RET(LYD_CTX(node));
+    /* must */
+    match = 0;
+    self = 1;
+    musts = lysc_node_musts(snode);
+    LY_ARRAY_FOR(musts, u) {
+        if (lyd_val_diff_expr_match(musts[u].cond, &vctx->snodes, &must_self)) {
+            match = 1;
+            self &= must_self;
         }
-    } else {
-        schema = node->schema;
     }
-    musts = lysc_node_musts(schema);
-    if (!musts) {
-        /* no must to evaluate */
-        return LY_SUCCESS;
+    if (match && self) {
+        /* only the changed instances and their ancestors, the changed subtrees are validated anyway */
+        for (i = 0; i < vctx->ancestors.count; ++i) {
+            if (vctx->ancestors.dnodes[i]->schema == snode) {
+                LY_CHECK_GOTO(ret = ly_set_add(&vctx->musts, vctx->ancestors.dnodes[i], 1, NULL), cleanup);
+            }
+        }
+    } else if (match) {
+        LY_CHECK_GOTO(ret = lyd_val_diff_instances(*tree, snode, &vctx->musts), cleanup);
     }
 
-    /* find first top-level node */
-    for (tree = node; tree->parent; tree = lyd_parent(tree)) {}
-    tree = lyd_first_sibling(tree);
+    /* type */
+    if (snode->nodetype & LYD_NODE_TERM) {
+        LY_CHECK_GOTO(ret = lyd_val_diff_type_match(snode, ((struct lysc_node_leaf *)snode)->type, &vctx->snodes,
+                &match), cleanup);
+        if (match) {
+            LY_CHECK_GOTO(ret = lyd_val_diff_instances(*tree, snode, &inst), cleanup);
+            for (i = 0; i < inst.count; ++i) {
+                LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx->node_types, &vctx->types_ht, inst.objs[i]), cleanup);
+            }
+        }
+    }
 
-    LY_ARRAY_FOR(musts, u) {
-        memset(&xp_set, 0, sizeof xp_set);
+cleanup:
+    ly_set_erase(&inst, NULL);
+    return ret;
+}
 
-        /* evaluate must */
-        ret = lyxp_eval(LYD_CTX(node), musts[u].cond, node->schema->module, LY_VALUE_SCHEMA_RESOLVED,
-                musts[u].prefixes, node, tree, NULL, &xp_set, LYXP_SCHEMA);
-        if (ret == LY_EINCOMPLETE) {
-            LOGINT_RET(LYD_CTX(node));
-        } else if (ret) {
-            return ret;
+/**
+ * @brief Collect data nodes with restrictions that depend on the changes.
+ *
+ * @param[in] ctx libyang context.
+ * @param[in,out] tree Data tree.
+ * @param[in] val_opts Validation options (@ref datavalidationoptions).
+ * @param[in,out] vctx Incremental validation context.
+ * @param[in,out] diff Validation diff.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+lyd_val_diff_deps(const struct ly_ctx *ctx, struct lyd_node **tree, uint32_t val_opts, struct lyd_val_diff_ctx *vctx,
+        struct lyd_node **diff)
+{
+    const struct lys_module *mod;
+    struct lysc_node *top, *snode;
+    uint32_t idx = 0;
+
+    while ((mod = ly_ctx_get_module_iter(ctx, &idx))) {
+        if (!mod->implemented) {
+            continue;
         }
 
-        /* check the result */
-        lyxp_set_cast(&xp_set, LYXP_SET_BOOLEAN);
-        if (!xp_set.val.bln) {
-            /* use specific error information */
-            emsg = musts[u].emsg;
-            eapptag = musts[u].eapptag ? musts[u].eapptag : "must-violation";
-            if (emsg) {
-                LOGVAL_APPTAG(LYD_CTX(node), eapptag, LYVE_DATA, "%s", emsg);
-            } else {
-                LOGVAL_APPTAG(LYD_CTX(node), eapptag, LY_VCODE_NOMUST, musts[u].cond->expr);
+        LY_LIST_FOR(mod->compiled->data, top) {
+            LYSC_TREE_DFS_BEGIN(top, snode) {
+                if ((val_opts & LYD_VALIDATE_NO_STATE) && (snode->flags & LYS_CONFIG_R)) {
+                    /* no state data */
+                    LYSC_TREE_DFS_continue = 1;
+                } else {
+                    LY_CHECK_RET(lyd_val_diff_node_deps(tree, snode, val_opts, vctx, diff));
+                }
+
+                LYSC_TREE_DFS_END(top, snode);
             }
-            return LY_EVALID;
         }
     }
 
@@ -1358,261 +3033,367 @@ lyd_validate_must(const struct lyd_node *node, uint32_t int_opts)
 }
 
 /**
- * @brief Perform all remaining validation tasks, the data tree must be final when calling this function.
+ * @brief Collect the data nodes changed by a diff.
  *
- * @param[in] first First sibling.
- * @param[in] parent Data parent.
- * @param[in] sparent Schema parent of the siblings, NULL for top-level siblings.
- * @param[in] mod Module of the siblings, NULL for nested siblings.
- * @param[in] val_opts Validation options (@ref datavalidationoptions).
- * @param[in] int_opts Internal parser options.
+ * @param[in] first First data sibling corresponding to @p diff_first.
+ * @param[in] parent Data parent of @p first, NULL for top-level siblings.
+ * @param[in] diff_first First diff sibling.
+ * @param[in] strict Whether all the created and replaced nodes must exist, otherwise they were removed by validation.
+ * @param[in,out] vctx Incremental validation context.
+ * @return LY_ENOT if the changes cannot be validated incrementally.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_validate_final_r(struct lyd_node *first, const struct lyd_node *parent, const struct lysc_node *sparent,
-        const struct lys_module *mod, uint32_t val_opts, uint32_t int_opts)
+lyd_val_diff_collect_r(struct lyd_node *first, struct lyd_node *parent, const struct lyd_node *diff_first,
+        ly_bool strict, struct lyd_val_diff_ctx *vctx)
 {
-    const char *innode = NULL;
-    struct lyd_node *next = NULL, *node;
+    LY_ERR r;
+    const struct lyd_node *diff_node;
+    struct lyd_node *match;
+    enum lyd_diff_op op;
 
-    /* validate all restrictions of nodes themselves */
-    LY_LIST_FOR_SAFE(first, next, node) {
-        if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
-            /* all top-level data from this module checked */
-            break;
+    LY_LIST_FOR(diff_first, diff_node) {
+        if (!diff_node->schema || lysc_is_dup_inst_list(diff_node->schema)) {
+            /* the instances cannot be reliably matched */
+            return LY_ENOT;
         }
+        LY_CHECK_RET(lyd_diff_get_op(diff_node, &op));
 
-        LOG_LOCSET(node->schema, node, NULL, NULL);
-
-        /* opaque data */
-        if (!node->schema) {
-            LOGVAL(LYD_CTX(node), LYVE_DATA, "Invalid opaque node \"%s\" found.", ((struct lyd_node_opaq *)node)->name.name);
-            LOG_LOCBACK(0, 1, 0, 0);
-            return LY_EVALID;
+        /* find the node in the data tree */
+        r = lyd_find_sibling_first(first, diff_node, &match);
+        LY_CHECK_RET(r && (r != LY_ENOTFOUND), r);
+        if (!match && (op != LYD_DIFF_OP_DELETE)) {
+            if (strict) {
+                return LY_ENOT;
+            }
+            continue;
         }
 
-        /* no state/input/output data */
-        if ((val_opts & LYD_VALIDATE_NO_STATE) && (node->schema->flags & LYS_CONFIG_R)) {
-            innode = "state";
-            goto unexpected_node;
-        } else if ((int_opts & (LYD_INTOPT_RPC | LYD_INTOPT_ACTION)) && (node->schema->flags & LYS_IS_OUTPUT)) {
-            innode = "output";
-            goto unexpected_node;
-        } else if ((int_opts & LYD_INTOPT_REPLY) && (node->schema->flags & LYS_IS_INPUT)) {
-            innode = "input";
-            goto unexpected_node;
+        if (op == LYD_DIFF_OP_NONE) {
+            if (diff_node->schema->nodetype & LYD_NODE_INNER) {
+                /* only some descendants were changed */
+                LY_CHECK_RET(lyd_val_diff_collect_r(lyd_child(match), match, lyd_child(diff_node), strict, vctx));
+            } /* else unchanged list key */
+            continue;
         }
 
-        /* obsolete data */
-        lyd_validate_obsolete(node);
-
-        /* node's musts */
-        LY_CHECK_RET(lyd_validate_must(node, int_opts));
-
-        /* node value was checked by plugins */
-
-        LOG_LOCBACK(1, 1, 0, 0);
-    }
-
-    /* validate schema-based restrictions */
-    LY_CHECK_RET(lyd_validate_siblings_schema_r(first, parent, sparent, mod ? mod->compiled : NULL, val_opts, int_opts));
-
-    LY_LIST_FOR(first, node) {
-        if (!node->parent && mod && (lyd_owner_module(node) != mod)) {
-            /* all top-level data from this module checked */
-            break;
+        LY_CHECK_RET(ly_set_add(&vctx->snodes, (void *)diff_node->schema, 0, NULL));
+        if (op != LYD_DIFF_OP_DELETE) {
+            LY_CHECK_RET(lyd_val_set_add(&vctx->roots, &vctx->roots_ht, match));
         }
-
-        /* validate all children recursively */
-        LY_CHECK_RET(lyd_validate_final_r(lyd_child(node), node, node->schema, NULL, val_opts, int_opts));
-
-        /* set default for containers */
-        if (node->schema && (node->schema->nodetype == LYS_CONTAINER) && !(node->schema->flags & LYS_PRESENCE)) {
-            LY_LIST_FOR(lyd_child(node), next) {
-                if (!(next->flags & LYD_DEFAULT)) {
-                    break;
-                }
-            }
-            if (!next) {
-                node->flags |= LYD_DEFAULT;
-            }
+        if (parent) {
+            LY_CHECK_RET(lyd_val_set_add(&vctx->parents, &vctx->parents_ht, parent));
+        } else {
+            LY_CHECK_RET(ly_set_add(&vctx->mods, (void *)lyd_owner_module(diff_node), 0, NULL));
         }
     }
 
     return LY_SUCCESS;
-
-unexpected_node:
-    LOGVAL(LYD_CTX(node), LY_VCODE_UNEXPNODE, innode, node->schema->name);
-    LOG_LOCBACK(1, 1, 0, 0);
-    return LY_EVALID;
 }
 
 /**
- * @brief Validate the whole data subtree.
+ * @brief Collect the schema nodes changed by validation.
  *
- * @param[in] root Subtree root.
- * @param[in,out] node_when Set for nodes with when conditions.
- * @param[in,out] node_exts Set for nodes and extension instances with validation plugin callback.
- * @param[in,out] node_types Set for unres node types.
- * @param[in,out] meta_types Set for unres metadata types.
- * @param[in] impl_opts Implicit options, see @ref implicitoptions.
- * @param[in,out] diff Validation diff.
+ * @param[in] diff_first First validation diff sibling.
+ * @param[in,out] snodes Set of changed schema nodes.
  * @return LY_ERR value.
  */
 static LY_ERR
-lyd_validate_subtree(struct lyd_node *root, struct ly_set *node_when, struct ly_set *node_exts, struct ly_set *node_types,
-        struct ly_set *meta_types, uint32_t impl_opts, struct lyd_node **diff)
+lyd_val_diff_schemas_r(const struct lyd_node *diff_first, struct ly_set *snodes)
 {
-    const struct lyd_meta *meta;
-    struct lyd_node *node;
+    const struct lyd_node *diff_node;
+    enum lyd_diff_op op;
 
-    LYD_TREE_DFS_BEGIN(root, node) {
-        if (!node->schema) {
-            goto next_node;
+    LY_LIST_FOR(diff_first, diff_node) {
+        LY_CHECK_RET(lyd_diff_get_op(diff_node, &op));
+        if (op == LYD_DIFF_OP_NONE) {
+            LY_CHECK_RET(lyd_val_diff_schemas_r(lyd_child(diff_node), snodes));
+        } else {
+            LY_CHECK_RET(ly_set_add(snodes, (void *)diff_node->schema, 0, NULL));
         }
+    }
 
-        LY_LIST_FOR(node->meta, meta) {
-            if ((*(const struct lysc_type **)meta->annotation->substmts[ANNOTATION_SUBSTMT_TYPE].storage)->plugin->validate) {
-                /* metadata type resolution */
-                LY_CHECK_RET(ly_set_add(meta_types, (void *)meta, 1, NULL));
-            }
-        }
+    return LY_SUCCESS;
+}
 
-        if ((node->schema->nodetype & LYD_NODE_TERM) && ((struct lysc_node_leaf *)node->schema)->type->plugin->validate) {
-            /* node type resolution */
-            LY_CHECK_RET(ly_set_add(node_types, (void *)node, 1, NULL));
-        } else if (node->schema->nodetype & LYD_NODE_INNER) {
-            /* new node validation, autodelete */
-            LY_CHECK_RET(lyd_validate_new(lyd_node_child_p(node), node->schema, NULL, diff));
+/**
+ * @brief Count all the nodes in a diff.
+ *
+ * @param[in] diff Validation diff.
+ * @return Number of the nodes.
+ */
+static uint32_t
+lyd_val_diff_count(const struct lyd_node *diff)
+{
+    const struct lyd_node *root, *node;
+    uint32_t count = 0;
 
-            /* add nested defaults */
-            LY_CHECK_RET(lyd_new_implicit_r(node, lyd_node_child_p(node), NULL, NULL, NULL, NULL, NULL, impl_opts, diff));
+    LY_LIST_FOR(diff, root) {
+        LYD_TREE_DFS_BEGIN(root, node) {
+            ++count;
+            LYD_TREE_DFS_END(root, node);
         }
+    }
 
-        if (lysc_has_when(node->schema)) {
-            /* when evaluation */
-            LY_CHECK_RET(ly_set_add(node_when, (void *)node, 1, NULL));
+    return count;
+}
+
+/**
+ * @brief Check whether metadata values of any module may depend on other data.
+ *
+ * @param[in] ctx libyang context.
+ * @return Whether some annotation type validation may depend on other data.
+ */
+static ly_bool
+lyd_val_diff_meta_validate(const struct ly_ctx *ctx)
+{
+    const struct lys_module *mod;
+    const struct lysc_type *type;
+    LY_ARRAY_COUNT_TYPE u;
+    uint32_t idx = 0;
+
+    while ((mod = ly_ctx_get_module_iter(ctx, &idx))) {
+        if (!mod->implemented) {
+            continue;
         }
-        LY_CHECK_RET(lysc_node_ext_tovalidate(node_exts, node));
 
-next_node:
-        LYD_TREE_DFS_END(root, node);
+        LY_ARRAY_FOR(mod->compiled->exts, u) {
+            if (mod->compiled->exts[u].def->plugin != lyplg_find(LYPLG_EXTENSION, LYEXT_PLUGIN_INTERNAL_ANNOTATION)) {
+                continue;
+            }
+
+            type = *(const struct lysc_type **)mod->compiled->exts[u].substmts[ANNOTATION_SUBSTMT_TYPE].storage;
+            if (lyd_val_diff_type_refs(type)) {
+                return 1;
+            }
+        }
     }
 
-    return LY_SUCCESS;
+    return 0;
 }
 
-LY_ERR
-lyd_validate(struct lyd_node **tree, const struct lys_module *module, const struct ly_ctx *ctx, uint32_t val_opts,
-        ly_bool validate_subtree, struct ly_set *node_when_p, struct ly_set *node_exts_p,
-        struct ly_set *node_types_p, struct ly_set *meta_types_p, struct lyd_node **diff)
+/**
+ * @brief Free an incremental validation context.
+ *
+ * @param[in] vctx Context to free.
+ */
+static void
+lyd_val_diff_ctx_free(struct lyd_val_diff_ctx *vctx)
+{
+    ly_set_erase(&vctx->snodes, NULL);
+    ly_set_erase(&vctx->parents, NULL);
+    ly_set_erase(&vctx->mods, NULL);
+    ly_set_erase(&vctx->roots, NULL);
+    ly_set_erase(&vctx->ancestors, NULL);
+    ly_set_erase(&vctx->uniques, NULL);
+    ly_set_erase(&vctx->musts, NULL);
+    ly_set_erase(&vctx->node_when, NULL);
+    ly_set_erase(&vctx->node_exts, free);
+    ly_set_erase(&vctx->node_types, NULL);
+    ly_set_erase(&vctx->meta_types, NULL);
+
+    lyht_free(vctx->parents_ht);
+    lyht_free(vctx->roots_ht);
+    lyht_free(vctx->ancestors_ht);
+    lyht_free(vctx->uniques_ht);
+    lyht_free(vctx->when_ht);
+    lyht_free(vctx->types_ht);
+    memset(vctx, 0, sizeof *vctx);
+}
+
+API LY_ERR
+lyd_validate_diff(struct lyd_node **tree, const struct lyd_node *changes, uint32_t val_opts, struct lyd_node **diff)
 {
     LY_ERR ret = LY_SUCCESS;
-    struct lyd_node *first, *next, **first2, *iter;
+    const struct ly_ctx *ctx;
+    struct lyd_val_diff_ctx vctx = {0};
+    struct lyd_node *val_diff = NULL, **diff_p, *node, *first, **first2;
+    const struct lysc_node_list *slist;
     const struct lys_module *mod;
-    struct ly_set node_types = {0}, meta_types = {0}, node_when = {0}, node_exts = {0};
-    uint32_t i = 0;
+    struct hash_table *cache = NULL;
+    uint32_t i, impl_opts, count;
 
-    assert(tree && ctx);
-    assert((node_when_p && node_exts_p && node_types_p && meta_types_p) ||
-            (!node_when_p && !node_exts_p && !node_types_p && !meta_types_p));
+    LY_CHECK_ARG_RET(NULL, tree, changes, LY_EINVAL);
+    ctx = LYD_CTX(changes);
+    if (diff) {
+        *diff = NULL;
+    }
+    diff_p = diff ? diff : &val_diff;
+    impl_opts = (val_opts & LYD_VALIDATE_NO_STATE) ? LYD_IMPLICIT_NO_STATE : 0;
 
-    if (!node_when_p) {
-        node_when_p = &node_when;
-        node_exts_p = &node_exts;
-        node_types_p = &node_types;
-        meta_types_p = &meta_types;
+    if (lyd_val_diff_meta_validate(ctx)) {
+        /* metadata are not tracked */
+        goto validate_all;
     }
 
-    next = *tree;
-    while (1) {
-        if (val_opts & LYD_VALIDATE_PRESENT) {
-            mod = lyd_data_next_module(&next, &first);
-        } else {
-            mod = lyd_mod_next_module(next, module, ctx, &i, &first);
+    /* learn the changes */
+    ret = lyd_val_diff_collect_r(lyd_first_sibling(*tree), NULL, lyd_first_sibling(changes), 1, &vctx);
+    if (ret == LY_ENOT) {
+        goto validate_all;
+    }
+    LY_CHECK_GOTO(ret, cleanup);
+
+    /* validate new nodes and add defaults, the deepest first so that no parent is freed before it is processed */
+    qsort(vctx.parents.objs, vctx.parents.count, sizeof *vctx.parents.objs, lyd_val_diff_depth_cmp);
+    for (i = 0; i < vctx.parents.count; ++i) {
+        node = vctx.parents.dnodes[i];
+        LY_CHECK_GOTO(ret = lyd_validate_new(lyd_node_child_p(node), node->schema, NULL, diff_p), cleanup);
+        ret = lyd_new_implicit_r(node, lyd_node_child_p(node), NULL, NULL, NULL, NULL, NULL, impl_opts, diff_p);
+        LY_CHECK_GOTO(ret, cleanup);
+    }
+    for (i = 0; i < vctx.mods.count; ++i) {
+        mod = vctx.mods.objs[i];
+        if (!(first2 = lyd_val_diff_mod_first(tree, mod, val_opts, &first))) {
+            continue;
         }
-        if (!mod) {
-            break;
+        LY_CHECK_GOTO(ret = lyd_validate_new(first2, NULL, mod, diff_p), cleanup);
+        ret = lyd_new_implicit_r(NULL, first2, NULL, mod, NULL, NULL, NULL, impl_opts, diff_p);
+        LY_CHECK_GOTO(ret, cleanup);
+    }
+
+    /* learn the changes again, some nodes may have been removed */
+    lyd_val_diff_ctx_free(&vctx);
+    LY_CHECK_GOTO(ret = lyd_val_diff_collect_r(lyd_first_sibling(*tree), NULL, lyd_first_sibling(changes), 0, &vctx), cleanup);
+    LY_CHECK_GOTO(ret = lyd_val_diff_schemas_r(*diff_p, &vctx.snodes), cleanup);
+
+    /* defaults may have been created next to the changed nodes */
+    for (i = 0; i < vctx.parents.count; ++i) {
+        LY_LIST_FOR(lyd_child(vctx.parents.dnodes[i]), node) {
+            if (node->flags & LYD_DEFAULT) {
+                LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx.roots, &vctx.roots_ht, node), cleanup);
+            }
         }
-        if (!first || (first == *tree)) {
-            /* make sure first2 changes are carried to tree */
-            first2 = tree;
-        } else {
-            first2 = &first;
+    }
+    for (i = 0; i < vctx.mods.count; ++i) {
+        mod = vctx.mods.objs[i];
+        if (!lyd_val_diff_mod_first(tree, mod, val_opts, &first)) {
+            continue;
+        }
+        for (node = first; node && (lyd_owner_module(node) == mod); node = node->next) {
+            if (node->flags & LYD_DEFAULT) {
+                LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx.roots, &vctx.roots_ht, node), cleanup);
+            }
         }
+    }
 
-        /* validate new top-level nodes of this module, autodelete */
-        ret = lyd_validate_new(first2, NULL, mod, diff);
+    /* validate the changed subtrees */
+    for (i = 0; i < vctx.roots.count; ++i) {
+        ret = lyd_validate_subtree(vctx.roots.dnodes[i], &vctx.node_when, &vctx.node_exts, &vctx.node_types,
+                &vctx.meta_types, impl_opts, diff_p);
         LY_CHECK_GOTO(ret, cleanup);
+    }
 
-        /* add all top-level defaults for this module, if going to validate subtree, do not add into unres sets
-         * (lyd_validate_subtree() adds all the nodes in that case) */
-        ret = lyd_new_implicit_r(NULL, first2, NULL, mod, validate_subtree ? NULL : node_when_p, validate_subtree ? NULL : node_exts_p,
-                validate_subtree ? NULL : node_types_p, (val_opts & LYD_VALIDATE_NO_STATE) ? LYD_IMPLICIT_NO_STATE : 0, diff);
+    /* extensions of all the ancestors */
+    for (i = 0; i < vctx.parents.count; ++i) {
+        for (node = vctx.parents.dnodes[i]; node; node = lyd_parent(node)) {
+            LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx.ancestors, &vctx.ancestors_ht, node), cleanup);
+        }
+    }
+    for (i = 0; i < vctx.ancestors.count; ++i) {
+        LY_CHECK_GOTO(ret = lysc_node_ext_tovalidate(&vctx.node_exts, vctx.ancestors.dnodes[i]), cleanup);
+    }
+
+    /* nodes with when, must, or type restrictions depending on the changes */
+    LY_CHECK_GOTO(ret = lyd_val_diff_deps(ctx, tree, val_opts, &vctx, diff_p), cleanup);
+
+    /* finish incompletely validated terminal values/attributes and when conditions */
+    count = lyd_val_diff_count(*diff_p);
+    ret = lyd_validate_unres(tree, NULL, val_opts, &vctx.node_when, &vctx.node_exts, &vctx.node_types, &vctx.meta_types,
+            diff_p);
+    LY_CHECK_GOTO(ret, cleanup);
+    if (lyd_val_diff_count(*diff_p) != count) {
+        /* some nodes were removed, which may affect any other nodes */
+        goto validate_all;
+    }
+
+    /* perform final validation of the changed subtrees */
+    for (i = 0; i < vctx.roots.count; ++i) {
+        node = vctx.roots.dnodes[i];
+        LY_CHECK_GOTO(ret = lyd_validate_final_node(node, val_opts, 0, &cache), cleanup);
+        LY_CHECK_GOTO(ret = lyd_validate_final_r(lyd_child(node), node, node->schema, NULL, val_opts, 0, &cache), cleanup);
+        lyd_validate_np_cont_dflt(node);
+    }
+
+    /* ... must restrictions depending on the changes */
+    for (i = 0; i < vctx.musts.count; ++i) {
+        node = vctx.musts.dnodes[i];
+        LOG_LOCSET(node->schema, node, NULL, NULL);
+        ret = lyd_validate_must(node, 0, &cache);
+        LOG_LOCBACK(1, 1, 0, 0);
         LY_CHECK_GOTO(ret, cleanup);
+    }
 
-        /* our first module node pointer may no longer be the first */
-        first = *first2;
-        lyd_first_module_sibling(&first, mod);
-        if (!first || (first == *tree)) {
-            first2 = tree;
-        } else {
-            first2 = &first;
+    /* ... restrictions of the changed siblings */
+    for (i = 0; i < vctx.parents.count; ++i) {
+        node = vctx.parents.dnodes[i];
+        ret = lyd_validate_siblings_schema_r(lyd_child(node), node, node->schema, NULL, val_opts, 0);
+        LY_CHECK_GOTO(ret, cleanup);
+    }
+    for (i = 0; i < vctx.mods.count; ++i) {
+        mod = vctx.mods.objs[i];
+        if (!lyd_val_diff_mod_first(tree, mod, val_opts, &first)) {
+            continue;
         }
+        LY_CHECK_GOTO(ret = lyd_validate_siblings_schema_r(first, NULL, NULL, mod->compiled, val_opts, 0), cleanup);
+    }
 
-        if (validate_subtree) {
-            /* process nested nodes */
-            LY_LIST_FOR(*first2, iter) {
-                if (lyd_owner_module(iter) != mod) {
-                    break;
-                }
-
-                ret = lyd_validate_subtree(iter, node_when_p, node_exts_p, node_types_p, meta_types_p,
-                        (val_opts & LYD_VALIDATE_NO_STATE) ? LYD_IMPLICIT_NO_STATE : 0, diff);
+    /* ... and of all the ancestors, the deepest first */
+    qsort(vctx.ancestors.objs, vctx.ancestors.count, sizeof *vctx.ancestors.objs, lyd_val_diff_depth_cmp);
+    for (i = 0; i < vctx.ancestors.count; ++i) {
+        node = vctx.ancestors.dnodes[i];
+        slist = (struct lysc_node_list *)node->schema;
+        if (slist && (slist->nodetype == LYS_LIST) && slist->uniques) {
+            /* unique of the list, only once for all its instances */
+            lyd_find_sibling_val(lyd_first_sibling(node), node->schema, NULL, 0, &first);
+            count = vctx.uniques.count;
+            LY_CHECK_GOTO(ret = lyd_val_set_add(&vctx.uniques, &vctx.uniques_ht, first), cleanup);
+            if (vctx.uniques.count > count) {
+                LOG_LOCSET(node->schema, NULL, NULL, NULL);
+                ret = lyd_validate_unique(first, node->schema, (const struct lysc_node_leaf ***)slist->uniques);
+                LOG_LOCBACK(1, 0, 0, 0);
                 LY_CHECK_GOTO(ret, cleanup);
             }
         }
+        lyd_validate_np_cont_dflt(node);
+    }
 
-        /* finish incompletely validated terminal values/attributes and when conditions */
-        ret = lyd_validate_unres(first2, mod, node_when_p, node_exts_p, node_types_p, meta_types_p, diff);
-        LY_CHECK_GOTO(ret, cleanup);
+    goto cleanup;
 
-        /* perform final validation that assumes the data tree is final */
-        ret = lyd_validate_final_r(*first2, NULL, NULL, mod, val_opts, 0);
-        LY_CHECK_GOTO(ret, cleanup);
-    }
+validate_all:
+    /* the whole data tree must be validated */
+    ret = lyd_validate(tree, NULL, ctx, val_opts, 1, NULL, NULL, NULL, NULL, diff_p);
 
 cleanup:
-    ly_set_erase(&node_when, NULL);
-    ly_set_erase(&node_exts, NULL);
-    ly_set_erase(&node_types, NULL);
-    ly_set_erase(&meta_types, NULL);
+    lyd_val_diff_ctx_free(&vctx);
+    lyht_free(cache);
+    lyd_free_all(val_diff);
     return ret;
 }
 
 API LY_ERR
-lyd_validate_all(struct lyd_node **tree, const struct ly_ctx *ctx, uint32_t val_opts, struct lyd_node **diff)
-{
-    LY_CHECK_ARG_RET(NULL, tree, *tree || ctx, LY_EINVAL);
-    if (!ctx) {
-        ctx = LYD_CTX(*tree);
-    }
-    if (diff) {
-        *diff = NULL;
-    }
-
-    return lyd_validate(tree, NULL, ctx, val_opts, 1, NULL, NULL, NULL, NULL, diff);
-}
-
-API LY_ERR
-lyd_validate_module(struct lyd_node **tree, const struct lys_module *module, uint32_t val_opts, struct lyd_node **diff)
+lyd_unique_index_stats(const struct lyd_node *tree, struct lyd_unique_index_stats *stats)
 {
-    LY_CHECK_ARG_RET(NULL, tree, *tree || module, LY_EINVAL);
-    if (diff) {
-        *diff = NULL;
+    const struct lyd_node *root, *node;
+    const struct lyd_uniq_idx *idx;
+
+    LY_CHECK_ARG_RET(NULL, stats, LY_EINVAL);
+
+    memset(stats, 0, sizeof *stats);
+    LY_LIST_FOR(tree ? lyd_first_sibling(tree) : NULL, root) {
+        LYD_TREE_DFS_BEGIN(root, node) {
+            if (node->schema && (node->schema->nodetype & LYD_NODE_INNER)) {
+                for (idx = ((struct lyd_node_inner *)node)->uniq_idx; idx; idx = idx->next) {
+                    ++stats->indexes;
+                    stats->instances += idx->insts->used;
+                    stats->invalidations += idx->invalidations;
+                    stats->rehashes += idx->rehashes;
+                }
+            }
+            LYD_TREE_DFS_END(root, node);
+        }
     }
 
-    return lyd_validate(tree, module, (*tree) ? LYD_CTX(*tree) : module->ctx, val_opts, 1, NULL, NULL, NULL, NULL, diff);
+    return LY_SUCCESS;
 }
 
 /**
@@ -1702,6 +3483,7 @@ _lyd_validate_op(struct lyd_node *op_tree, struct lyd_node *op_node, const struc
     LY_ERR rc = LY_SUCCESS;
     struct lyd_node *tree_sibling, *tree_parent, *op_subtree, *op_parent, *child;
     struct ly_set node_types = {0}, meta_types = {0}, node_when = {0}, node_exts = {0};
+    struct hash_table *cache = NULL;
 
     assert(op_tree && op_node);
     assert((node_when_p && node_exts_p && node_types_p && meta_types_p) ||
@@ -1747,18 +3529,20 @@ _lyd_validate_op(struct lyd_node *op_tree, struct lyd_node *op_node, const struc
     }
 
     /* finish incompletely validated terminal values/attributes and when conditions on the full tree */
-    LY_CHECK_GOTO(rc = lyd_validate_unres((struct lyd_node **)&dep_tree, NULL,
+    LY_CHECK_GOTO(rc = lyd_validate_unres((struct lyd_node **)&dep_tree, NULL, 0,
             node_when_p, node_exts_p, node_types_p, meta_types_p, diff), cleanup);
 
     /* perform final validation of the operation/notification */
     lyd_validate_obsolete(op_node);
-    LY_CHECK_GOTO(rc = lyd_validate_must(op_node, int_opts), cleanup);
+    LY_CHECK_GOTO(rc = lyd_validate_must(op_node, int_opts, &cache), cleanup);
 
     /* final validation of all the descendants */
-    LY_CHECK_GOTO(rc = lyd_validate_final_r(lyd_child(op_node), op_node, op_node->schema, NULL, 0, int_opts), cleanup);
+    LY_CHECK_GOTO(rc = lyd_validate_final_r(lyd_child(op_node), op_node, op_node->schema, NULL, 0, int_opts, &cache),
+            cleanup);
 
 cleanup:
     LOG_LOCBACK(0, 1, 0, 0);
+    lyht_free(cache);
     /* restore operation tree */
     lyd_unlink_tree(op_subtree);
     if (op_parent) {
@@ -23,6 +23,7 @@
 struct ly_ctx;
 struct ly_set;
 struct lyd_node;
+struct lyd_node_inner;
 struct lys_module;
 struct lysc_node;
 
@@ -45,6 +46,21 @@ LY_ERR lysc_node_ext_tovalidate(struct ly_set *node_exts, struct lyd_node *node)
  */
 LY_ERR lyd_val_diff_add(const struct lyd_node *node, enum lyd_diff_op op, struct lyd_node **diff);
 
+/**
+ * @brief Update the unique index of a list after a data node was changed, see ::LY_CTX_UNIQUE_INDEX.
+ *
+ * @param[in] node Data node that was inserted, is going to be unlinked, or whose value was changed.
+ * @param[in] unlink Whether @p node is going to be unlinked.
+ */
+void lyd_val_uniq_idx_change(struct lyd_node *node, ly_bool unlink);
+
+/**
+ * @brief Free all the unique indexes of a data node, see ::LY_CTX_UNIQUE_INDEX.
+ *
+ * @param[in] parent Data node with the indexes, its children must not be freed yet.
+ */
+void lyd_val_uniq_idx_free(struct lyd_node_inner *parent);
+
 /**
  * @brief Finish validation of nodes and attributes. Specifically, when (is processed first) and type validation.
  *
@@ -54,6 +70,7 @@ LY_ERR lyd_val_diff_add(const struct lyd_node *node, enum lyd_diff_op op, struct
  * @param[in] mod Module of the @p tree to take into consideration when deleting @p tree and moving it.
  * If set, it is expected @p tree should point to the first node of @p mod. Otherwise it will simply be
  * the first top-level sibling.
+ * @param[in] val_opts Validation options, see @ref datavalidationoptions.
  * @param[in] node_when Set with nodes with "when" conditions, can be NULL.
  * @param[in] node_exts Set with nodes with extension instances with validation plugin callback, can be NULL.
  * @param[in] node_types Set with nodes with unresolved types, can be NULL
@@ -61,8 +78,8 @@ LY_ERR lyd_val_diff_add(const struct lyd_node *node, enum lyd_diff_op op, struct
  * @param[in,out] diff Validation diff.
  * @return LY_ERR value.
  */
-LY_ERR lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, struct ly_set *node_when,
-        struct ly_set *node_exts, struct ly_set *node_types, struct ly_set *meta_types, struct lyd_node **diff);
+LY_ERR lyd_validate_unres(struct lyd_node **tree, const struct lys_module *mod, uint32_t val_opts,
+        struct ly_set *node_when, struct ly_set *node_exts, struct ly_set *node_types, struct ly_set *meta_types, struct lyd_node **diff);
 
 /**
  * @brief Validate new siblings. Specifically, check duplicated instances, autodelete default values and cases.
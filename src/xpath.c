@@ -573,6 +573,152 @@ cast_string_to_number(const char *str)
     return num;
 }
 
+/**
+ * @brief Get the stored value of a node in a set if it is an integer or a decimal64.
+ *
+ * @param[in] set Node set.
+ * @param[in] idx Index of the node in @p set.
+ * @return Numeric value of the node, NULL if it has none.
+ */
+static const struct lyd_value *
+set_node_num_value(const struct lyxp_set *set, uint32_t idx)
+{
+    const struct lyd_value *val;
+
+    switch (set->val.nodes[idx].type) {
+    case LYXP_NODE_ELEM:
+    case LYXP_NODE_TEXT:
+        if (!set->val.nodes[idx].node->schema || !(set->val.nodes[idx].node->schema->nodetype & LYD_NODE_TERM)) {
+            return NULL;
+        }
+        val = &((struct lyd_node_term *)set->val.nodes[idx].node)->value;
+        break;
+    case LYXP_NODE_META:
+        val = &set->val.meta[idx].meta->value;
+        break;
+    default:
+        return NULL;
+    }
+
+    if (val->realtype->basetype == LY_TYPE_UNION) {
+        val = &val->subvalue->value;
+    }
+
+    switch (val->realtype->basetype) {
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_UINT64:
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_INT64:
+    case LY_TYPE_DEC64:
+        return val;
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Cast a numeric value into an XPath number. The result is the same as casting its canonical string.
+ *
+ * @param[in] val Numeric value, see ::set_node_num_value().
+ * @return Cast number.
+ */
+static long double
+cast_num_value_to_number(const struct lyd_value *val)
+{
+    long double num;
+    uint8_t i;
+
+    switch (val->realtype->basetype) {
+    case LY_TYPE_UINT8:
+        return val->uint8;
+    case LY_TYPE_UINT16:
+        return val->uint16;
+    case LY_TYPE_UINT32:
+        return val->uint32;
+    case LY_TYPE_UINT64:
+        return val->uint64;
+    case LY_TYPE_INT8:
+        return val->int8;
+    case LY_TYPE_INT16:
+        return val->int16;
+    case LY_TYPE_INT32:
+        return val->int32;
+    case LY_TYPE_INT64:
+        return val->int64;
+    case LY_TYPE_DEC64:
+        /* a single correctly rounded division, as strtold() of the canonical value */
+        num = 1;
+        for (i = 0; i < ((struct lysc_type_dec *)val->realtype)->fraction_digits; ++i) {
+            num *= 10;
+        }
+        return val->dec64 / num;
+    default:
+        assert(0);
+        return NAN;
+    }
+}
+
+/**
+ * @brief Compare a numeric value with an XPath number. Integers are compared exactly regardless
+ * of the precision of long double.
+ *
+ * @param[in] val Numeric value, see ::set_node_num_value().
+ * @param[in] num Number to compare with.
+ * @return Negative, 0, or positive if @p val is lower than, equal to, or greater than @p num;
+ * @return 2 if they cannot be compared (@p num is NaN).
+ */
+static int
+num_value_cmp(const struct lyd_value *val, long double num)
+{
+    long double fl;
+    uint64_t u;
+    int64_t i;
+
+    if (isnan(num)) {
+        return 2;
+    }
+
+    switch (val->realtype->basetype) {
+    case LY_TYPE_UINT8:
+    case LY_TYPE_UINT16:
+    case LY_TYPE_UINT32:
+    case LY_TYPE_UINT64:
+        u = (val->realtype->basetype == LY_TYPE_UINT64) ? val->uint64 : (uint64_t)cast_num_value_to_number(val);
+        if (num < 0) {
+            return 1;
+        } else if (num >= 18446744073709551616.0L) {
+            return -1;
+        }
+        fl = floorl(num);
+        if (u != (uint64_t)fl) {
+            return (u < (uint64_t)fl) ? -1 : 1;
+        }
+        return (fl < num) ? -1 : 0;
+    case LY_TYPE_INT8:
+    case LY_TYPE_INT16:
+    case LY_TYPE_INT32:
+    case LY_TYPE_INT64:
+        i = (val->realtype->basetype == LY_TYPE_INT64) ? val->int64 : (int64_t)cast_num_value_to_number(val);
+        if (num < -9223372036854775808.0L) {
+            return 1;
+        } else if (num >= 9223372036854775808.0L) {
+            return -1;
+        }
+        fl = floorl(num);
+        if (i != (int64_t)fl) {
+            return (i < (int64_t)fl) ? -1 : 1;
+        }
+        return (fl < num) ? -1 : 0;
+    default:
+        fl = cast_num_value_to_number(val);
+        return (fl < num) ? -1 : ((fl > num) ? 1 : 0);
+    }
+}
+
 /**
  * @brief Callback for checking value equality.
  *
@@ -599,6 +745,203 @@ set_values_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSE
     return 0;
 }
 
+/**
+ * @brief Node buffers and hash tables of node sets reused during a single evaluation, see ::lyxp_eval().
+ *
+ * Small node sets use inline buffers so that a typical evaluation needs no heap allocations. Larger buffers and
+ * hash tables are allocated on heap and cached once released so they can be reused by other sets.
+ */
+struct lyxp_set_pool {
+    struct lyxp_set_node slots[LYXP_SET_POOL_SLOTS][LYXP_SET_POOL_SLOT_SIZE];  /**< inline node buffers */
+    uint32_t slots_used;                                /**< bitmap of used @p slots */
+    struct lyxp_set_node *bufs[LYXP_SET_POOL_CACHED];   /**< released heap node buffers */
+    uint32_t buf_sizes[LYXP_SET_POOL_CACHED];           /**< sizes of @p bufs */
+    uint32_t buf_count;                                 /**< number of @p bufs */
+    struct hash_table *hts[LYXP_SET_POOL_CACHED];       /**< released empty hash tables */
+    uint32_t ht_count;                                  /**< number of @p hts */
+};
+
+/**
+ * @brief Get the inline buffer index of a node buffer.
+ *
+ * @param[in] pool Set pool, may be NULL.
+ * @param[in] nodes Node buffer.
+ * @return Index of the inline buffer in @p pool, -1 if @p nodes is not an inline buffer.
+ */
+static int
+set_pool_slot(const struct lyxp_set_pool *pool, const struct lyxp_set_node *nodes)
+{
+    uintptr_t first, last;
+
+    if (!pool || !nodes) {
+        return -1;
+    }
+
+    first = (uintptr_t)pool->slots[0];
+    last = (uintptr_t)pool->slots[LYXP_SET_POOL_SLOTS - 1];
+    if (((uintptr_t)nodes < first) || ((uintptr_t)nodes > last)) {
+        return -1;
+    }
+    return ((uintptr_t)nodes - first) / sizeof *pool->slots;
+}
+
+/**
+ * @brief Release the node buffer of a set, the set itself is not changed.
+ *
+ * @param[in] set Set with the buffer.
+ */
+static void
+set_nodes_release(struct lyxp_set *set)
+{
+    struct lyxp_set_pool *pool = set->pool;
+    int slot;
+
+    if ((slot = set_pool_slot(pool, set->val.nodes)) > -1) {
+        pool->slots_used &= ~(1U << slot);
+    } else if (pool && set->val.nodes && (pool->buf_count < LYXP_SET_POOL_CACHED)) {
+        pool->bufs[pool->buf_count] = set->val.nodes;
+        pool->buf_sizes[pool->buf_count] = set->size;
+        ++pool->buf_count;
+    } else {
+        free(set->val.nodes);
+    }
+}
+
+/**
+ * @brief Make sure a node set buffer has space for a number of nodes, the current nodes are kept.
+ *
+ * @param[in] set Node set to resize.
+ * @param[in] size Minimal number of nodes @p set must have space for.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+set_nodes_resize(struct lyxp_set *set, uint32_t size)
+{
+    struct lyxp_set_pool *pool = set->pool;
+    struct lyxp_set_node *nodes = NULL;
+    uint32_t i;
+
+    if (set->val.nodes && (set->size >= size)) {
+        return LY_SUCCESS;
+    }
+
+    if (set->val.nodes && (set_pool_slot(pool, set->val.nodes) == -1)) {
+        /* heap buffer, just grow it */
+        nodes = realloc(set->val.nodes, size * sizeof *nodes);
+        LY_CHECK_ERR_RET(!nodes, LOGMEM(set->ctx), LY_EMEM);
+        set->val.nodes = nodes;
+        set->size = size;
+        return LY_SUCCESS;
+    }
+
+    if (pool && (size <= LYXP_SET_POOL_SLOT_SIZE)) {
+        /* free inline buffer */
+        for (i = 0; i < LYXP_SET_POOL_SLOTS; ++i) {
+            if (!(pool->slots_used & (1U << i))) {
+                pool->slots_used |= 1U << i;
+                nodes = pool->slots[i];
+                size = LYXP_SET_POOL_SLOT_SIZE;
+                break;
+            }
+        }
+    }
+    if (pool && !nodes) {
+        /* released heap buffer */
+        for (i = 0; i < pool->buf_count; ++i) {
+            if (pool->buf_sizes[i] >= size) {
+                nodes = pool->bufs[i];
+                size = pool->buf_sizes[i];
+                --pool->buf_count;
+                pool->bufs[i] = pool->bufs[pool->buf_count];
+                pool->buf_sizes[i] = pool->buf_sizes[pool->buf_count];
+                break;
+            }
+        }
+    }
+    if (!nodes) {
+        nodes = malloc(size * sizeof *nodes);
+        LY_CHECK_ERR_RET(!nodes, LOGMEM(set->ctx), LY_EMEM);
+    }
+
+    if (set->val.nodes) {
+        /* move the nodes from the inline buffer */
+        memcpy(nodes, set->val.nodes, set->used * sizeof *nodes);
+        set_nodes_release(set);
+    }
+    set->val.nodes = nodes;
+    set->size = size;
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create a node set hash table.
+ *
+ * @param[in] set Node set to create the hash table for.
+ * @return Created empty hash table, NULL on error.
+ */
+static struct hash_table *
+set_ht_new(struct lyxp_set *set)
+{
+    if (set->pool && set->pool->ht_count) {
+        return set->pool->hts[--set->pool->ht_count];
+    }
+
+    return lyht_new(1, sizeof(struct lyxp_set_hash_node), set_values_equal_cb, NULL, 1);
+}
+
+/**
+ * @brief Release the hash table of a node set, the set itself is not changed.
+ *
+ * @param[in] set Node set with the hash table.
+ */
+static void
+set_ht_release(struct lyxp_set *set)
+{
+    if (set->ht && set->pool && (set->pool->ht_count < LYXP_SET_POOL_CACHED)) {
+        lyht_clear(set->ht);
+        set->pool->hts[set->pool->ht_count++] = set->ht;
+    } else {
+        lyht_free(set->ht);
+    }
+}
+
+/**
+ * @brief Detach a set from its pool so that it can be used after the evaluation, free the pool.
+ *
+ * @param[in] set Set to detach, its inline node buffer is moved to heap.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+set_pool_detach(struct lyxp_set *set)
+{
+    struct lyxp_set_pool *pool = set->pool;
+    struct lyxp_set_node *nodes;
+    LY_ERR rc = LY_SUCCESS;
+    uint32_t i;
+
+    if ((set->type == LYXP_SET_NODE_SET) && (set_pool_slot(pool, set->val.nodes) > -1)) {
+        nodes = malloc(set->size * sizeof *nodes);
+        if (nodes) {
+            memcpy(nodes, set->val.nodes, set->used * sizeof *nodes);
+            set->val.nodes = nodes;
+        } else {
+            LOGMEM(set->ctx);
+            rc = LY_EMEM;
+            set->val.nodes = NULL;
+            lyxp_set_free_content(set);
+        }
+    }
+    set->pool = NULL;
+
+    for (i = 0; i < pool->buf_count; ++i) {
+        free(pool->bufs[i]);
+    }
+    for (i = 0; i < pool->ht_count; ++i) {
+        lyht_free(pool->hts[i]);
+    }
+    return rc;
+}
+
 /**
  * @brief Insert node and its hash into set.
  *
@@ -613,9 +956,9 @@ set_insert_node_hash(struct lyxp_set *set, struct lyd_node *node, enum lyxp_node
     uint32_t i, hash;
     struct lyxp_set_hash_node hnode;
 
-    if (!set->ht && (set->used >= LYD_HT_MIN_ITEMS)) {
+    if (!set->ht && (set->used >= LYXP_SET_HT_MIN_ITEMS)) {
         /* create hash table and add all the nodes */
-        set->ht = lyht_new(1, sizeof(struct lyxp_set_hash_node), set_values_equal_cb, NULL, 1);
+        set->ht = set_ht_new(set);
         for (i = 0; i < set->used; ++i) {
             hnode.node = set->val.nodes[i].node;
             hnode.type = set->val.nodes[i].type;
@@ -677,7 +1020,7 @@ set_remove_node_hash(struct lyxp_set *set, struct lyd_node *node, enum lyxp_node
         (void)r;
 
         if (!set->ht->used) {
-            lyht_free(set->ht);
+            set_ht_release(set);
             set->ht = NULL;
         }
     }
@@ -730,8 +1073,8 @@ lyxp_set_free_content(struct lyxp_set *set)
     }
 
     if (set->type == LYXP_SET_NODE_SET) {
-        free(set->val.nodes);
-        lyht_free(set->ht);
+        set_nodes_release(set);
+        set_ht_release(set);
     } else if (set->type == LYXP_SET_SCNODE_SET) {
         free(set->val.scnodes);
         lyht_free(set->ht);
@@ -786,6 +1129,7 @@ set_init(struct lyxp_set *new, const struct lyxp_set *set)
         new->format = set->format;
         new->prefix_data = set->prefix_data;
         new->vars = set->vars;
+        new->pool = set->pool;
     }
 }
 
@@ -829,14 +1173,13 @@ set_copy(struct lyxp_set *set)
     } else if (set->type == LYXP_SET_NODE_SET) {
         ret->type = set->type;
         if (set->used) {
-            ret->val.nodes = malloc(set->used * sizeof *ret->val.nodes);
-            LY_CHECK_ERR_RET(!ret->val.nodes, LOGMEM(set->ctx); free(ret), NULL);
+            LY_CHECK_ERR_RET(set_nodes_resize(ret, set->used), free(ret), NULL);
             memcpy(ret->val.nodes, set->val.nodes, set->used * sizeof *ret->val.nodes);
         } else {
             ret->val.nodes = NULL;
         }
 
-        ret->used = ret->size = set->used;
+        ret->used = set->used;
         ret->ctx_pos = set->ctx_pos;
         ret->ctx_size = set->ctx_size;
         if (set->ht) {
@@ -917,7 +1260,8 @@ set_fill_set(struct lyxp_set *trg, const struct lyxp_set *src)
     }
 
     if (trg->type == LYXP_SET_NODE_SET) {
-        free(trg->val.nodes);
+        set_nodes_release(trg);
+        set_ht_release(trg);
     } else if (trg->type == LYXP_SET_STRING) {
         free(trg->val.str);
     }
@@ -942,27 +1286,19 @@ set_fill_set(struct lyxp_set *trg, const struct lyxp_set *src)
     } else if (src->type == LYXP_SET_STRING) {
         set_fill_string(trg, src->val.str, strlen(src->val.str));
     } else {
-        if (trg->type == LYXP_SET_NODE_SET) {
-            free(trg->val.nodes);
-        } else if (trg->type == LYXP_SET_STRING) {
-            free(trg->val.str);
-        }
-
         assert(src->type == LYXP_SET_NODE_SET);
 
         trg->type = LYXP_SET_NODE_SET;
-        trg->used = src->used;
-        trg->size = src->used;
         trg->ctx_pos = src->ctx_pos;
         trg->ctx_size = src->ctx_size;
 
-        if (trg->size) {
-            trg->val.nodes = malloc(trg->size * sizeof *trg->val.nodes);
-            LY_CHECK_ERR_RET(!trg->val.nodes, LOGMEM(src->ctx); memset(trg, 0, sizeof *trg), );
+        if (src->used) {
+            LY_CHECK_ERR_RET(set_nodes_resize(trg, src->used), memset(trg, 0, sizeof *trg), );
             memcpy(trg->val.nodes, src->val.nodes, src->used * sizeof *src->val.nodes);
         } else {
             trg->val.nodes = NULL;
         }
+        trg->used = src->used;
         if (src->ht) {
             trg->ht = lyht_dup(src->ht);
         } else {
@@ -1014,6 +1350,22 @@ set_remove_node(struct lyxp_set *set, uint32_t idx)
     }
 }
 
+/**
+ * @brief Remove all the nodes from a set except for the first one.
+ *
+ * @param[in] set Set to use.
+ */
+static void
+set_keep_first_node(struct lyxp_set *set)
+{
+    assert(set && (set->type == LYXP_SET_NODE_SET));
+
+    /* removing from the end requires no moving */
+    while (set->used > 1) {
+        set_remove_node(set, set->used - 1);
+    }
+}
+
 /**
  * @brief Remove a node from a set by setting its type to LYXP_NODE_NONE.
  *
@@ -1202,22 +1554,18 @@ set_insert_node(struct lyxp_set *set, const struct lyd_node *node, uint32_t pos,
             LOGINT(set->ctx);
             idx = 0;
         }
-        set->val.nodes = malloc(LYXP_SET_SIZE_START * sizeof *set->val.nodes);
-        LY_CHECK_ERR_RET(!set->val.nodes, LOGMEM(set->ctx), );
         set->type = LYXP_SET_NODE_SET;
         set->used = 0;
-        set->size = LYXP_SET_SIZE_START;
+        set->val.nodes = NULL;
+        LY_CHECK_RET(set_nodes_resize(set, LYXP_SET_SIZE_START), );
         set->ctx_pos = 1;
         set->ctx_size = 1;
         set->ht = NULL;
     } else {
         /* not an empty set */
         if (set->used == set->size) {
-
-            /* set is full */
-            set->val.nodes = ly_realloc(set->val.nodes, (set->size + LYXP_SET_SIZE_STEP) * sizeof *set->val.nodes);
-            LY_CHECK_ERR_RET(!set->val.nodes, LOGMEM(set->ctx), );
-            set->size += LYXP_SET_SIZE_STEP;
+            /* set is full, double its size */
+            LY_CHECK_RET(set_nodes_resize(set, set->size * 2), );
         }
 
         if (idx > set->used) {
@@ -1709,7 +2057,7 @@ set_sort(struct lyxp_set *set)
     print_set_debug(set);
 
     /* check node hashes */
-    if (set->used >= LYD_HT_MIN_ITEMS) {
+    if (set->used >= LYXP_SET_HT_MIN_ITEMS) {
         assert(set->ht);
         for (i = 0; i < set->used; ++i) {
             hnode.node = set->val.nodes[i].node;
@@ -1800,10 +2148,7 @@ set_sorted_merge(struct lyxp_set *trg, struct lyxp_set *src)
     /* make memory for the merge (duplicates are not detected yet, so space
      * will likely be wasted on them, too bad) */
     if (trg->size - trg->used < src->used) {
-        trg->size = trg->used + src->used;
-
-        trg->val.nodes = ly_realloc(trg->val.nodes, trg->size * sizeof *trg->val.nodes);
-        LY_CHECK_ERR_RET(!trg->val.nodes, LOGMEM(src->ctx), LY_EMEM);
+        LY_CHECK_RET(set_nodes_resize(trg, trg->used + src->used));
     }
 
     i = 0;
@@ -1868,7 +2213,7 @@ copy_nodes:
      * situations when there were initially not enough items for a hash table,
      * but even after some were inserted, hash table was not created (during
      * insertion the number of items is not updated yet) */
-    if (!trg->ht && (trg->used >= LYD_HT_MIN_ITEMS)) {
+    if (!trg->ht && (trg->used >= LYXP_SET_HT_MIN_ITEMS)) {
         set_insert_node_hash(trg, NULL, 0);
     }
 
@@ -2706,6 +3051,15 @@ lyxp_expr_free(const struct ly_ctx *ctx, struct lyxp_expr *expr)
     }
 
     lydict_remove(ctx, expr->expr);
+    if (expr->tok_res) {
+        for (i = 0; i < expr->used; ++i) {
+            if (expr->tokens[i] == LYXP_TOKEN_NAMETEST) {
+                lydict_remove(ctx, expr->tok_res[i].name);
+            }
+        }
+    }
+    free(expr->tok_res);
+    LY_ARRAY_FREE(expr->atoms);
     free(expr->tokens);
     free(expr->tok_pos);
     free(expr->tok_len);
@@ -3471,6 +3825,7 @@ xpath_bit_is_set(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyxp
     struct lyd_node_term *leaf;
     struct lysc_node_leaf *sleaf;
     struct lyd_value_bits *bits;
+    struct lysc_type_bits *type_bits;
     LY_ERR rc = LY_SUCCESS;
     LY_ARRAY_COUNT_TYPE u;
 
@@ -3510,9 +3865,11 @@ xpath_bit_is_set(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyxp
         leaf = (struct lyd_node_term *)args[0]->val.nodes[0].node;
         if ((leaf->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)) && (leaf->value.realtype->basetype == LY_TYPE_BITS)) {
             LYD_VALUE_GET(&leaf->value, bits);
-            LY_ARRAY_FOR(bits->items, u) {
-                if (!strcmp(bits->items[u]->name, args[1]->val.str)) {
-                    set_fill_boolean(set, 1);
+            type_bits = (struct lysc_type_bits *)leaf->value.realtype;
+            LY_ARRAY_FOR(type_bits->bits, u) {
+                if (!strcmp(type_bits->bits[u].name, args[1]->val.str)) {
+                    set_fill_boolean(set, lyplg_type_bits_is_bit_set(bits->bitmap, lyplg_type_bits_bitmap_size(type_bits),
+                            type_bits->bits[u].position));
                     break;
                 }
             }
@@ -5132,6 +5489,7 @@ xpath_substring_before(struct lyxp_set **args, uint16_t UNUSED(arg_count), struc
 static LY_ERR
 xpath_sum(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyxp_set *set, uint32_t options)
 {
+    const struct lyd_value *val;
     long double num;
     char *str;
     uint32_t i;
@@ -5176,6 +5534,12 @@ xpath_sum(struct lyxp_set **args, uint16_t UNUSED(arg_count), struct lyxp_set *s
     set_item.size = 1;
 
     for (i = 0; i < args[0]->used; ++i) {
+        if ((val = set_node_num_value(args[0], i))) {
+            /* no need to print the numeric value */
+            set->val.num += cast_num_value_to_number(val);
+            continue;
+        }
+
         set_item.val.nodes[0] = args[0]->val.nodes[i];
 
         rc = cast_node_set_to_string(&set_item, &str);
@@ -5603,6 +5967,13 @@ moveto_node(struct lyxp_set *set, const struct lys_module *moveto_mod, const cha
                     set_insert_node(set, sub, 0, LYXP_NODE_ELEM, i);
                 }
                 ++i;
+
+                if (options & LYXP_EXISTS) {
+                    /* the first node is enough, all the previous context nodes had no match */
+                    assert(i == 1);
+                    set_keep_first_node(set);
+                    return LY_SUCCESS;
+                }
             } else if (rc == LY_EINCOMPLETE) {
                 return rc;
             }
@@ -5695,6 +6066,13 @@ moveto_node_hash(struct lyxp_set *set, const struct lysc_node *scnode, const str
             /* pos filled later */
             set_replace_node(set, sub, 0, LYXP_NODE_ELEM, i);
             ++i;
+
+            if (options & LYXP_EXISTS) {
+                /* the first node is enough, all the previous context nodes had no match */
+                assert(i == 1);
+                set_keep_first_node(set);
+                break;
+            }
         } else {
             /* no match */
             set_remove_node(set, i);
@@ -5832,7 +6210,7 @@ moveto_node_alldesc(struct lyxp_set *set, const struct lys_module *moveto_mod, c
     }
 
     /* replace the original nodes (and throws away all text and meta nodes, root is replaced by a child) */
-    rc = moveto_node(set, NULL, NULL, options);
+    rc = moveto_node(set, NULL, NULL, options & ~LYXP_EXISTS);
     LY_CHECK_RET(rc);
 
     /* this loop traverses all the nodes in the set and adds/keeps only those that match qname */
@@ -6546,41 +6924,264 @@ moveto_scnode_parent(struct lyxp_set *set, ly_bool all_desc, uint32_t options)
 }
 
 /**
- * @brief Move context @p set to the result of a comparison. Handles '=', '!=', '<=', '<', '>=', or '>'.
- *        Result is LYXP_SET_BOOLEAN. Indirectly context position aware.
+ * @brief Callback for checking string equality.
  *
- * @param[in,out] set1 Set to use for the result.
- * @param[in] set2 Set acting as the second operand for @p op.
- * @param[in] op Comparison operator to process.
- * @param[in] options XPath options.
+ * Implementation of ::lyht_value_equal_cb.
+ *
+ * @param[in] val1_p First value.
+ * @param[in] val2_p Second value.
+ * @param[in] mod Whether hash table is being modified.
+ * @param[in] cb_data Callback data.
+ * @return Boolean value whether values are equal or not.
+ */
+static ly_bool
+set_comp_str_equal_cb(void *val1_p, void *val2_p, ly_bool UNUSED(mod), void *UNUSED(cb_data))
+{
+    return strcmp(*(char **)val1_p, *(char **)val2_p) ? 0 : 1;
+}
+
+/**
+ * @brief Cast all the nodes of a node set into strings for comparison.
+ *
+ * @param[in] set Node set to cast.
+ * @param[in] canon_node Node to canonize the strings with (see ::set_comp_canonize()), NULL to only cast them.
+ * @param[out] strs Array of cast strings, one for each node in @p set.
  * @return LY_ERR
  */
 static LY_ERR
-moveto_op_comp(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, uint32_t options)
+set_comp_cast_all(struct lyxp_set *set, const struct lyxp_set_node *canon_node, char ***strs)
 {
-    /*
-     * NODE SET + NODE SET = NODE SET + STRING /(1 NODE SET) 2 STRING
-     * NODE SET + STRING = STRING + STRING     /1 STRING (2 STRING)
-     * NODE SET + NUMBER = NUMBER + NUMBER     /1 NUMBER (2 NUMBER)
-     * NODE SET + BOOLEAN = BOOLEAN + BOOLEAN  /1 BOOLEAN (2 BOOLEAN)
-     * STRING + NODE SET = STRING + STRING     /(1 STRING) 2 STRING
-     * NUMBER + NODE SET = NUMBER + NUMBER     /(1 NUMBER) 2 NUMBER
-     * BOOLEAN + NODE SET = BOOLEAN + BOOLEAN  /(1 BOOLEAN) 2 BOOLEAN
-     *
-     * '=' or '!='
-     * BOOLEAN + BOOLEAN
-     * BOOLEAN + STRING = BOOLEAN + BOOLEAN    /(1 BOOLEAN) 2 BOOLEAN
-     * BOOLEAN + NUMBER = BOOLEAN + BOOLEAN    /(1 BOOLEAN) 2 BOOLEAN
-     * STRING + BOOLEAN = BOOLEAN + BOOLEAN    /1 BOOLEAN (2 BOOLEAN)
-     * NUMBER + BOOLEAN = BOOLEAN + BOOLEAN    /1 BOOLEAN (2 BOOLEAN)
-     * NUMBER + NUMBER
-     * NUMBER + STRING = NUMBER + NUMBER       /(1 NUMBER) 2 NUMBER
-     * STRING + NUMBER = NUMBER + NUMBER       /1 NUMBER (2 NUMBER)
-     * STRING + STRING
-     *
-     * '<=', '<', '>=', '>'
-     * NUMBER + NUMBER
-     * BOOLEAN + BOOLEAN = NUMBER + NUMBER     /1 NUMBER, 2 NUMBER
+    LY_ERR rc = LY_SUCCESS;
+    struct lyxp_set iter1, iter2;
+    uint32_t i;
+
+    *strs = calloc(set->used, sizeof **strs);
+    LY_CHECK_ERR_RET(!*strs, LOGMEM(set->ctx), LY_EMEM);
+
+    for (i = 0; i < set->used; ++i) {
+        LY_CHECK_GOTO(rc = set_comp_cast(&iter1, set, LYXP_SET_STRING, i), cleanup);
+        if (canon_node) {
+            memset(&iter2, 0, sizeof iter2);
+            rc = set_comp_canonize(&iter2, &iter1, canon_node);
+            lyxp_set_free_content(&iter1);
+            LY_CHECK_GOTO(rc, cleanup);
+            iter1 = iter2;
+        }
+
+        /* steal the string */
+        (*strs)[i] = iter1.val.str;
+    }
+
+cleanup:
+    if (rc) {
+        for (i = 0; i < set->used; ++i) {
+            free((*strs)[i]);
+        }
+        free(*strs);
+        *strs = NULL;
+    }
+    return rc;
+}
+
+/**
+ * @brief Compare 2 node sets without comparing every pair of their nodes. Equivalent to the iterative
+ * evaluation in ::moveto_op_comp().
+ *
+ * Strings of @p set1 nodes are canonized by the type of @p set2 nodes so all the nodes in @p set2 must
+ * canonize the same way. Then '=' is evaluated using a hash table of @p set2 strings, '!=' by looking for
+ * any distinct strings, and the relational operators by comparing the extreme numeric values of both sets.
+ *
+ * @param[in] set1 First node set.
+ * @param[in] set2 Second node set.
+ * @param[in] op Comparison operator to process.
+ * @param[out] result Result of the comparison.
+ * @return LY_SUCCESS on success,
+ * @return LY_ENOT if the node sets cannot be compared this way,
+ * @return LY_ERR on error.
+ */
+static LY_ERR
+moveto_op_comp_node_sets(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, ly_bool *result)
+{
+    LY_ERR rc = LY_SUCCESS;
+    const struct lyxp_set_node *xp_node, *canon_node = NULL;
+    const struct lysc_type *type, *canon_type = NULL;
+    char **strs1 = NULL, **strs2 = NULL;
+    struct hash_table *ht = NULL;
+    long double num, min1 = NAN, max1 = NAN, min2 = NAN, max2 = NAN;
+    uint32_t i, hash;
+
+    *result = 0;
+    if (!set1->used || !set2->used) {
+        /* no pairs to compare */
+        return LY_SUCCESS;
+    }
+
+    /* learn how the strings will be canonized */
+    for (i = 0; i < set2->used; ++i) {
+        xp_node = &set2->val.nodes[i];
+        if (xp_node->type == LYXP_NODE_META) {
+            return LY_ENOT;
+        }
+
+        type = NULL;
+        if ((xp_node->type == LYXP_NODE_ELEM) && (xp_node->node->schema->nodetype & LYD_NODE_TERM)) {
+            type = ((struct lyd_node_term *)xp_node->node)->value.realtype;
+        }
+
+        if (!i) {
+            canon_node = type ? xp_node : NULL;
+            canon_type = type;
+        } else if ((type != canon_type) || (type && (xp_node->node->schema != canon_node->node->schema))) {
+            /* different canonization */
+            return LY_ENOT;
+        }
+    }
+
+    LY_CHECK_GOTO(rc = set_comp_cast_all(set1, canon_node, &strs1), cleanup);
+    LY_CHECK_GOTO(rc = set_comp_cast_all(set2, NULL, &strs2), cleanup);
+
+    if ((op[0] == '=') && (set1->used == 1)) {
+        /* look for the single set1 string */
+        for (i = 0; !*result && (i < set2->used); ++i) {
+            *result = strcmp(strs1[0], strs2[i]) ? 0 : 1;
+        }
+    } else if (op[0] == '=') {
+        /* hash set2 strings and look for any set1 string */
+        ht = lyht_new(LYHT_MIN_SIZE, sizeof *strs2, set_comp_str_equal_cb, NULL, 1);
+        LY_CHECK_ERR_GOTO(!ht, LOGMEM(set1->ctx); rc = LY_EMEM, cleanup);
+        for (i = 0; i < set2->used; ++i) {
+            hash = dict_hash(strs2[i], strlen(strs2[i]));
+            rc = lyht_insert(ht, &strs2[i], hash, NULL);
+            if (rc == LY_EEXIST) {
+                rc = LY_SUCCESS;
+            }
+            LY_CHECK_GOTO(rc, cleanup);
+        }
+
+        for (i = 0; !*result && (i < set1->used); ++i) {
+            hash = dict_hash(strs1[i], strlen(strs1[i]));
+            *result = lyht_find(ht, &strs1[i], hash, NULL) ? 0 : 1;
+        }
+    } else if (op[0] == '!') {
+        /* any 2 different strings in set2 or any set1 string different from the single set2 string */
+        for (i = 1; !*result && (i < set2->used); ++i) {
+            *result = strcmp(strs2[0], strs2[i]) ? 1 : 0;
+        }
+        for (i = 0; !*result && (i < set1->used); ++i) {
+            *result = strcmp(strs1[i], strs2[0]) ? 1 : 0;
+        }
+    } else {
+        /* find the extreme numbers, NaN is never compared as true */
+        for (i = 0; i < set1->used; ++i) {
+            num = cast_string_to_number(strs1[i]);
+            if (!isnan(num)) {
+                min1 = (isnan(min1) || (num < min1)) ? num : min1;
+                max1 = (isnan(max1) || (num > max1)) ? num : max1;
+            }
+        }
+        for (i = 0; i < set2->used; ++i) {
+            num = cast_string_to_number(strs2[i]);
+            if (!isnan(num)) {
+                min2 = (isnan(min2) || (num < min2)) ? num : min2;
+                max2 = (isnan(max2) || (num > max2)) ? num : max2;
+            }
+        }
+
+        if (op[0] == '<') {
+            if (op[1] == '=') {
+                *result = (min1 <= max2);
+            } else {
+                *result = (min1 < max2);
+            }
+        } else {
+            if (op[1] == '=') {
+                *result = (max1 >= min2);
+            } else {
+                *result = (max1 > min2);
+            }
+        }
+    }
+
+cleanup:
+    lyht_free(ht);
+    if (strs1) {
+        for (i = 0; i < set1->used; ++i) {
+            free(strs1[i]);
+        }
+        free(strs1);
+    }
+    if (strs2) {
+        for (i = 0; i < set2->used; ++i) {
+            free(strs2[i]);
+        }
+        free(strs2);
+    }
+    return rc;
+}
+
+/**
+ * @brief Evaluate a comparison of a numeric value and a number.
+ *
+ * @param[in] cmp Result of ::num_value_cmp() of the first and the second operand.
+ * @param[in] op Comparison operator to process.
+ * @return Result of the comparison.
+ */
+static ly_bool
+moveto_op_comp_num(int cmp, const char *op)
+{
+    if (cmp == 2) {
+        /* NaN */
+        return (op[0] == '!') ? 1 : 0;
+    }
+
+    switch (op[0]) {
+    case '=':
+        return !cmp;
+    case '!':
+        return cmp ? 1 : 0;
+    case '<':
+        return (op[1] == '=') ? (cmp <= 0) : (cmp < 0);
+    default:
+        return (op[1] == '=') ? (cmp >= 0) : (cmp > 0);
+    }
+}
+
+/**
+ * @brief Move context @p set to the result of a comparison. Handles '=', '!=', '<=', '<', '>=', or '>'.
+ *        Result is LYXP_SET_BOOLEAN. Indirectly context position aware.
+ *
+ * @param[in,out] set1 Set to use for the result.
+ * @param[in] set2 Set acting as the second operand for @p op.
+ * @param[in] op Comparison operator to process.
+ * @param[in] options XPath options.
+ * @return LY_ERR
+ */
+static LY_ERR
+moveto_op_comp(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, uint32_t options)
+{
+    /*
+     * NODE SET + NODE SET = NODE SET + STRING /(1 NODE SET) 2 STRING
+     * NODE SET + STRING = STRING + STRING     /1 STRING (2 STRING)
+     * NODE SET + NUMBER = NUMBER + NUMBER     /1 NUMBER (2 NUMBER)
+     * NODE SET + BOOLEAN = BOOLEAN + BOOLEAN  /1 BOOLEAN (2 BOOLEAN)
+     * STRING + NODE SET = STRING + STRING     /(1 STRING) 2 STRING
+     * NUMBER + NODE SET = NUMBER + NUMBER     /(1 NUMBER) 2 NUMBER
+     * BOOLEAN + NODE SET = BOOLEAN + BOOLEAN  /(1 BOOLEAN) 2 BOOLEAN
+     *
+     * '=' or '!='
+     * BOOLEAN + BOOLEAN
+     * BOOLEAN + STRING = BOOLEAN + BOOLEAN    /(1 BOOLEAN) 2 BOOLEAN
+     * BOOLEAN + NUMBER = BOOLEAN + BOOLEAN    /(1 BOOLEAN) 2 BOOLEAN
+     * STRING + BOOLEAN = BOOLEAN + BOOLEAN    /1 BOOLEAN (2 BOOLEAN)
+     * NUMBER + BOOLEAN = BOOLEAN + BOOLEAN    /1 BOOLEAN (2 BOOLEAN)
+     * NUMBER + NUMBER
+     * NUMBER + STRING = NUMBER + NUMBER       /(1 NUMBER) 2 NUMBER
+     * STRING + NUMBER = NUMBER + NUMBER       /1 NUMBER (2 NUMBER)
+     * STRING + STRING
+     *
+     * '<=', '<', '>=', '>'
+     * NUMBER + NUMBER
+     * BOOLEAN + BOOLEAN = NUMBER + NUMBER     /1 NUMBER, 2 NUMBER
      * BOOLEAN + NUMBER = NUMBER + NUMBER      /1 NUMBER (2 NUMBER)
      * BOOLEAN + STRING = NUMBER + NUMBER      /1 NUMBER, 2 NUMBER
      * NUMBER + STRING = NUMBER + NUMBER       /(1 NUMBER) 2 NUMBER
@@ -6590,17 +7191,38 @@ moveto_op_comp(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, uin
      * STRING + BOOLEAN = NUMBER + NUMBER      /(1 NUMBER) 2 NUMBER
      */
     struct lyxp_set iter1, iter2;
-    int result;
+    const struct lyd_value *val;
+    int result, cmp;
     int64_t i;
+    ly_bool join_result;
     LY_ERR rc;
 
     memset(&iter1, 0, sizeof iter1);
     memset(&iter2, 0, sizeof iter2);
 
+    /* joined evaluation of 2 node-sets */
+    if ((set1->type == LYXP_SET_NODE_SET) && (set2->type == LYXP_SET_NODE_SET)) {
+        rc = moveto_op_comp_node_sets(set1, set2, op, &join_result);
+        if (rc != LY_ENOT) {
+            LY_CHECK_RET(rc);
+            set_fill_boolean(set1, join_result);
+            return LY_SUCCESS;
+        }
+    }
+
     /* iterative evaluation with node-sets */
     if ((set1->type == LYXP_SET_NODE_SET) || (set2->type == LYXP_SET_NODE_SET)) {
         if (set1->type == LYXP_SET_NODE_SET) {
             for (i = 0; i < set1->used; ++i) {
+                if ((set2->type == LYXP_SET_NUMBER) && (val = set_node_num_value(set1, i))) {
+                    /* compare the stored numeric value directly, no canonization needed */
+                    if (moveto_op_comp_num(num_value_cmp(val, set2->val.num), op)) {
+                        set_fill_boolean(set1, 1);
+                        return LY_SUCCESS;
+                    }
+                    continue;
+                }
+
                 /* cast set1 */
                 switch (set2->type) {
                 case LYXP_SET_NUMBER:
@@ -6631,6 +7253,16 @@ moveto_op_comp(struct lyxp_set *set1, struct lyxp_set *set2, const char *op, uin
             }
         } else {
             for (i = 0; i < set2->used; ++i) {
+                if ((set1->type == LYXP_SET_NUMBER) && (val = set_node_num_value(set2, i))) {
+                    /* compare the stored numeric value directly, with the operands swapped */
+                    cmp = num_value_cmp(val, set1->val.num);
+                    if (moveto_op_comp_num((cmp == 2) ? cmp : -cmp, op)) {
+                        set_fill_boolean(set1, 1);
+                        return LY_SUCCESS;
+                    }
+                    continue;
+                }
+
                 /* set set2 */
                 switch (set1->type) {
                 case LYXP_SET_NUMBER:
@@ -6795,6 +7427,20 @@ moveto_op_math(struct lyxp_set *set1, struct lyxp_set *set2, const char *op)
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Check whether a path ends before a token so that no more predicates or steps follow.
+ *
+ * @param[in] exp Parsed XPath expression.
+ * @param[in] tok_idx Index of the token following a step or a predicate in @p exp.
+ * @return Whether the path ends.
+ */
+static ly_bool
+eval_is_last_step(const struct lyxp_expr *exp, uint16_t tok_idx)
+{
+    return lyxp_check_token(NULL, exp, tok_idx, LYXP_TOKEN_BRACK1) &&
+           exp_check_token2(NULL, exp, tok_idx, LYXP_TOKEN_OPER_PATH, LYXP_TOKEN_OPER_RPATH);
+}
+
 /**
  * @brief Evaluate Predicate. Logs directly on error.
  *
@@ -6856,7 +7502,8 @@ only_parse:
             set2.ctx_size = orig_size;
             *tok_idx = orig_exp;
 
-            rc = eval_expr_select(exp, tok_idx, 0, &set2, options);
+            /* a node-set result is only cast to boolean */
+            rc = eval_expr_select(exp, tok_idx, 0, &set2, options | LYXP_EXISTS);
             if (rc != LY_SUCCESS) {
                 lyxp_set_free_content(&set2);
                 return rc;
@@ -6875,6 +7522,11 @@ only_parse:
             /* predicate satisfied or not? */
             if (!set2.val.bln) {
                 set_remove_node_none(set, i);
+            } else if ((options & LYXP_EXISTS) && eval_is_last_step(exp, *tok_idx + 1)) {
+                /* last predicate of the path, the first satisfying node is enough */
+                for (++i; i < set->used; ++i) {
+                    set_remove_node_none(set, i);
+                }
             }
         }
         set_remove_nodes_none(set);
@@ -7206,6 +7858,32 @@ eval_name_test_scnode_no_match_msg(struct lyxp_set *set, const struct lyxp_set_s
     free(ppath);
 }
 
+/**
+ * @brief Get the pre-resolved NameTest token, if it can be used in the current context.
+ *
+ * @param[in] exp Parsed XPath expression.
+ * @param[in] tok_idx Index of the NameTest token in @p exp.
+ * @param[in] set Set with general XPath context.
+ * @return Pre-resolved token, NULL if it must be resolved.
+ */
+static const struct lyxp_expr_tok *
+eval_name_test_get_res(const struct lyxp_expr *exp, uint16_t tok_idx, const struct lyxp_set *set)
+{
+    const struct lyxp_expr_tok *tok;
+
+    if (!exp->tok_res || (set->format != LY_VALUE_SCHEMA_RESOLVED) || (set->prefix_data != exp->res_prefix_data)) {
+        return NULL;
+    }
+
+    tok = &exp->tok_res[tok_idx];
+    if (!tok->name || (tok->mod && !tok->mod->implemented)) {
+        /* not resolved or the module needs to be checked again */
+        return NULL;
+    }
+
+    return tok;
+}
+
 /**
  * @brief Evaluate NameTest and any following Predicates. Logs directly on error.
  *
@@ -7228,11 +7906,13 @@ eval_name_test_with_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, ly
     LY_ERR rc = LY_SUCCESS, r;
     const char *ncname, *ncname_dict = NULL;
     uint16_t ncname_len;
+    const struct lyxp_expr_tok *tok = NULL;
     const struct lys_module *moveto_mod = NULL;
     const struct lysc_node *scnode = NULL;
     struct ly_path_predicate *predicates = NULL;
     enum ly_path_pred_type pred_type = 0;
     int scnode_skip_pred = 0;
+    uint32_t moveto_opts = options;
 
     LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, (options & LYXP_SKIP_EXPR ? "skipped" : "parsed"),
             lyxp_print_token(exp->tokens[*tok_idx]), exp->tok_pos[*tok_idx]);
@@ -7250,9 +7930,16 @@ eval_name_test_with_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, ly
         goto moveto;
     }
 
-    /* parse (and skip) module name */
-    rc = moveto_resolve_model(&ncname, &ncname_len, set, NULL, &moveto_mod);
-    LY_CHECK_GOTO(rc, cleanup);
+    if ((tok = eval_name_test_get_res(exp, *tok_idx - 1, set))) {
+        /* use the pre-resolved module, only skip the prefix */
+        moveto_mod = tok->mod ? tok->mod : set->cur_mod;
+        ncname += ncname_len - strlen(tok->name);
+        ncname_len = strlen(tok->name);
+    } else {
+        /* parse (and skip) module name */
+        rc = moveto_resolve_model(&ncname, &ncname_len, set, NULL, &moveto_mod);
+        LY_CHECK_GOTO(rc, cleanup);
+    }
 
     if (((set->format == LY_VALUE_JSON) || moveto_mod) && !attr_axis && !all_desc && (set->type == LYXP_SET_NODE_SET)) {
         /* find the matching schema node in some parent in the context */
@@ -7278,7 +7965,11 @@ eval_name_test_with_predicate(const struct lyxp_expr *exp, uint16_t *tok_idx, ly
     if (!scnode) {
         /* we are not able to match based on a schema node and not all the modules match ("*"),
          * use dictionary for efficient comparison */
-        LY_CHECK_GOTO(rc = lydict_insert(set->ctx, ncname, ncname_len, &ncname_dict), cleanup);
+        if (tok) {
+            ncname_dict = tok->name;
+        } else {
+            LY_CHECK_GOTO(rc = lydict_insert(set->ctx, ncname, ncname_len, &ncname_dict), cleanup);
+        }
     }
 
 moveto:
@@ -7343,11 +8034,15 @@ moveto:
             if (all_desc) {
                 rc = moveto_node_alldesc(set, moveto_mod, ncname_dict, options);
             } else {
+                if (!eval_is_last_step(exp, *tok_idx)) {
+                    /* the following steps or predicates need all the nodes */
+                    moveto_opts &= ~LYXP_EXISTS;
+                }
                 if (scnode) {
                     /* we can find the nodes using hashes */
-                    rc = moveto_node_hash(set, scnode, predicates, options);
+                    rc = moveto_node_hash(set, scnode, predicates, moveto_opts);
                 } else {
-                    rc = moveto_node(set, moveto_mod, ncname_dict, options);
+                    rc = moveto_node(set, moveto_mod, ncname_dict, moveto_opts);
                 }
             }
             LY_CHECK_GOTO(rc, cleanup);
@@ -7371,7 +8066,9 @@ cleanup:
         options &= ~LYXP_SKIP_EXPR;
     }
     if (!(options & LYXP_SKIP_EXPR)) {
-        lydict_remove(set->ctx, ncname_dict);
+        if (!tok) {
+            lydict_remove(set->ctx, ncname_dict);
+        }
         ly_path_predicates_free(set->ctx, pred_type, predicates);
     }
     return rc;
@@ -7608,6 +8305,130 @@ eval_absolute_location_path(const struct lyxp_expr *exp, uint16_t *tok_idx, stru
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Resolve an XPath function name to its callback.
+ *
+ * @param[in] name Function name.
+ * @param[in] name_len Length of @p name.
+ * @return Function callback, NULL if there is no such function.
+ */
+static lyxp_func_clb
+xpath_func_resolve(const char *name, uint16_t name_len)
+{
+    switch (name_len) {
+    case 3:
+        if (!strncmp(name, "not", 3)) {
+            return &xpath_not;
+        } else if (!strncmp(name, "sum", 3)) {
+            return &xpath_sum;
+        }
+        break;
+    case 4:
+        if (!strncmp(name, "lang", 4)) {
+            return &xpath_lang;
+        } else if (!strncmp(name, "last", 4)) {
+            return &xpath_last;
+        } else if (!strncmp(name, "name", 4)) {
+            return &xpath_name;
+        } else if (!strncmp(name, "true", 4)) {
+            return &xpath_true;
+        }
+        break;
+    case 5:
+        if (!strncmp(name, "count", 5)) {
+            return &xpath_count;
+        } else if (!strncmp(name, "false", 5)) {
+            return &xpath_false;
+        } else if (!strncmp(name, "floor", 5)) {
+            return &xpath_floor;
+        } else if (!strncmp(name, "round", 5)) {
+            return &xpath_round;
+        } else if (!strncmp(name, "deref", 5)) {
+            return &xpath_deref;
+        }
+        break;
+    case 6:
+        if (!strncmp(name, "concat", 6)) {
+            return &xpath_concat;
+        } else if (!strncmp(name, "number", 6)) {
+            return &xpath_number;
+        } else if (!strncmp(name, "string", 6)) {
+            return &xpath_string;
+        }
+        break;
+    case 7:
+        if (!strncmp(name, "boolean", 7)) {
+            return &xpath_boolean;
+        } else if (!strncmp(name, "ceiling", 7)) {
+            return &xpath_ceiling;
+        } else if (!strncmp(name, "current", 7)) {
+            return &xpath_current;
+        }
+        break;
+    case 8:
+        if (!strncmp(name, "contains", 8)) {
+            return &xpath_contains;
+        } else if (!strncmp(name, "position", 8)) {
+            return &xpath_position;
+        } else if (!strncmp(name, "re-match", 8)) {
+            return &xpath_re_match;
+        }
+        break;
+    case 9:
+        if (!strncmp(name, "substring", 9)) {
+            return &xpath_substring;
+        } else if (!strncmp(name, "translate", 9)) {
+            return &xpath_translate;
+        }
+        break;
+    case 10:
+        if (!strncmp(name, "local-name", 10)) {
+            return &xpath_local_name;
+        } else if (!strncmp(name, "enum-value", 10)) {
+            return &xpath_enum_value;
+        } else if (!strncmp(name, "bit-is-set", 10)) {
+            return &xpath_bit_is_set;
+        }
+        break;
+    case 11:
+        if (!strncmp(name, "starts-with", 11)) {
+            return &xpath_starts_with;
+        }
+        break;
+    case 12:
+        if (!strncmp(name, "derived-from", 12)) {
+            return &xpath_derived_from;
+        }
+        break;
+    case 13:
+        if (!strncmp(name, "namespace-uri", 13)) {
+            return &xpath_namespace_uri;
+        } else if (!strncmp(name, "string-length", 13)) {
+            return &xpath_string_length;
+        }
+        break;
+    case 15:
+        if (!strncmp(name, "normalize-space", 15)) {
+            return &xpath_normalize_space;
+        } else if (!strncmp(name, "substring-after", 15)) {
+            return &xpath_substring_after;
+        }
+        break;
+    case 16:
+        if (!strncmp(name, "substring-before", 16)) {
+            return &xpath_substring_before;
+        }
+        break;
+    case 20:
+        if (!strncmp(name, "derived-from-or-self", 20)) {
+            return &xpath_derived_from_or_self;
+        }
+        break;
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Evaluate FunctionCall. Logs directly on error.
  *
@@ -7623,122 +8444,17 @@ static LY_ERR
 eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *set, uint32_t options)
 {
     LY_ERR rc;
-
-    LY_ERR (*xpath_func)(struct lyxp_set **, uint16_t, struct lyxp_set *, uint32_t) = NULL;
+    lyxp_func_clb xpath_func = NULL;
     uint16_t arg_count = 0, i;
     struct lyxp_set **args = NULL, **args_aux;
+    uint32_t arg_opts;
 
     if (!(options & LYXP_SKIP_EXPR)) {
         /* FunctionName */
-        switch (exp->tok_len[*tok_idx]) {
-        case 3:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "not", 3)) {
-                xpath_func = &xpath_not;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "sum", 3)) {
-                xpath_func = &xpath_sum;
-            }
-            break;
-        case 4:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "lang", 4)) {
-                xpath_func = &xpath_lang;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "last", 4)) {
-                xpath_func = &xpath_last;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "name", 4)) {
-                xpath_func = &xpath_name;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "true", 4)) {
-                xpath_func = &xpath_true;
-            }
-            break;
-        case 5:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "count", 5)) {
-                xpath_func = &xpath_count;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "false", 5)) {
-                xpath_func = &xpath_false;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "floor", 5)) {
-                xpath_func = &xpath_floor;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "round", 5)) {
-                xpath_func = &xpath_round;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "deref", 5)) {
-                xpath_func = &xpath_deref;
-            }
-            break;
-        case 6:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "concat", 6)) {
-                xpath_func = &xpath_concat;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "number", 6)) {
-                xpath_func = &xpath_number;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "string", 6)) {
-                xpath_func = &xpath_string;
-            }
-            break;
-        case 7:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "boolean", 7)) {
-                xpath_func = &xpath_boolean;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "ceiling", 7)) {
-                xpath_func = &xpath_ceiling;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "current", 7)) {
-                xpath_func = &xpath_current;
-            }
-            break;
-        case 8:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "contains", 8)) {
-                xpath_func = &xpath_contains;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "position", 8)) {
-                xpath_func = &xpath_position;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "re-match", 8)) {
-                xpath_func = &xpath_re_match;
-            }
-            break;
-        case 9:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "substring", 9)) {
-                xpath_func = &xpath_substring;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "translate", 9)) {
-                xpath_func = &xpath_translate;
-            }
-            break;
-        case 10:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "local-name", 10)) {
-                xpath_func = &xpath_local_name;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "enum-value", 10)) {
-                xpath_func = &xpath_enum_value;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "bit-is-set", 10)) {
-                xpath_func = &xpath_bit_is_set;
-            }
-            break;
-        case 11:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "starts-with", 11)) {
-                xpath_func = &xpath_starts_with;
-            }
-            break;
-        case 12:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "derived-from", 12)) {
-                xpath_func = &xpath_derived_from;
-            }
-            break;
-        case 13:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "namespace-uri", 13)) {
-                xpath_func = &xpath_namespace_uri;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "string-length", 13)) {
-                xpath_func = &xpath_string_length;
-            }
-            break;
-        case 15:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "normalize-space", 15)) {
-                xpath_func = &xpath_normalize_space;
-            } else if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "substring-after", 15)) {
-                xpath_func = &xpath_substring_after;
-            }
-            break;
-        case 16:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "substring-before", 16)) {
-                xpath_func = &xpath_substring_before;
-            }
-            break;
-        case 20:
-            if (!strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "derived-from-or-self", 20)) {
-                xpath_func = &xpath_derived_from_or_self;
-            }
-            break;
+        if (exp->tok_res && exp->tok_res[*tok_idx].func) {
+            xpath_func = exp->tok_res[*tok_idx].func;
+        } else {
+            xpath_func = xpath_func_resolve(&exp->expr[exp->tok_pos[*tok_idx]], exp->tok_len[*tok_idx]);
         }
 
         if (!xpath_func) {
@@ -7747,6 +8463,13 @@ eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_s
         }
     }
 
+    if (!(options & LYXP_SCNODE_ALL) && ((xpath_func == xpath_not) || (xpath_func == xpath_boolean))) {
+        /* the argument is only cast to boolean */
+        arg_opts = options | LYXP_EXISTS;
+    } else {
+        arg_opts = options & ~LYXP_EXISTS;
+    }
+
     LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, (options & LYXP_SKIP_EXPR ? "skipped" : "parsed"),
             lyxp_print_token(exp->tokens[*tok_idx]), exp->tok_pos[*tok_idx]);
     ++(*tok_idx);
@@ -7769,7 +8492,7 @@ eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_s
                 goto cleanup;
             }
 
-            rc = eval_expr_select(exp, tok_idx, 0, args[0], options);
+            rc = eval_expr_select(exp, tok_idx, 0, args[0], arg_opts);
             LY_CHECK_GOTO(rc, cleanup);
         } else {
             rc = eval_expr_select(exp, tok_idx, 0, set, options | LYXP_SKIP_EXPR);
@@ -7792,7 +8515,7 @@ eval_function_call(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_s
                 goto cleanup;
             }
 
-            rc = eval_expr_select(exp, tok_idx, 0, args[arg_count - 1], options);
+            rc = eval_expr_select(exp, tok_idx, 0, args[arg_count - 1], arg_opts);
             LY_CHECK_GOTO(rc, cleanup);
         } else {
             rc = eval_expr_select(exp, tok_idx, 0, set, options | LYXP_SKIP_EXPR);
@@ -7965,8 +8688,8 @@ eval_path_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, struct lyxp_set *
                 lyxp_print_token(exp->tokens[*tok_idx]), exp->tok_pos[*tok_idx]);
         ++(*tok_idx);
 
-        /* Expr */
-        rc = eval_expr_select(exp, tok_idx, 0, set, options);
+        /* Expr, any predicates or steps that follow need all the nodes */
+        rc = eval_expr_select(exp, tok_idx, 0, set, options & ~LYXP_EXISTS);
         LY_CHECK_RET(rc);
 
         /* ')' */
@@ -8112,8 +8835,9 @@ eval_union_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, uint16_t repeat,
                 lyxp_print_token(exp->tokens[*tok_idx]), exp->tok_pos[*tok_idx]);
         ++(*tok_idx);
 
-        if (options & LYXP_SKIP_EXPR) {
-            rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_UNION, set, options);
+        /* lazy evaluation */
+        if ((options & LYXP_SKIP_EXPR) || ((options & LYXP_EXISTS) && (set->type == LYXP_SET_NODE_SET) && set->used)) {
+            rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_UNION, set, options | LYXP_SKIP_EXPR);
             LY_CHECK_GOTO(rc, cleanup);
             continue;
         }
@@ -8320,6 +9044,93 @@ cleanup:
     return rc;
 }
 
+/**
+ * @brief Evaluate "count(Expr) > 0", "count(Expr) != 0", or "count(Expr) = 0" as an existence check
+ * so that the node-set Expr may not need to be evaluated completely. Logs directly on error.
+ *
+ * @param[in] exp Parsed XPath expression.
+ * @param[in] tok_idx Position in the expression @p exp.
+ * @param[in] etype Expression type of the comparison, ::LYXP_EXPR_RELATIONAL or ::LYXP_EXPR_EQUALITY.
+ * @param[in,out] set Context and result set.
+ * @param[in] options XPath options.
+ * @return LY_ENOT if the expression does not have this form, nothing was evaluated.
+ * @return LY_ERR (LY_EINCOMPLETE on unresolved when)
+ */
+static LY_ERR
+eval_count_exists(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_type etype, struct lyxp_set *set,
+        uint32_t options)
+{
+    LY_ERR rc;
+    uint16_t par2, depth = 0;
+    ly_bool negate;
+
+    if (options & (LYXP_SKIP_EXPR | LYXP_SCNODE_ALL)) {
+        return LY_ENOT;
+    }
+
+    /* 'count' '(' */
+    if ((exp->tokens[*tok_idx] != LYXP_TOKEN_FUNCNAME) || (exp->tok_len[*tok_idx] != 5) ||
+            strncmp(&exp->expr[exp->tok_pos[*tok_idx]], "count", 5)) {
+        return LY_ENOT;
+    }
+
+    /* matching ')', the expression was parsed so it exists */
+    for (par2 = *tok_idx + 1; par2 < exp->used; ++par2) {
+        if (exp->tokens[par2] == LYXP_TOKEN_PAR1) {
+            ++depth;
+        } else if ((exp->tokens[par2] == LYXP_TOKEN_PAR2) && !--depth) {
+            break;
+        }
+    }
+    if (par2 + 2 >= exp->used) {
+        return LY_ENOT;
+    }
+
+    /* operator */
+    if (etype == LYXP_EXPR_RELATIONAL) {
+        if ((exp->tokens[par2 + 1] != LYXP_TOKEN_OPER_COMP) || (exp->tok_len[par2 + 1] != 1) ||
+                (exp->expr[exp->tok_pos[par2 + 1]] != '>')) {
+            return LY_ENOT;
+        }
+        negate = 0;
+    } else {
+        assert(etype == LYXP_EXPR_EQUALITY);
+        if (exp->tokens[par2 + 1] == LYXP_TOKEN_OPER_NEQUAL) {
+            negate = 0;
+        } else if (exp->tokens[par2 + 1] == LYXP_TOKEN_OPER_EQUAL) {
+            negate = 1;
+        } else {
+            return LY_ENOT;
+        }
+    }
+
+    /* '0' being the whole second operand */
+    if ((exp->tokens[par2 + 2] != LYXP_TOKEN_NUMBER) || (exp->tok_len[par2 + 2] != 1) ||
+            (exp->expr[exp->tok_pos[par2 + 2]] != '0') || exp->repeat[par2 + 2] || !eval_is_last_step(exp, par2 + 3)) {
+        return LY_ENOT;
+    }
+
+    LOGDBG(LY_LDGXPATH, "%-27s %s %s[%u]", __func__, "parsed", lyxp_print_token(exp->tokens[*tok_idx]),
+            exp->tok_pos[*tok_idx]);
+    *tok_idx += 2;
+
+    /* Expr, only its existence matters */
+    rc = eval_expr_select(exp, tok_idx, 0, set, options | LYXP_EXISTS);
+    LY_CHECK_RET(rc);
+    assert(*tok_idx == par2);
+
+    if (set->type != LYXP_SET_NODE_SET) {
+        LOGVAL(set->ctx, LY_VCODE_XP_INARGTYPE, 1, print_set_type(set), "count(node-set)");
+        return LY_EVALID;
+    }
+
+    /* ')' operator '0' */
+    *tok_idx += 3;
+
+    set_fill_boolean(set, negate ? !set->used : (set->used > 0));
+    return LY_SUCCESS;
+}
+
 /**
  * @brief Evaluate RelationalExpr. Logs directly on error.
  *
@@ -8351,11 +9162,18 @@ eval_relational_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, uint16_t re
 
     set_fill_set(&orig_set, set);
 
-    rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_RELATIONAL, set, options);
+    i = 0;
+    rc = eval_count_exists(exp, tok_idx, LYXP_EXPR_RELATIONAL, set, options);
+    if (!rc) {
+        /* the first comparison was evaluated */
+        ++i;
+    } else if (rc == LY_ENOT) {
+        rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_RELATIONAL, set, options);
+    }
     LY_CHECK_GOTO(rc, cleanup);
 
     /* ('<' / '>' / '<=' / '>=' AdditiveExpr)* */
-    for (i = 0; i < repeat; ++i) {
+    for ( ; i < repeat; ++i) {
         this_op = *tok_idx;
 
         assert(exp->tokens[*tok_idx] == LYXP_TOKEN_OPER_COMP);
@@ -8418,11 +9236,18 @@ eval_equality_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, uint16_t repe
 
     set_fill_set(&orig_set, set);
 
-    rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_EQUALITY, set, options);
+    i = 0;
+    rc = eval_count_exists(exp, tok_idx, LYXP_EXPR_EQUALITY, set, options);
+    if (!rc) {
+        /* the first comparison was evaluated */
+        ++i;
+    } else if (rc == LY_ENOT) {
+        rc = eval_expr_select(exp, tok_idx, LYXP_EXPR_EQUALITY, set, options);
+    }
     LY_CHECK_GOTO(rc, cleanup);
 
     /* ('=' / '!=' RelationalExpr)* */
-    for (i = 0; i < repeat; ++i) {
+    for ( ; i < repeat; ++i) {
         this_op = *tok_idx;
 
         assert((exp->tokens[*tok_idx] == LYXP_TOKEN_OPER_EQUAL) || (exp->tokens[*tok_idx] == LYXP_TOKEN_OPER_NEQUAL));
@@ -8480,6 +9305,11 @@ eval_and_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, uint16_t repeat, s
 
     assert(repeat);
 
+    if (!(options & LYXP_SCNODE_ALL)) {
+        /* all the operands are only cast to boolean */
+        options |= LYXP_EXISTS;
+    }
+
     set_init(&orig_set, set);
     set_init(&set2, set);
 
@@ -8550,6 +9380,11 @@ eval_or_expr(const struct lyxp_expr *exp, uint16_t *tok_idx, uint16_t repeat, st
 
     assert(repeat);
 
+    if (!(options & LYXP_SCNODE_ALL)) {
+        /* all the operands are only cast to boolean */
+        options |= LYXP_EXISTS;
+    }
+
     set_init(&orig_set, set);
     set_init(&set2, set);
 
@@ -8636,6 +9471,12 @@ eval_expr_select(const struct lyxp_expr *exp, uint16_t *tok_idx, enum lyxp_expr_
         }
     }
 
+    if ((next_etype != LYXP_EXPR_OR) && (next_etype != LYXP_EXPR_AND) && (next_etype != LYXP_EXPR_UNION) &&
+            (next_etype != LYXP_EXPR_NONE)) {
+        /* operators using the values of the operands */
+        options &= ~LYXP_EXISTS;
+    }
+
     /* decide what expression are we parsing based on the repeat */
     switch (next_etype) {
     case LYXP_EXPR_OR:
@@ -8713,12 +9554,203 @@ lyxp_get_root_type(const struct lyd_node *ctx_node, const struct lysc_node *ctx_
     return LYXP_NODE_ROOT;
 }
 
+/**
+ * @brief Learn the dependency of a compiled expression on its context node.
+ *
+ * Any location path not in a predicate must be absolute or start with '..', context node functions
+ * (such as current() or string() without arguments) must not be used.
+ *
+ * @param[in] exp Compiled expression.
+ * @return Context dependency of @p exp.
+ */
+static enum lyxp_ctx_dep
+lyxp_expr_ctx_dep(const struct lyxp_expr *exp)
+{
+    enum lyxp_ctx_dep dep = LYXP_CTX_DEP_NONE;
+    uint32_t depth = 0;
+    lyxp_func_clb func;
+    uint16_t i;
+
+    for (i = 0; i < exp->used; ++i) {
+        switch (exp->tokens[i]) {
+        case LYXP_TOKEN_BRACK1:
+            ++depth;
+            break;
+        case LYXP_TOKEN_BRACK2:
+            --depth;
+            break;
+        case LYXP_TOKEN_FUNCNAME:
+            func = exp->tok_res[i].func;
+            if ((func == xpath_current) || (!depth && (func == xpath_lang))) {
+                /* always uses the context node */
+                return LYXP_CTX_DEP_NODE;
+            }
+            if (!depth && (exp->tokens[i + 2] == LYXP_TOKEN_PAR2) && ((func == xpath_last) ||
+                    (func == xpath_position) || (func == xpath_local_name) || (func == xpath_namespace_uri) ||
+                    (func == xpath_name) || (func == xpath_string) || (func == xpath_string_length) ||
+                    (func == xpath_normalize_space) || (func == xpath_number))) {
+                /* uses the context node without arguments */
+                return LYXP_CTX_DEP_NODE;
+            }
+            break;
+        case LYXP_TOKEN_DOT:
+        case LYXP_TOKEN_DDOT:
+        case LYXP_TOKEN_AT:
+        case LYXP_TOKEN_NAMETEST:
+        case LYXP_TOKEN_NODETYPE:
+            if (depth || (i && ((exp->tokens[i - 1] == LYXP_TOKEN_OPER_PATH) ||
+                    (exp->tokens[i - 1] == LYXP_TOKEN_OPER_RPATH) || (exp->tokens[i - 1] == LYXP_TOKEN_AT)))) {
+                /* relative to a predicate context or not the first step */
+                break;
+            }
+
+            if (exp->tokens[i] != LYXP_TOKEN_DDOT) {
+                /* relative location path */
+                return LYXP_CTX_DEP_NODE;
+            }
+
+            /* location path relative to the parent */
+            dep = LYXP_CTX_DEP_PARENT;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return dep;
+}
+
+LY_ERR
+lyxp_expr_compile(const struct ly_ctx *ctx, struct lyxp_expr *exp, const void *prefix_data)
+{
+    struct lyxp_expr_tok *tok;
+    const char *name, *ptr;
+    uint16_t i, name_len;
+
+    assert(!exp->tok_res);
+
+    if (!exp->used) {
+        return LY_SUCCESS;
+    }
+
+    exp->tok_res = calloc(exp->used, sizeof *exp->tok_res);
+    LY_CHECK_ERR_RET(!exp->tok_res, LOGMEM(ctx), LY_EMEM);
+    exp->res_prefix_data = prefix_data;
+
+    for (i = 0; i < exp->used; ++i) {
+        tok = &exp->tok_res[i];
+        name = &exp->expr[exp->tok_pos[i]];
+        name_len = exp->tok_len[i];
+
+        if (exp->tokens[i] == LYXP_TOKEN_FUNCNAME) {
+            /* unknown function is an error during evaluation */
+            tok->func = xpath_func_resolve(name, name_len);
+        } else if ((exp->tokens[i] == LYXP_TOKEN_NAMETEST) && ((name[0] != '*') || (name_len != 1))) {
+            if ((ptr = ly_strnchr(name, ':', name_len))) {
+                /* unknown prefix is an error during evaluation */
+                tok->mod = ly_resolve_prefix(ctx, name, ptr - name, LY_VALUE_SCHEMA_RESOLVED, prefix_data);
+                if (!tok->mod) {
+                    continue;
+                }
+
+                name_len -= ptr - name + 1;
+                name = ptr + 1;
+            }
+
+            LY_CHECK_RET(lydict_insert(ctx, name, name_len, &tok->name));
+        }
+    }
+
+    exp->ctx_dep = lyxp_expr_ctx_dep(exp);
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Check whether an expression can reach its context node only using the self step or current().
+ *
+ * @param[in] exp Parsed expression.
+ * @param[in] ctx_scnode Context node of @p exp.
+ * @return Whether no other instances of @p ctx_scnode can be reached.
+ */
+static ly_bool
+lyxp_expr_ctx_self_only(const struct lyxp_expr *exp, const struct lysc_node *ctx_scnode)
+{
+    const char *name, *ptr;
+    uint16_t len;
+    uint32_t i;
+
+    for (i = 0; i < exp->used; ++i) {
+        name = exp->expr + exp->tok_pos[i];
+        len = exp->tok_len[i];
+
+        switch (exp->tokens[i]) {
+        case LYXP_TOKEN_NAMETEST:
+            if ((ptr = ly_strnchr(name, ':', len))) {
+                len -= ptr + 1 - name;
+                name = ptr + 1;
+            }
+            if (((len == 1) && (name[0] == '*')) || !ly_strncmp(ctx_scnode->name, name, len)) {
+                /* any node or a node with the same name */
+                return 0;
+            }
+            break;
+        case LYXP_TOKEN_NODETYPE:
+        case LYXP_TOKEN_OPER_RPATH:
+            /* any node */
+            return 0;
+        case LYXP_TOKEN_FUNCNAME:
+            if ((len == 5) && !strncmp(name, "deref", 5)) {
+                /* referenced node */
+                return 0;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return 1;
+}
+
+LY_ERR
+lyxp_expr_set_atoms(const struct ly_ctx *ctx, struct lyxp_expr *exp, const struct lysc_node *ctx_scnode,
+        const struct lyxp_set *set)
+{
+    struct lyxp_expr_atom *atom;
+    ly_bool self_only;
+    uint32_t i;
+
+    assert(set->type == LYXP_SET_SCNODE_SET);
+
+    LY_ARRAY_FREE(exp->atoms);
+    exp->atoms = NULL;
+    exp->atomized = 0;
+    self_only = ctx_scnode ? lyxp_expr_ctx_self_only(exp, ctx_scnode) : 0;
+
+    for (i = 0; i < set->used; ++i) {
+        if ((set->val.scnodes[i].type != LYXP_NODE_ELEM) || (set->val.scnodes[i].in_ctx == LYXP_SET_SCNODE_START) ||
+                (set->val.scnodes[i].in_ctx == LYXP_SET_SCNODE_START_USED)) {
+            /* skip roots and the context node only used as the starting point */
+            continue;
+        }
+
+        LY_ARRAY_NEW_RET(ctx, exp->atoms, atom, LY_EMEM);
+        atom->scnode = set->val.scnodes[i].scnode;
+        atom->val = (set->val.scnodes[i].in_ctx == LYXP_SET_SCNODE_ATOM_VAL) ? 1 : 0;
+        atom->self = (self_only && (atom->scnode == ctx_scnode)) ? 1 : 0;
+    }
+
+    exp->atomized = 1;
+    return LY_SUCCESS;
+}
+
 LY_ERR
 lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct lys_module *cur_mod,
         LY_VALUE_FORMAT format, void *prefix_data, const struct lyd_node *ctx_node, const struct lyd_node *tree,
         const struct lyxp_var *vars, struct lyxp_set *set, uint32_t options)
 {
     uint16_t tok_idx = 0;
+    struct lyxp_set_pool pool;
     LY_ERR rc;
 
     LY_CHECK_ARG_RET(ctx, ctx, exp, set, LY_EINVAL);
@@ -8727,6 +9759,11 @@ lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct ly
         return LY_EINVAL;
     }
 
+    /* the inline buffers need no initialization */
+    pool.slots_used = 0;
+    pool.buf_count = 0;
+    pool.ht_count = 0;
+
     if (tree) {
         /* adjust the pointer to be the first top-level sibling */
         while (tree->parent) {
@@ -8739,6 +9776,7 @@ lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct ly
     memset(set, 0, sizeof *set);
     set->type = LYXP_SET_NODE_SET;
     set->root_type = lyxp_get_root_type(ctx_node, NULL, options);
+    set->pool = &pool;
     set_insert_node(set, (struct lyd_node *)ctx_node, 0, ctx_node ? LYXP_NODE_ELEM : set->root_type, 0);
 
     set->ctx = (struct ly_ctx *)ctx;
@@ -8760,6 +9798,11 @@ lyxp_eval(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const struct ly
         lyxp_set_free_content(set);
     }
 
+    /* the result must not use the pool anymore */
+    if (set_pool_detach(set) && !rc) {
+        rc = LY_EMEM;
+    }
+
     LOG_LOCBACK(0, 1, 0, 0);
     return rc;
 }
@@ -8865,6 +9908,7 @@ lyxp_set_print_xml(FILE *f, struct lyxp_set *set)
 LY_ERR
 lyxp_set_cast(struct lyxp_set *set, enum lyxp_set_type target)
 {
+    const struct lyd_value *val;
     long double num;
     char *str;
     LY_ERR rc;
@@ -8921,6 +9965,12 @@ lyxp_set_cast(struct lyxp_set *set, enum lyxp_set_type target)
             /* we need the set sorted, it affects the result */
             assert(!set_sort(set));
 
+            if ((target == LYXP_SET_NUMBER) && set->used && (val = set_node_num_value(set, 0))) {
+                /* no need to print the numeric value */
+                set_fill_number(set, cast_num_value_to_number(val));
+                return LY_SUCCESS;
+            }
+
             rc = cast_node_set_to_string(set, &str);
             LY_CHECK_RET(rc);
             lyxp_set_free_content(set);
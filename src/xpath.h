@@ -25,6 +25,8 @@
 
 struct ly_ctx;
 struct lyd_node;
+struct lyxp_set;
+struct lyxp_set_pool;
 
 /**
  * @internal
@@ -86,6 +88,14 @@ struct lyd_node;
 #define LYXP_SET_SIZE_START 2
 #define LYXP_SET_SIZE_STEP 2
 
+/* XPath matches buffers reused during a single evaluation */
+#define LYXP_SET_POOL_SLOTS 8
+#define LYXP_SET_POOL_SLOT_SIZE 8
+#define LYXP_SET_POOL_CACHED 8
+
+/* minimal number of XPath matches to create a hash table, smaller sets are searched linearly */
+#define LYXP_SET_HT_MIN_ITEMS 32
+
 /* building string when casting */
 #define LYXP_STRING_CAST_SIZE_START 64
 #define LYXP_STRING_CAST_SIZE_STEP 16
@@ -155,6 +165,49 @@ enum lyxp_node_type {
     LYXP_NODE_META              /* YANG metadata (do not use for the context node) */
 };
 
+/**
+ * @brief XPath function callback.
+ *
+ * @param[in] args Array of arguments.
+ * @param[in] arg_count Count of elements in @p args.
+ * @param[in,out] set Context and result set at the same time.
+ * @param[in] options XPath options.
+ * @return LY_ERR
+ */
+typedef LY_ERR (*lyxp_func_clb)(struct lyxp_set **args, uint16_t arg_count, struct lyxp_set *set, uint32_t options);
+
+/**
+ * @brief Pre-resolved information about a single token, see ::lyxp_expr_compile().
+ */
+struct lyxp_expr_tok {
+    union {
+        struct {
+            const struct lys_module *mod;   /**< module of a prefixed ::LYXP_TOKEN_NAMETEST, NULL if not prefixed */
+            const char *name;               /**< node name of a ::LYXP_TOKEN_NAMETEST in the dictionary,
+                                                 NULL if not resolved */
+        };
+        lyxp_func_clb func;                 /**< callback of a ::LYXP_TOKEN_FUNCNAME, NULL if not resolved */
+    };
+};
+
+/**
+ * @brief Dependency of an expression result on its context node, learned by ::lyxp_expr_compile().
+ */
+enum lyxp_ctx_dep {
+    LYXP_CTX_DEP_NODE = 0,      /**< result may depend on the context node itself */
+    LYXP_CTX_DEP_PARENT,        /**< result depends only on the parent of the context node */
+    LYXP_CTX_DEP_NONE           /**< result does not depend on the context node */
+};
+
+/**
+ * @brief Schema node the result of an expression depends on, see ::lyxp_expr_set_atoms().
+ */
+struct lyxp_expr_atom {
+    const struct lysc_node *scnode; /**< referenced schema node */
+    ly_bool val;                    /**< whether the value of the node is used and not only its existence */
+    ly_bool self;                   /**< set for the context node if no other instance of it can be referenced */
+};
+
 /**
  * @brief Structure holding a parsed XPath expression.
  */
@@ -164,6 +217,15 @@ struct lyxp_expr {
     uint16_t *tok_len;       /**< Array of token lengths in expr. */
     enum lyxp_expr_type **repeat; /**< Array of expression types that this token begins and is repeated ended with 0,
                                        more in the comment after this declaration. */
+    struct lyxp_expr_tok *tok_res; /**< Array of pre-resolved tokens, NULL if the expression was not compiled. */
+    const void *res_prefix_data; /**< ::LY_VALUE_SCHEMA_RESOLVED prefix data the NameTest tokens in tok_res were
+                                      resolved with, they are used only when evaluating with the same data. */
+    enum lyxp_ctx_dep ctx_dep; /**< Dependency of the expression result on its context node. */
+    struct lyxp_expr_atom *atoms; /**< Schema nodes referenced by the expression ([sized array](@ref sizedarrays)),
+                                       valid only if atomized is set. */
+    ly_bool atomized;        /**< Whether atoms were learned, otherwise the expression may depend on any node. */
+    uint32_t when_order;     /**< Evaluation order of a when condition, greater than the order of all the when
+                                  conditions it depends on, 0 if not known. */
     uint16_t used;           /**< Used array items. */
     uint16_t size;           /**< Allocated array items. */
 
@@ -290,6 +352,8 @@ struct lyxp_set {
     void *prefix_data;                      /**< Format-specific prefix data (see ::ly_resolve_prefix). */
     const struct lyxp_var *vars;            /**< XPath variables. [Sized array](@ref sizedarrays).
                                                  Set of variable bindings. */
+    struct lyxp_set_pool *pool;             /**< Node buffers and hash tables reused during a single evaluation,
+                                                 NULL outside of ::lyxp_eval(). */
 };
 
 /**
@@ -350,6 +414,8 @@ LY_ERR lyxp_atomize(const struct ly_ctx *ctx, const struct lyxp_expr *exp, const
 #define LYXP_SKIP_EXPR      0x20    /**< The rest of the expression will not be evaluated (lazy evaluation) */
 #define LYXP_SCNODE_ERROR   LYS_FIND_NO_MATCH_ERROR /**< Return error if a path segment matches no nodes, otherwise only
                                                          warning is printed. */
+#define LYXP_EXISTS         0x80    /**< Only the boolean value of the result is needed so a node-set may be evaluated
+                                         only until its first node is found, cannot be used with ::LYXP_SCNODE_ALL */
 
 /**
  * @brief Cast XPath set to another type.
@@ -422,7 +488,7 @@ LY_ERR lyxp_expr_parse(const struct ly_ctx *ctx, const char *expr_str, size_t ex
         struct lyxp_expr **expr_p);
 
 /**
- * @brief Duplicate parsed XPath expression.
+ * @brief Duplicate parsed XPath expression. Pre-resolved tokens (see ::lyxp_expr_compile()) are not duplicated.
  *
  * @param[in] ctx Context with a dictionary.
  * @param[in] exp Parsed expression.
@@ -431,6 +497,35 @@ LY_ERR lyxp_expr_parse(const struct ly_ctx *ctx, const char *expr_str, size_t ex
  */
 LY_ERR lyxp_expr_dup(const struct ly_ctx *ctx, const struct lyxp_expr *exp, struct lyxp_expr **dup);
 
+/**
+ * @brief Compile a parsed XPath expression by pre-resolving its tokens so that they do not need to be resolved
+ * on every evaluation.
+ *
+ * Function names are resolved to their callbacks, NameTests to their module and node name in the dictionary.
+ * Tokens that cannot be resolved are left to be resolved during evaluation, as before. Also, the dependency
+ * of the expression on its context node is learned.
+ *
+ * @param[in] ctx Context with a dictionary.
+ * @param[in] exp Parsed expression to compile.
+ * @param[in] prefix_data ::LY_VALUE_SCHEMA_RESOLVED prefix data the expression will be evaluated with.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxp_expr_compile(const struct ly_ctx *ctx, struct lyxp_expr *exp, const void *prefix_data);
+
+/**
+ * @brief Remember the schema nodes an expression depends on from its atomized set (see ::lyxp_atomize()).
+ *
+ * The context node is not remembered unless it was also reached by a path in the expression.
+ *
+ * @param[in] ctx Context for logging.
+ * @param[in] exp Parsed expression to store the atoms in, any previous ones are replaced.
+ * @param[in] ctx_scnode Context node @p exp was atomized with, NULL for the root.
+ * @param[in] set Set returned by ::lyxp_atomize() for @p exp.
+ * @return LY_ERR value.
+ */
+LY_ERR lyxp_expr_set_atoms(const struct ly_ctx *ctx, struct lyxp_expr *exp, const struct lysc_node *ctx_scnode,
+        const struct lyxp_set *set);
+
 /**
  * @brief Look at the next token and check its kind.
  *
@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
 #include <time.h>
 
@@ -27,6 +28,14 @@
 # include <valgrind/callgrind.h>
 #endif
 
+#ifdef __GLIBC__
+# include <malloc.h>
+#endif
+
+#if defined (__GLIBC__) && !defined (__SANITIZE_ADDRESS__) && !defined (__SANITIZE_THREAD__)
+# define PERF_COUNT_ALLOC
+#endif
+
 #define TEMP_FILE "perf_tmp"
 
 /**
@@ -52,6 +61,41 @@ struct test {
     test_cb test;
 };
 
+#ifdef PERF_COUNT_ALLOC
+
+/* glibc allocator entry points, the public ones are overriden below */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+/**
+ * @brief Number of heap allocations performed by the whole process.
+ */
+static uint64_t alloc_count;
+
+void *
+malloc(size_t size)
+{
+    ++alloc_count;
+    return __libc_malloc(size);
+}
+
+void *
+calloc(size_t nmemb, size_t size)
+{
+    ++alloc_count;
+    return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+    ++alloc_count;
+    return __libc_realloc(ptr, size);
+}
+
+#endif
+
 /**
  * @brief Get current time as timespec.
  *
@@ -148,28 +192,240 @@ create_list_inst(const struct lys_module *mod, uint32_t offset, uint32_t count,
 }
 
 /**
- * @brief Execute a test.
+ * @brief Create data tree with numeric leaf-list instances.
  *
- * @param[in] setup Setup callback to call once.
- * @param[in] test Test callback.
- * @param[in] name Name of the test.
- * @param[in] mod Module of testing data.
- * @param[in] count Count of list instances, size of the testing data set.
- * @param[in] tries Number of (re)tries of the test to get more accurate measurements.
+ * @param[in] mod Module of the top-level node.
+ * @param[in] count Number of instances of each leaf-list to create.
+ * @param[out] data Created data.
  * @return LY_ERR value.
  */
 static LY_ERR
-exec_test(setup_cb setup, test_cb test, const char *name, const struct lys_module *mod, uint32_t count, uint32_t tries)
+create_num_inst(const struct lys_module *mod, uint32_t count, struct lyd_node **data)
 {
     LY_ERR ret;
-    struct timespec ts_start, ts_end;
-    struct test_state state = {0};
+    uint32_t i;
+    char val[32];
+
+    if ((ret = lyd_new_inner(NULL, mod, "stats", 0, data))) {
+        return ret;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(val, "%" PRIu64, UINT64_MAX - (uint64_t)i * 7919);
+        if ((ret = lyd_new_term(*data, NULL, "counter", val, 0, NULL))) {
+            return ret;
+        }
+
+        sprintf(val, "%" PRIu32 ".%03" PRIu32, i * 13, i % 1000);
+        if ((ret = lyd_new_term(*data, NULL, "gauge", val, 0, NULL))) {
+            return ret;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create data tree with union leaf-list instances, most of them stored as the last union type.
+ *
+ * @param[in] mod Module of the top-level node.
+ * @param[in] count Number of instances to create.
+ * @param[out] data Created data.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+create_union_inst(const struct lys_module *mod, uint32_t count, struct lyd_node **data)
+{
+    LY_ERR ret;
+    uint32_t i;
+    char val[32];
+
+    if ((ret = lyd_new_inner(NULL, mod, "unions", 0, data))) {
+        return ret;
+    }
+
+    for (i = 0; i < count; ++i) {
+        if (i % 4) {
+            sprintf(val, "eth%" PRIu32, i);
+        } else {
+            sprintf(val, "%" PRIu32, i);
+        }
+        if ((ret = lyd_new_term(*data, NULL, "val", val, 0, NULL))) {
+            return ret;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create data tree with route list instances, all of them using one of a few next-hop union values.
+ *
+ * @param[in] mod Module of the top-level node.
+ * @param[in] count Number of instances to create.
+ * @param[out] data Created data.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+create_route_inst(const struct lys_module *mod, uint32_t count, struct lyd_node **data)
+{
+    LY_ERR ret;
+    uint32_t i;
+    char prefix[32], next_hop[32], metric[32];
+    struct lyd_node *list;
+
+    if ((ret = lyd_new_inner(NULL, mod, "routes", 0, data))) {
+        return ret;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(prefix, "%" PRIu32 ".%" PRIu32 ".%" PRIu32 ".0/24", 10 + (i >> 16), (i >> 8) & 0xFF, i & 0xFF);
+        sprintf(next_hop, "192.0.2.%" PRIu32, i % 16);
+        sprintf(metric, "%" PRIu32, i % 10);
+
+        if ((ret = lyd_new_list(*data, NULL, "route", 0, &list, prefix))) {
+            return ret;
+        }
+        if ((ret = lyd_new_term(list, NULL, "next-hop", next_hop, 0, NULL))) {
+            return ret;
+        }
+        if ((ret = lyd_new_term(list, NULL, "metric", metric, 0, NULL))) {
+            return ret;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create data tree with list instances each with a chain of leaves with when depending on the previous leaf.
+ *
+ * @param[in] mod Module of the top-level node.
+ * @param[in] count Number of list instances to create.
+ * @param[out] data Created data.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+create_when_inst(const struct lys_module *mod, uint32_t count, struct lyd_node **data)
+{
+    LY_ERR ret;
+    uint32_t i, j;
+    char k_val[32], name[8];
+    struct lyd_node *list;
+
+    if ((ret = lyd_new_inner(NULL, mod, "whens", 0, data))) {
+        return ret;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(k_val, "%" PRIu32, i);
+
+        if ((ret = lyd_new_list(*data, NULL, "chain", 0, &list, k_val))) {
+            return ret;
+        }
+        for (j = 0; j < 8; ++j) {
+            sprintf(name, "w%" PRIu32, j);
+            if ((ret = lyd_new_term(list, NULL, name, "on", 0, NULL))) {
+                return ret;
+            }
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create data tree with list instances each with a leafref to one of a few leaf-list instances.
+ *
+ * @param[in] mod Module of the top-level node.
+ * @param[in] count Number of list instances to create.
+ * @param[out] data Created data.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+create_ref_inst(const struct lys_module *mod, uint32_t count, struct lyd_node **data)
+{
+    LY_ERR ret;
+    uint32_t i;
+    char k_val[32], to_val[32];
+    struct lyd_node *cont, *list;
+
+    if ((ret = lyd_new_inner(NULL, mod, "refs", 0, data))) {
+        return ret;
+    }
+    if ((ret = lyd_new_inner(*data, NULL, "targets", 0, &cont))) {
+        return ret;
+    }
+
+    for (i = 0; i < 16; ++i) {
+        sprintf(to_val, "%" PRIu32, i);
+        if ((ret = lyd_new_term(cont, NULL, "target", to_val, 0, NULL))) {
+            return ret;
+        }
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(k_val, "%" PRIu32, i);
+        sprintf(to_val, "%" PRIu32, i % 16);
+
+        if ((ret = lyd_new_list(*data, NULL, "ref", 0, &list, k_val))) {
+            return ret;
+        }
+        if ((ret = lyd_new_term(list, NULL, "to", to_val, 0, NULL))) {
+            return ret;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Create data tree with list instances with a unique leaf.
+ *
+ * @param[in] mod Module of the top-level node.
+ * @param[in] count Number of list instances to create.
+ * @param[out] data Created data.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+create_unique_inst(const struct lys_module *mod, uint32_t count, struct lyd_node **data)
+{
+    LY_ERR ret;
+    uint32_t i;
+    char k_val[32], name[32];
+    struct lyd_node *list;
+
+    if ((ret = lyd_new_inner(NULL, mod, "uniques", 0, data))) {
+        return ret;
+    }
+
+    for (i = 0; i < count; ++i) {
+        sprintf(k_val, "%" PRIu32, i);
+        sprintf(name, "item-%" PRIu32, i);
+
+        if ((ret = lyd_new_list(*data, NULL, "item", 0, &list, k_val))) {
+            return ret;
+        }
+        if ((ret = lyd_new_term(list, NULL, "name", name, 0, NULL))) {
+            return ret;
+        }
+    }
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Print the aligned name of a test.
+ *
+ * @param[in] name Name of the test.
+ */
+static void
+print_test_name(const char *name)
+{
     const uint32_t name_fixed_len = 38;
     char str[name_fixed_len + 1];
-    uint32_t i, printed;
-    uint64_t time_usec = 0;
+    uint32_t printed;
 
-    /* print test start */
     printed = sprintf(str, "| %s ", name);
     while (printed + 2 < name_fixed_len) {
         printed += sprintf(str + printed, ".");
@@ -180,6 +436,30 @@ exec_test(setup_cb setup, test_cb test, const char *name, const struct lys_modul
     sprintf(str + printed, "|");
     fputs(str, stdout);
     fflush(stdout);
+}
+
+/**
+ * @brief Execute a test.
+ *
+ * @param[in] setup Setup callback to call once.
+ * @param[in] test Test callback.
+ * @param[in] name Name of the test.
+ * @param[in] mod Module of testing data.
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @param[in] tries Number of (re)tries of the test to get more accurate measurements.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+exec_test(setup_cb setup, test_cb test, const char *name, const struct lys_module *mod, uint32_t count, uint32_t tries)
+{
+    LY_ERR ret;
+    struct timespec ts_start, ts_end;
+    struct test_state state = {0};
+    uint32_t i;
+    uint64_t time_usec = 0;
+
+    /* print test start */
+    print_test_name(name);
 
     /* setup */
     if ((ret = setup(mod, count, &state))) {
@@ -205,6 +485,98 @@ exec_test(setup_cb setup, test_cb test, const char *name, const struct lys_modul
     return LY_SUCCESS;
 }
 
+/**
+ * @brief Measure the memory used by a data tree.
+ *
+ * @param[in] name Name of the test.
+ * @param[in] setup Setup callback creating the data tree.
+ * @param[in] mod Module of testing data.
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+exec_mem_test(const char *name, setup_cb setup, const struct lys_module *mod, uint32_t count)
+{
+#if defined (__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    LY_ERR ret;
+    struct test_state state = {0};
+    size_t mem_start, mem_end;
+
+    print_test_name(name);
+
+    mem_start = mallinfo2().uordblks;
+    if ((ret = setup(mod, count, &state))) {
+        return ret;
+    }
+    mem_end = mallinfo2().uordblks;
+
+    lyd_free_siblings(state.data1);
+
+    /* print memory */
+    printf(" %zu B (%zu B per instance) |\n", mem_end - mem_start, (mem_end - mem_start) / count);
+#else
+    (void)name;
+    (void)setup;
+    (void)mod;
+    (void)count;
+#endif
+
+    return LY_SUCCESS;
+}
+
+/**
+ * @brief Evaluate an XPath expression on every list instance and count the heap allocations.
+ *
+ * @param[in] name Name of the test.
+ * @param[in] setup Setup callback creating the list instances.
+ * @param[in] xpath Boolean XPath expression evaluated with the leaf "l" of every list instance as the context node.
+ * @param[in] mod Module of testing data.
+ * @param[in] count Count of list instances, size of the testing data set.
+ * @return LY_ERR value.
+ */
+static LY_ERR
+exec_alloc_test(const char *name, setup_cb setup, const char *xpath, const struct lys_module *mod, uint32_t count)
+{
+#ifdef PERF_COUNT_ALLOC
+    LY_ERR ret;
+    struct test_state state = {0};
+    struct lyd_node *list, *leaf;
+    uint64_t alloc_start, alloc_end;
+    ly_bool result;
+
+    print_test_name(name);
+
+    if ((ret = setup(mod, count, &state))) {
+        return ret;
+    }
+
+    alloc_start = alloc_count;
+    LY_LIST_FOR(lyd_child(state.data1), list) {
+        /* keys k1 and k2 are followed by l */
+        leaf = lyd_child(list)->next->next;
+        if ((ret = lyd_eval_xpath(leaf, xpath, &result))) {
+            lyd_free_siblings(state.data1);
+            return ret;
+        }
+    }
+    alloc_end = alloc_count;
+
+    lyd_free_siblings(state.data1);
+
+    /* print allocations */
+    printf(" %" PRIu64 " (%" PRIu64 ".%02" PRIu64 " per evaluation) |\n", alloc_end - alloc_start,
+            (alloc_end - alloc_start) / count, ((alloc_end - alloc_start) * 100 / count) % 100);
+#else
+    (void)name;
+    (void)setup;
+    (void)xpath;
+    (void)mod;
+    (void)count;
+#endif
+
+    return LY_SUCCESS;
+}
+
 static void
 TEST_START(struct timespec *ts)
 {
@@ -295,6 +667,83 @@ setup_data_offset_tree(const struct lys_module *mod, uint32_t count, struct test
     return LY_SUCCESS;
 }
 
+static LY_ERR
+setup_data_num_tree(const struct lys_module *mod, uint32_t count, struct test_state *state)
+{
+    state->mod = mod;
+    state->count = count;
+
+    return create_num_inst(mod, count, &state->data1);
+}
+
+static LY_ERR
+setup_data_union_tree(const struct lys_module *mod, uint32_t count, struct test_state *state)
+{
+    state->mod = mod;
+    state->count = count;
+
+    return create_union_inst(mod, count, &state->data1);
+}
+
+static LY_ERR
+setup_data_route_tree(const struct lys_module *mod, uint32_t count, struct test_state *state)
+{
+    state->mod = mod;
+    state->count = count;
+
+    return create_route_inst(mod, count, &state->data1);
+}
+
+static LY_ERR
+setup_data_when_tree(const struct lys_module *mod, uint32_t count, struct test_state *state)
+{
+    state->mod = mod;
+    state->count = count;
+
+    return create_when_inst(mod, count, &state->data1);
+}
+
+static LY_ERR
+setup_data_ref_tree(const struct lys_module *mod, uint32_t count, struct test_state *state)
+{
+    state->mod = mod;
+    state->count = count;
+
+    return create_ref_inst(mod, count, &state->data1);
+}
+
+static LY_ERR
+setup_data_valid_tree(const struct lys_module *mod, uint32_t count, struct test_state *state)
+{
+    LY_ERR ret;
+
+    state->mod = mod;
+    state->count = count;
+
+    if ((ret = create_list_inst(mod, 0, count, &state->data1))) {
+        return ret;
+    }
+
+    /* the tree is valid before it is changed */
+    return lyd_validate_all(&state->data1, NULL, LYD_VALIDATE_PRESENT, NULL);
+}
+
+static LY_ERR
+setup_data_unique_tree(const struct lys_module *mod, uint32_t count, struct test_state *state)
+{
+    LY_ERR ret;
+
+    state->mod = mod;
+    state->count = count;
+
+    if ((ret = create_unique_inst(mod, count, &state->data1))) {
+        return ret;
+    }
+
+    /* the tree is valid before it is changed */
+    return lyd_validate_all(&state->data1, NULL, LYD_VALIDATE_PRESENT, NULL);
+}
+
 /* TEST CB */
 static LY_ERR
 test_create_new_text(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
@@ -344,55 +793,163 @@ test_create_new_bin(struct test_state *state, struct timespec *ts_start, struct
 
     TEST_END(ts_end);
 
-    lyd_free_siblings(data);
-
+    lyd_free_siblings(data);
+
+    return LY_SUCCESS;
+}
+
+static LY_ERR
+test_create_path(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+    struct lyd_node *data = NULL;
+    uint32_t i;
+    char path[64], l_val[32];
+
+    TEST_START(ts_start);
+
+    if ((r = lyd_new_inner(NULL, state->mod, "cont", 0, &data))) {
+        return r;
+    }
+
+    for (i = 0; i < state->count; ++i) {
+        sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/l", i, i);
+        sprintf(l_val, "l%" PRIu32, i);
+
+        if ((r = lyd_new_path(data, NULL, path, l_val, 0, NULL))) {
+            return r;
+        }
+    }
+
+    TEST_END(ts_end);
+
+    lyd_free_siblings(data);
+
+    return LY_SUCCESS;
+}
+
+static LY_ERR
+test_validate(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+
+    TEST_START(ts_start);
+
+    if ((r = lyd_validate_all(&state->data1, NULL, LYD_VALIDATE_PRESENT, NULL))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    return LY_SUCCESS;
+}
+
+static LY_ERR
+test_validate_multi_thread(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+
+    TEST_START(ts_start);
+
+    if ((r = lyd_validate_all(&state->data1, NULL, LYD_VALIDATE_PRESENT | LYD_VALIDATE_MULTI_THREAD, NULL))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
     return LY_SUCCESS;
 }
 
 static LY_ERR
-test_create_path(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+test_validate_diff_leaf(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
     LY_ERR r;
-    struct lyd_node *data = NULL;
-    uint32_t i;
-    char path[64], l_val[32];
-
-    TEST_START(ts_start);
+    struct lyd_node *leaf, *orig = NULL, *mod = NULL, *diff = NULL;
+    char path[128], val[32];
+    static uint32_t change;
 
-    if ((r = lyd_new_inner(NULL, state->mod, "cont", 0, &data))) {
+    /* change the value of "l" of a list instance in the middle, only the leaf with its parents is diffed */
+    sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/l", state->count / 2, state->count / 2);
+    if ((r = lyd_find_path(state->data1, path, 0, &leaf))) {
+        return r;
+    }
+    if ((r = lyd_dup_single(leaf, NULL, LYD_DUP_WITH_PARENTS, &orig))) {
         return r;
     }
+    sprintf(val, "changed%" PRIu32, change++);
+    if ((r = lyd_change_term(leaf, val))) {
+        goto cleanup;
+    }
+    if ((r = lyd_dup_single(leaf, NULL, LYD_DUP_WITH_PARENTS, &mod))) {
+        goto cleanup;
+    }
+    while (lyd_parent(orig)) {
+        orig = lyd_parent(orig);
+    }
+    while (lyd_parent(mod)) {
+        mod = lyd_parent(mod);
+    }
+    if ((r = lyd_diff_tree(orig, mod, 0, &diff))) {
+        goto cleanup;
+    }
 
-    for (i = 0; i < state->count; ++i) {
-        sprintf(path, "/perf:cont/lst[k1='%" PRIu32 "'][k2='str%" PRIu32 "']/l", i, i);
-        sprintf(l_val, "l%" PRIu32, i);
+    TEST_START(ts_start);
 
-        if ((r = lyd_new_path(data, NULL, path, l_val, 0, NULL))) {
-            return r;
-        }
+    if ((r = lyd_validate_diff(&state->data1, diff, LYD_VALIDATE_PRESENT, NULL))) {
+        goto cleanup;
     }
 
     TEST_END(ts_end);
 
-    lyd_free_siblings(data);
-
-    return LY_SUCCESS;
+cleanup:
+    lyd_free_all(orig);
+    lyd_free_all(mod);
+    lyd_free_siblings(diff);
+    return r;
 }
 
 static LY_ERR
-test_validate(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+test_validate_unique_change(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
     LY_ERR r;
+    struct lyd_node *cont, *first, *last, *orig = NULL, *diff = NULL;
+    char *name1 = NULL, *name2 = NULL;
+
+    /* swap the unique values of the first and the last instance */
+    if ((r = lyd_find_path(state->data1, "/perf:uniques", 0, &cont))) {
+        return r;
+    }
+    if ((r = lyd_dup_single(cont, NULL, LYD_DUP_RECURSIVE, &orig))) {
+        return r;
+    }
+    first = lyd_child(lyd_child(cont));
+    last = lyd_child(lyd_child(cont)->prev);
+    name1 = strdup(lyd_get_value(first->next));
+    name2 = strdup(lyd_get_value(last->next));
+    if ((r = lyd_change_term(first->next, name2))) {
+        goto cleanup;
+    }
+    if ((r = lyd_change_term(last->next, name1))) {
+        goto cleanup;
+    }
+    if ((r = lyd_diff_tree(orig, cont, 0, &diff))) {
+        goto cleanup;
+    }
 
     TEST_START(ts_start);
 
-    if ((r = lyd_validate_all(&state->data1, NULL, LYD_VALIDATE_PRESENT, NULL))) {
-        return r;
+    if ((r = lyd_validate_diff(&state->data1, diff, LYD_VALIDATE_PRESENT, NULL))) {
+        goto cleanup;
     }
 
     TEST_END(ts_end);
 
-    return LY_SUCCESS;
+cleanup:
+    lyd_free_tree(orig);
+    lyd_free_siblings(diff);
+    free(name1);
+    free(name2);
+    return r;
 }
 
 static LY_ERR
@@ -530,6 +1087,164 @@ test_print_lyb(struct test_state *state, struct timespec *ts_start, struct times
     return _test_print(state, LYD_LYB, LYD_PRINT_SHRINK, ts_start, ts_end);
 }
 
+static LY_ERR
+test_time_parse_print(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+    struct lyd_node *data = NULL, *node;
+    uint32_t i;
+    char val[64];
+
+    if ((r = lyd_new_inner(NULL, state->mod, "events", 0, &data))) {
+        return r;
+    }
+
+    TEST_START(ts_start);
+
+    for (i = 0; i < state->count; ++i) {
+        sprintf(val, "%04" PRIu32 "-%02" PRIu32 "-%02" PRIu32 "T%02" PRIu32 ":%02" PRIu32 ":%02" PRIu32 ".%03" PRIu32 "%s",
+                1970 + i % 100, 1 + i % 12, 1 + i % 28, i % 24, i % 60, i % 59, i % 1000, (i % 2) ? "Z" : "+05:30");
+
+        /* parse and print the canonical value */
+        if ((r = lyd_new_term(data, NULL, "timestamp", val, 0, &node))) {
+            return r;
+        }
+        if (!lyd_get_value(node)) {
+            return LY_EINT;
+        }
+    }
+
+    TEST_END(ts_end);
+
+    lyd_free_siblings(data);
+
+    return LY_SUCCESS;
+}
+
+static LY_ERR
+test_binary_parse_print(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r = LY_SUCCESS;
+    struct lyd_node *data = NULL, *node;
+    uint32_t i, blob_count;
+    char *bin = NULL, *str = NULL;
+    size_t bin_size = 64 * 1024;
+
+    /* one 64 KiB blob for every 100 instances */
+    blob_count = state->count / 100 + 1;
+
+    bin = malloc(bin_size);
+    if (!bin) {
+        return LY_EMEM;
+    }
+    for (i = 0; i < bin_size; ++i) {
+        bin[i] = i * 31 + i / 251;
+    }
+    if ((r = lyd_new_inner(NULL, state->mod, "events", 0, &data))) {
+        goto cleanup;
+    }
+
+    /* get the base64 string value */
+    if ((r = lyd_new_term_bin(data, NULL, "blob", bin, bin_size, 0, &node))) {
+        goto cleanup;
+    }
+    str = strdup(lyd_get_value(node));
+    lyd_free_tree(node);
+    if (!str) {
+        r = LY_EMEM;
+        goto cleanup;
+    }
+
+    TEST_START(ts_start);
+
+    for (i = 0; i < blob_count; ++i) {
+        /* decode */
+        if ((r = lyd_new_term(data, NULL, "blob", str, 0, &node))) {
+            goto cleanup;
+        }
+        lyd_free_tree(node);
+
+        /* encode */
+        if ((r = lyd_new_term_bin(data, NULL, "blob", bin, bin_size, 0, &node))) {
+            goto cleanup;
+        }
+        if (!lyd_get_value(node)) {
+            r = LY_EINT;
+            goto cleanup;
+        }
+        lyd_free_tree(node);
+    }
+
+    TEST_END(ts_end);
+
+cleanup:
+    lyd_free_siblings(data);
+    free(bin);
+    free(str);
+    return r;
+}
+
+/**
+ * @brief Compile a module with many groupings, only every 10th of them instantiated.
+ */
+static LY_ERR
+_test_compile_groupings(struct test_state *state, uint16_t ctx_options, struct timespec *ts_start,
+        struct timespec *ts_end)
+{
+    LY_ERR r = LY_SUCCESS;
+    struct ly_ctx *ctx = NULL;
+    uint32_t i, grp_count;
+    char *yang, *ptr;
+    const char *grp = "grouping g%" PRIu32 " {container c%" PRIu32 " {leaf a {type string;}"
+            "leaf b {type uint32 {range \"1..100\";}} leaf-list ll {type string;}"
+            "list l {key k; leaf k {type string;} leaf v {type int8;}}}}\n";
+
+    /* generate the module */
+    grp_count = state->count / 10 ? state->count / 10 : 1;
+    yang = malloc(64 + grp_count * (strlen(grp) + 40));
+    if (!yang) {
+        return LY_EMEM;
+    }
+    ptr = yang + sprintf(yang, "module groupings {yang-version 1.1; namespace urn:groupings; prefix g;\n");
+    for (i = 0; i < grp_count; ++i) {
+        ptr += sprintf(ptr, grp, i, i);
+    }
+    ptr += sprintf(ptr, "container top {\n");
+    for (i = 0; i < grp_count; i += 10) {
+        ptr += sprintf(ptr, "uses g%" PRIu32 ";\n", i);
+    }
+    sprintf(ptr, "}}\n");
+
+    if ((r = ly_ctx_new(NULL, ctx_options, &ctx))) {
+        goto cleanup;
+    }
+
+    TEST_START(ts_start);
+
+    if ((r = lys_parse_mem(ctx, yang, LYS_IN_YANG, NULL))) {
+        goto cleanup;
+    }
+
+    TEST_END(ts_end);
+
+cleanup:
+    ly_ctx_destroy(ctx);
+    free(yang);
+    return r;
+}
+
+static LY_ERR
+test_compile_groupings(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    return _test_compile_groupings(state, 0, ts_start, ts_end);
+}
+
+static LY_ERR
+test_compile_skip_unused_groupings(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    return _test_compile_groupings(state, LY_CTX_SKIP_UNUSED_GROUPINGS, ts_start, ts_end);
+}
+
 static LY_ERR
 test_dup(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
@@ -568,6 +1283,28 @@ test_free(struct test_state *state, struct timespec *ts_start, struct timespec *
     return LY_SUCCESS;
 }
 
+static LY_ERR
+test_traverse(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    struct lyd_node *elem;
+    uint32_t node_count = 0;
+
+    TEST_START(ts_start);
+
+    LYD_TREE_DFS_BEGIN(state->data1, elem) {
+        node_count += (elem->flags & LYD_DEFAULT) ? 0 : 1;
+        LYD_TREE_DFS_END(state->data1, elem);
+    }
+
+    TEST_END(ts_end);
+
+    if (node_count < state->count) {
+        return LY_EINT;
+    }
+
+    return LY_SUCCESS;
+}
+
 static LY_ERR
 test_xpath_find(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
@@ -590,6 +1327,106 @@ test_xpath_find(struct test_state *state, struct timespec *ts_start, struct time
     return LY_SUCCESS;
 }
 
+static LY_ERR
+test_xpath_find_num(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+    struct ly_set *set;
+    char path[64];
+
+    sprintf(path, "/perf:cont/lst[k1 >= %" PRIu32 "]", state->count / 2);
+
+    TEST_START(ts_start);
+
+    if ((r = lyd_find_xpath(state->data1, path, &set))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    if (set->count != state->count - state->count / 2) {
+        ly_set_free(set, NULL);
+        return LY_EINT;
+    }
+    ly_set_free(set, NULL);
+
+    return LY_SUCCESS;
+}
+
+static LY_ERR
+test_xpath_eval_inst(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+    struct lyd_node *list, *leaf;
+    ly_bool result;
+    uint32_t true_count = 0;
+
+    TEST_START(ts_start);
+
+    LY_LIST_FOR(lyd_child(state->data1), list) {
+        /* keys k1 and k2 are followed by l */
+        leaf = lyd_child(list)->next->next;
+        if ((r = lyd_eval_xpath(leaf, "../k1 >= 0 and not(../lfl)", &result))) {
+            return r;
+        }
+        true_count += result;
+    }
+
+    TEST_END(ts_end);
+
+    /* only the last instance has "lfl" instances */
+    if (true_count != state->count - 1) {
+        return LY_EINT;
+    }
+
+    return LY_SUCCESS;
+}
+
+static LY_ERR
+test_xpath_exists(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+    ly_bool result;
+    char path[64];
+
+    sprintf(path, "/perf:cont/lst[l = 'l%" PRIu32 "']", state->count / 2);
+
+    TEST_START(ts_start);
+
+    if ((r = lyd_eval_xpath(state->data1, path, &result))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    if (!result) {
+        return LY_EINT;
+    }
+
+    return LY_SUCCESS;
+}
+
+static LY_ERR
+test_xpath_exists_count(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
+{
+    LY_ERR r;
+    ly_bool result;
+
+    TEST_START(ts_start);
+
+    if ((r = lyd_eval_xpath(state->data1, "count(/perf:cont/lst[l != 'l0']) > 0", &result))) {
+        return r;
+    }
+
+    TEST_END(ts_end);
+
+    if (!result) {
+        return LY_EINT;
+    }
+
+    return LY_SUCCESS;
+}
+
 static LY_ERR
 test_xpath_find_hash(struct test_state *state, struct timespec *ts_start, struct timespec *ts_end)
 {
@@ -736,22 +1573,42 @@ struct test tests[] = {
     {"create new bin", setup_basic, test_create_new_bin},
     {"create path", setup_basic, test_create_path},
     {"validate", setup_data_single_tree, test_validate},
+    {"validate all", setup_data_valid_tree, test_validate},
+    {"validate diff one leaf", setup_data_valid_tree, test_validate_diff_leaf},
+    {"validate unique change", setup_data_unique_tree, test_validate_unique_change},
+    {"validate leafrefs", setup_data_ref_tree, test_validate},
+    {"validate leafrefs multi-thread", setup_data_ref_tree, test_validate_multi_thread},
     {"parse xml mem validate", setup_data_single_tree, test_parse_xml_mem_validate},
     {"parse xml mem no validate", setup_data_single_tree, test_parse_xml_mem_no_validate},
     {"parse xml file no validate format", setup_data_single_tree, test_parse_xml_file_no_validate_format},
     {"parse json mem validate", setup_data_single_tree, test_parse_json_mem_validate},
     {"parse json mem no validate", setup_data_single_tree, test_parse_json_mem_no_validate},
     {"parse json file no validate format", setup_data_single_tree, test_parse_json_file_no_validate_format},
+    {"parse xml mem numbers", setup_data_num_tree, test_parse_xml_mem_no_validate},
+    {"parse json mem numbers", setup_data_num_tree, test_parse_json_mem_no_validate},
+    {"parse xml mem unions", setup_data_union_tree, test_parse_xml_mem_no_validate},
+    {"parse json mem unions", setup_data_union_tree, test_parse_json_mem_no_validate},
+    {"parse xml mem when chains", setup_data_when_tree, test_parse_xml_mem_validate},
     {"parse lyb mem validate", setup_data_single_tree, test_parse_lyb_mem_validate},
     {"parse lyb mem no validate", setup_data_single_tree, test_parse_lyb_mem_no_validate},
     {"parse lyb file no validate", setup_data_single_tree, test_parse_lyb_file_no_validate},
     {"print xml", setup_data_single_tree, test_print_xml},
     {"print json", setup_data_single_tree, test_print_json},
     {"print lyb", setup_data_single_tree, test_print_lyb},
+    {"date-and-time parse print", setup_basic, test_time_parse_print},
+    {"binary parse print", setup_basic, test_binary_parse_print},
+    {"compile groupings", setup_basic, test_compile_groupings},
+    {"compile skip unused groupings", setup_basic, test_compile_skip_unused_groupings},
     {"dup", setup_data_single_tree, test_dup},
+    {"dup routes", setup_data_route_tree, test_dup},
     {"free", setup_basic, test_free},
+    {"traverse", setup_data_single_tree, test_traverse},
     {"xpath find", setup_data_single_tree, test_xpath_find},
     {"xpath find hash", setup_data_single_tree, test_xpath_find_hash},
+    {"xpath find numbers", setup_data_single_tree, test_xpath_find_num},
+    {"xpath eval instances", setup_data_single_tree, test_xpath_eval_inst},
+    {"xpath exists", setup_data_single_tree, test_xpath_exists},
+    {"xpath exists count", setup_data_single_tree, test_xpath_exists_count},
     {"compare same", setup_data_same_trees, test_compare_same},
     {"diff same", setup_data_same_trees, test_diff_same},
     {"diff no same", setup_data_no_same_trees, test_diff_no_same},
@@ -806,6 +1663,59 @@ main(int argc, char **argv)
         }
     }
 
+    /* tests with interned values */
+    if ((ret = ly_ctx_set_options(ctx, LY_CTX_INTERN_VALUES))) {
+        goto cleanup;
+    }
+    if ((ret = exec_test(setup_data_route_tree, test_dup, "dup routes interned values", mod, count, tries))) {
+        goto cleanup;
+    }
+    ly_ctx_unset_options(ctx, LY_CTX_INTERN_VALUES);
+
+    /* tests with unique indexes */
+    if ((ret = ly_ctx_set_options(ctx, LY_CTX_UNIQUE_INDEX))) {
+        goto cleanup;
+    }
+    if ((ret = exec_test(setup_data_unique_tree, test_validate_unique_change, "validate unique change indexed", mod,
+            count, tries))) {
+        goto cleanup;
+    }
+    ly_ctx_unset_options(ctx, LY_CTX_UNIQUE_INDEX);
+
+    /* memory */
+    printf("\n");
+    if ((ret = exec_mem_test("memory lists", setup_data_single_tree, mod, count))) {
+        goto cleanup;
+    }
+    if ((ret = ly_ctx_set_options(ctx, LY_CTX_INLINE_STRINGS))) {
+        goto cleanup;
+    }
+    if ((ret = exec_mem_test("memory lists inline strings", setup_data_single_tree, mod, count))) {
+        goto cleanup;
+    }
+    ly_ctx_unset_options(ctx, LY_CTX_INLINE_STRINGS);
+    if ((ret = exec_mem_test("memory routes", setup_data_route_tree, mod, count))) {
+        goto cleanup;
+    }
+    if ((ret = ly_ctx_set_options(ctx, LY_CTX_INTERN_VALUES))) {
+        goto cleanup;
+    }
+    if ((ret = exec_mem_test("memory routes interned values", setup_data_route_tree, mod, count))) {
+        goto cleanup;
+    }
+    ly_ctx_unset_options(ctx, LY_CTX_INTERN_VALUES);
+
+    /* heap allocations */
+    printf("\n");
+    if ((ret = exec_alloc_test("allocations xpath eval", setup_data_single_tree, "../k1 >= 0 and not(../lfl)", mod,
+            count))) {
+        goto cleanup;
+    }
+    if ((ret = exec_alloc_test("allocations xpath eval union", setup_data_single_tree, "../k1 | ../k2 | ../lfl", mod,
+            count))) {
+        goto cleanup;
+    }
+
     printf("\n");
 
 cleanup:
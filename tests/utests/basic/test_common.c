@@ -94,6 +94,30 @@ test_parse_int(void **UNUSED(state))
 
     str = "10  zero";
     assert_int_equal(LY_EVALID, ly_parse_int(str, strlen(str), -10, 10, 10, &i));
+
+    /* int64 limits */
+    str = "-9223372036854775808";
+    assert_int_equal(LY_SUCCESS, ly_parse_int(str, strlen(str), INT64_MIN, INT64_MAX, 10, &i));
+    assert_true(i == INT64_MIN);
+    str = "9223372036854775807";
+    assert_int_equal(LY_SUCCESS, ly_parse_int(str, strlen(str), INT64_MIN, INT64_MAX, 10, &i));
+    assert_true(i == INT64_MAX);
+    str = "9223372036854775808";
+    assert_int_equal(LY_EVALID, ly_parse_int(str, strlen(str), INT64_MIN, INT64_MAX, 10, &i));
+    str = "-9223372036854775809";
+    assert_int_equal(LY_EVALID, ly_parse_int(str, strlen(str), INT64_MIN, INT64_MAX, 10, &i));
+
+    /* other bases */
+    str = "-0x1A";
+    assert_int_equal(LY_SUCCESS, ly_parse_int(str, strlen(str), -100, 100, 0, &i));
+    assert_int_equal(i, -26);
+    str = "017";
+    assert_int_equal(LY_SUCCESS, ly_parse_int(str, strlen(str), -100, 100, 0, &i));
+    assert_int_equal(i, 15);
+    str = "0x";
+    assert_int_equal(LY_EVALID, ly_parse_int(str, strlen(str), -100, 100, 0, &i));
+    str = "0x1A";
+    assert_int_equal(LY_EVALID, ly_parse_int(str, strlen(str), -100, 100, 10, &i));
 }
 
 static void
@@ -131,6 +155,16 @@ test_parse_uint(void **UNUSED(state))
 
     str = "10  zero";
     assert_int_equal(LY_EVALID, ly_parse_uint(str, strlen(str), 10, 10, &u));
+
+    /* uint64 limits */
+    str = "18446744073709551615";
+    assert_int_equal(LY_SUCCESS, ly_parse_uint(str, strlen(str), UINT64_MAX, 10, &u));
+    assert_true(u == UINT64_MAX);
+    str = "18446744073709551616";
+    assert_int_equal(LY_EVALID, ly_parse_uint(str, strlen(str), UINT64_MAX, 10, &u));
+    str = "-0";
+    assert_int_equal(LY_SUCCESS, ly_parse_uint(str, strlen(str), 10, 10, &u));
+    assert_int_equal(u, 0);
 }
 
 static void
@@ -691,6 +691,15 @@ test_ylmem(void **state)
     assert_int_equal(LY_SUCCESS, lys_feature_value(ly_ctx_get_module(ctx_test, "ietf-netconf", "2011-06-01"), "url"));
     ly_ctx_destroy(ctx_test);
 
+    /* test creating a frozen context, it is frozen only after all the modules are loaded */
+    assert_int_equal(LY_SUCCESS, ly_ctx_new_ylmem(TESTS_SRC "/modules/yang/", with_netconf_features, LYD_XML,
+            LY_CTX_FROZEN, &ctx_test));
+    assert_int_equal(LY_CTX_FROZEN, ly_ctx_get_options(ctx_test) & LY_CTX_FROZEN);
+    assert_int_equal(1, ly_ctx_get_module(ctx_test, "ietf-netconf", "2011-06-01")->implemented);
+    assert_int_equal(LY_SUCCESS, lys_feature_value(ly_ctx_get_module(ctx_test, "ietf-netconf", "2011-06-01"), "url"));
+    assert_null(ly_ctx_load_module(ctx_test, "ietf-ip", NULL, NULL));
+    ly_ctx_destroy(ctx_test);
+
     /* test with not matching revision */
     assert_int_equal(LY_EINVAL, ly_ctx_new_ylmem(TESTS_SRC "/modules/yang/", garbage_revision, LYD_XML, 0, &ctx_test));
 
@@ -995,6 +1004,211 @@ test_explicit_compile(void **state)
     assert_non_null(mod);
 }
 
+static void
+test_recompile_affected(void **state)
+{
+    uint32_t i;
+    char schema[512];
+    struct lys_module *mod_a, *mods[300];
+    const struct lysc_node *snode;
+    struct lysc_module *compiled[300];
+    const char *feats[] = {"f", NULL};
+    const char *schema_a = "module a {\n"
+            "  namespace urn:tests:a;\n"
+            "  prefix a;\n"
+            "  feature f;\n"
+            "  container cont {\n"
+            "    leaf foo {\n"
+            "      type uint16;\n"
+            "    }\n"
+            "    leaf bar {\n"
+            "      if-feature f;\n"
+            "      type string;\n"
+            "    }\n"
+            "  }\n"
+            "}\n";
+
+    /* use own context with extra flags */
+    ly_ctx_destroy(UTEST_LYCTX);
+    assert_int_equal(LY_SUCCESS, ly_ctx_new(NULL, LY_CTX_EXPLICIT_COMPILE, &UTEST_LYCTX));
+
+    /* 300 modules in a single dep set, all importing the same module */
+    UTEST_ADD_MODULE(schema_a, LYS_IN_YANG, NULL, &mod_a);
+    for (i = 0; i < 300; ++i) {
+        sprintf(schema, "module m%" PRIu32 " {namespace urn:tests:m%" PRIu32 ";prefix m;import a {prefix a;}"
+                "feature f;leaf ref {type leafref {path /a:cont/a:foo;}}leaf opt {if-feature f;type string;}}", i, i);
+        UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, &mods[i]);
+    }
+    assert_int_equal(LY_SUCCESS, ly_ctx_compile(UTEST_LYCTX));
+    for (i = 0; i < 300; ++i) {
+        compiled[i] = mods[i]->compiled;
+        assert_non_null(compiled[i]);
+    }
+
+    /* changing features of a module that no other module depends on, only this module is recompiled */
+    assert_int_equal(LY_SUCCESS, lys_set_implemented(mods[150], feats));
+    assert_int_equal(LY_SUCCESS, ly_ctx_compile(UTEST_LYCTX));
+    for (i = 0; i < 300; ++i) {
+        if (i != 150) {
+            assert_ptr_equal(compiled[i], mods[i]->compiled);
+        }
+    }
+    assert_non_null(lys_find_child(NULL, mods[150], "opt", 0, 0, 0));
+    assert_null(lys_find_child(NULL, mods[149], "opt", 0, 0, 0));
+
+    /* changing features of the imported module, all the modules importing it are recompiled */
+    assert_int_equal(LY_SUCCESS, lys_set_implemented(mod_a, feats));
+    assert_int_equal(LY_SUCCESS, ly_ctx_compile(UTEST_LYCTX));
+    snode = lys_find_child(lys_find_child(NULL, mod_a, "cont", 0, 0, 0), mod_a, "foo", 0, 0, 0);
+    assert_non_null(snode);
+    for (i = 0; i < 300; ++i) {
+        assert_ptr_equal(((struct lysc_type_leafref *)((struct lysc_node_leaf *)mods[i]->compiled->data)->type)->realtype,
+                ((struct lysc_node_leaf *)snode)->type);
+    }
+}
+
+static void
+test_clone(void **state)
+{
+    struct ly_ctx *clone = NULL;
+    struct lys_module *mod, *mod_clone;
+    const char *feats[] = {"ipv4-non-contiguous-netmasks", NULL};
+
+    assert_int_equal(LY_EINVAL, ly_ctx_new_clone(NULL, 0, &clone));
+    CHECK_LOG("Invalid argument ctx (ly_ctx_new_clone()).", NULL);
+
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_searchdir(UTEST_LYCTX, TESTS_DIR_MODULES_YANG));
+    mod = ly_ctx_load_module(UTEST_LYCTX, "ietf-ip", NULL, feats);
+    assert_non_null(mod);
+
+    /* same modules and features */
+    assert_int_equal(LY_SUCCESS, ly_ctx_new_clone(UTEST_LYCTX, 0, &clone));
+    assert_int_equal(ly_ctx_get_options(UTEST_LYCTX), ly_ctx_get_options(clone));
+    mod_clone = ly_ctx_get_module_implemented(clone, "ietf-ip");
+    assert_non_null(mod_clone);
+    assert_ptr_not_equal(mod, mod_clone);
+    assert_non_null(mod_clone->compiled);
+    assert_int_equal(LY_SUCCESS, lys_feature_value(mod_clone, "ipv4-non-contiguous-netmasks"));
+    assert_int_equal(LY_ENOT, lys_feature_value(mod_clone, "ipv6-privacy-autoconf"));
+    assert_non_null(ly_ctx_get_module_implemented(clone, "ietf-interfaces"));
+
+    /* the strings are shared */
+    assert_ptr_equal(mod->name, mod_clone->name);
+    assert_ptr_equal(mod->dsc, mod_clone->dsc);
+
+    /* changes of the clone do not affect the original context */
+    assert_int_equal(LY_SUCCESS, lys_feature_value(mod, "ipv4-non-contiguous-netmasks"));
+    assert_non_null(ly_ctx_load_module(clone, "ietf-netconf-acm", NULL, NULL));
+    assert_null(ly_ctx_get_module(UTEST_LYCTX, "ietf-netconf-acm", NULL));
+
+    /* the original context is freed only with its last clone */
+    ly_ctx_destroy(UTEST_LYCTX);
+    UTEST_LYCTX = NULL;
+    assert_int_equal(LY_SUCCESS, lys_feature_value(mod_clone, "ipv4-non-contiguous-netmasks"));
+    ly_ctx_destroy(clone);
+}
+
+static void
+test_frozen(void **state)
+{
+    struct lys_module *mod;
+    struct lyd_node *tree;
+    const struct lysc_node_leaf *leaf;
+    const struct lysc_node_leaflist *llist;
+    const char *yang = "module a {yang-version 1.1;namespace urn:a;prefix a;container c {leaf l {type string;}"
+            "leaf num {type int32; default 0x10;} leaf-list nums {type uint8; default 1; default 2;}}}";
+
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, yang, LYS_IN_YANG, &mod));
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_searchdir(UTEST_LYCTX, TESTS_DIR_MODULES_YANG));
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_options(UTEST_LYCTX, LY_CTX_FROZEN));
+    assert_int_equal(LY_CTX_FROZEN, ly_ctx_get_options(UTEST_LYCTX) & LY_CTX_FROZEN);
+
+    /* the LYB hashes are already cached */
+    assert_int_not_equal(0, mod->compiled->data->hash[0]);
+
+    /* so are the canonical default values */
+    leaf = (const struct lysc_node_leaf *)lys_find_child(mod->compiled->data, mod, "num", 0, 0, 0);
+    assert_string_equal("16", leaf->dflt->_canonical);
+    llist = (const struct lysc_node_leaflist *)lys_find_child(mod->compiled->data, mod, "nums", 0, 0, 0);
+    assert_string_equal("1", llist->dflts[0]->_canonical);
+    assert_string_equal("2", llist->dflts[1]->_canonical);
+
+    /* no schema changes are allowed */
+    assert_null(ly_ctx_load_module(UTEST_LYCTX, "ietf-ip", NULL, NULL));
+    CHECK_LOG_CTX("Schema of a frozen context cannot be changed.", NULL);
+    assert_int_equal(LY_EDENIED, lys_parse_mem(UTEST_LYCTX, "module b {namespace urn:b;prefix b;}", LYS_IN_YANG, NULL));
+    CHECK_LOG_CTX("Schema of a frozen context cannot be changed.", NULL);
+    mod = ly_ctx_get_module_latest(UTEST_LYCTX, "ietf-yang-types");
+    assert_int_equal(LY_EDENIED, lys_set_implemented(mod, NULL));
+    CHECK_LOG_CTX("Schema of a frozen context cannot be changed.", NULL);
+    assert_int_equal(LY_EDENIED, ly_ctx_compile(UTEST_LYCTX));
+    CHECK_LOG_CTX("Schema of a frozen context cannot be changed.", NULL);
+    assert_int_equal(LY_EDENIED, ly_ctx_set_options(UTEST_LYCTX, LY_CTX_SET_PRIV_PARSED));
+    CHECK_LOG_CTX("Schema of a frozen context cannot be changed.", NULL);
+
+    /* data can still be parsed */
+    CHECK_PARSE_LYD_PARAM("<c xmlns=\"urn:a\"><l>val</l></c>", LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    lyd_free_all(tree);
+
+    /* unfreeze */
+    assert_int_equal(LY_SUCCESS, ly_ctx_unset_options(UTEST_LYCTX, LY_CTX_FROZEN));
+    assert_non_null(ly_ctx_load_module(UTEST_LYCTX, "ietf-ip", NULL, NULL));
+}
+
+static void
+test_no_descriptions(void **state)
+{
+    struct lys_module *mod;
+    const char *yang = "module a {namespace urn:a;prefix a;description \"module\";"
+            "container c {description \"container\";reference \"ref\";leaf l {type string;description \"leaf\";}}}";
+    const char *yin = "<module name=\"b\" xmlns=\"urn:ietf:params:xml:ns:yang:yin:1\">"
+            "<namespace uri=\"urn:b\"/><prefix value=\"b\"/><description><text>module</text></description>"
+            "<leaf name=\"l\"><type name=\"string\"/><description><text>leaf</text></description>"
+            "<reference><text>ref</text></reference></leaf></module>";
+
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_options(UTEST_LYCTX, LY_CTX_NO_DESCRIPTIONS));
+
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, yang, LYS_IN_YANG, &mod));
+    assert_null(mod->dsc);
+    assert_null(mod->parsed->data->dsc);
+    assert_null(mod->parsed->data->ref);
+    assert_null(mod->compiled->data->dsc);
+    assert_null(mod->compiled->data->ref);
+    assert_null(lysc_node_child(mod->compiled->data)->dsc);
+
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, yin, LYS_IN_YIN, &mod));
+    assert_null(mod->dsc);
+    assert_null(mod->parsed->data->dsc);
+    assert_null(mod->parsed->data->ref);
+    assert_null(mod->compiled->data->dsc);
+    assert_null(mod->compiled->data->ref);
+
+    /* duplicate statements are still detected */
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module d {namespace urn:d;prefix d;"
+            "leaf l1 {type string;description \"l1\";reference \"l1\";}"
+            "leaf l2 {type string;description \"l2\";reference \"l2\";}}", LYS_IN_YANG, NULL));
+    assert_int_equal(LY_EVALID, lys_parse_mem(UTEST_LYCTX, "module e {namespace urn:e;prefix e;"
+            "container c {description \"c\";leaf l {type string;description \"l\";}description \"c2\";}}",
+            LYS_IN_YANG, NULL));
+    CHECK_LOG_CTX("Parsing module \"e\" failed.", NULL,
+            "Duplicate keyword \"description\".", "Line number 1.");
+    assert_int_equal(LY_EVALID, lys_parse_mem(UTEST_LYCTX, "module e {namespace urn:e;prefix e;"
+            "leaf l {type string;reference \"l\";reference \"l2\";}}", LYS_IN_YANG, NULL));
+    CHECK_LOG_CTX("Parsing module \"e\" failed.", NULL,
+            "Duplicate keyword \"reference\".", "Line number 1.");
+    assert_int_equal(LY_EVALID, lys_parse_mem(UTEST_LYCTX, "<module name=\"e\" xmlns=\"urn:ietf:params:xml:ns:yang:yin:1\">"
+            "<namespace uri=\"urn:e\"/><prefix value=\"e\"/><description><text>e</text></description>"
+            "<description><text>e2</text></description></module>", LYS_IN_YIN, NULL));
+    CHECK_LOG_CTX("Parsing module \"e\" failed.", NULL,
+            "Redefinition of \"description\" sub-element in \"module\" element.", "Line number 1.");
+
+    /* the texts are stored again */
+    assert_int_equal(LY_SUCCESS, ly_ctx_unset_options(UTEST_LYCTX, LY_CTX_NO_DESCRIPTIONS));
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module c {namespace urn:c;prefix c;description \"module\";}",
+            LYS_IN_YANG, &mod));
+    assert_string_equal("module", mod->dsc);
+}
+
 int
 main(void)
 {
@@ -1007,6 +1221,10 @@ main(void)
         UTEST(test_ylmem),
         UTEST(test_set_priv_parsed),
         UTEST(test_explicit_compile),
+        UTEST(test_recompile_affected),
+        UTEST(test_clone),
+        UTEST(test_frozen),
+        UTEST(test_no_descriptions),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
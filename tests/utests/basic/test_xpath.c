@@ -420,6 +420,233 @@ test_canonize(void **state)
     lyd_free_all(tree);
 }
 
+static void
+test_node_set_comp(void **state)
+{
+    const char *data =
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a1</a>\n"
+            "    <b>b1</b>\n"
+            "    <c>c1</c>\n"
+            "</l1>\n"
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a2</a>\n"
+            "    <b>b2</b>\n"
+            "</l1>\n"
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a3</a>\n"
+            "    <b>b3</b>\n"
+            "    <c>c3</c>\n"
+            "</l1>\n"
+            "<foo2 xmlns=\"urn:tests:a\">50</foo2>\n"
+            "<c xmlns=\"urn:tests:a\">\n"
+            "    <ll2>a2</ll2>\n"
+            "    <ll2>b</ll2>\n"
+            "    <ll2>c3</ll2>\n"
+            "    <ll2>10</ll2>\n"
+            "    <ll2>050</ll2>\n"
+            "    <ll2>60</ll2>\n"
+            "</c>";
+    struct lyd_node *tree;
+    struct ly_set *set;
+
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    assert_non_null(tree);
+
+#define CHECK_COUNT(XPATH, COUNT) \
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, XPATH, &set)); \
+    assert_int_equal(COUNT, set->count); \
+    ly_set_free(set, NULL)
+
+    /* '=' */
+    CHECK_COUNT("/l1[a = /c/ll2]/a", 1);
+    CHECK_COUNT("/l1[c = /c/ll2]/a", 1);
+    CHECK_COUNT("/foo2[/l1/b = /c/ll2]", 0);
+    CHECK_COUNT("/foo2[/l1/a = /nothing]", 0);
+
+    /* '!=' */
+    CHECK_COUNT("/foo2[/l1/a != /l1/a]", 1);
+    CHECK_COUNT("/foo2[/foo2 != /foo2]", 0);
+    CHECK_COUNT("/foo2[/l1/a[. = 'a1'] != /l1/a[. = 'a1']]", 0);
+    CHECK_COUNT("/foo2[/l1/a != /nothing]", 0);
+
+    /* relational */
+    CHECK_COUNT("/foo2[/c/ll2 < /foo2]", 1);
+    CHECK_COUNT("/foo2[/c/ll2 > /foo2]", 1);
+    CHECK_COUNT("/foo2[/foo2 <= /c/ll2[. = '10']]", 0);
+    CHECK_COUNT("/foo2[/l1/a < /c/ll2]", 0);
+
+    /* canonized by the type of the second node-set */
+    CHECK_COUNT("/foo2[/c/ll2 = /foo2]", 1);
+    CHECK_COUNT("/foo2[/foo2 = /c/ll2]", 0);
+
+    /* nodes of different types */
+    CHECK_COUNT("/foo2[/c/ll2 = /foo2 | /l1/a]", 1);
+    CHECK_COUNT("/c/ll2[. = /l1/a | /l1/c]", 2);
+
+#undef CHECK_COUNT
+
+    lyd_free_all(tree);
+}
+
+static void
+test_numbers(void **state)
+{
+    const char *schema =
+            "module b {\n"
+            "    namespace urn:tests:b;\n"
+            "    prefix b;\n"
+            "    yang-version 1.1;\n"
+            "\n"
+            "    container c {\n"
+            "        leaf-list cnt {\n"
+            "            type uint64;\n"
+            "        }\n"
+            "        leaf neg {\n"
+            "            type int64;\n"
+            "        }\n"
+            "        leaf dec {\n"
+            "            type decimal64 {\n"
+            "                fraction-digits 2;\n"
+            "            }\n"
+            "        }\n"
+            "        leaf un {\n"
+            "            type union {\n"
+            "                type int8;\n"
+            "                type string;\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "}";
+    const char *data =
+            "<c xmlns=\"urn:tests:b\">\n"
+            "    <cnt>9223372036854775807</cnt>\n"
+            "    <cnt>9223372036854775808</cnt>\n"
+            "    <neg>-9223372036854775808</neg>\n"
+            "    <dec>1.50</dec>\n"
+            "    <un>-5</un>\n"
+            "</c>";
+    struct lyd_node *tree;
+    struct ly_set *set;
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    assert_non_null(tree);
+
+#define CHECK_COUNT(XPATH, COUNT) \
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, XPATH, &set)); \
+    assert_int_equal(COUNT, set->count); \
+    ly_set_free(set, NULL)
+
+    /* integers are compared exactly */
+    CHECK_COUNT("/b:c/cnt[. = 9223372036854775808]", 1);
+    CHECK_COUNT("/b:c/cnt[. < 9223372036854775808]", 1);
+    CHECK_COUNT("/b:c/cnt[9223372036854775808 > .]", 1);
+    CHECK_COUNT("/b:c/cnt[. != 9223372036854775808]", 1);
+    CHECK_COUNT("/b:c/cnt[. < 0]", 0);
+    CHECK_COUNT("/b:c/cnt[. < 18446744073709551616]", 2);
+    CHECK_COUNT("/b:c/neg[. = -9223372036854775808]", 1);
+    CHECK_COUNT("/b:c/neg[. < -9223372036854775808]", 0);
+    CHECK_COUNT("/b:c/un[. = -5]", 1);
+
+    /* decimal64 */
+    CHECK_COUNT("/b:c/dec[. = 1.5]", 1);
+    CHECK_COUNT("/b:c/dec[. > 1.49]", 1);
+    CHECK_COUNT("/b:c/dec[1.5 < .]", 0);
+
+    /* NaN */
+    CHECK_COUNT("/b:c/dec[. = number('x')]", 0);
+    CHECK_COUNT("/b:c/dec[. != number('x')]", 1);
+    CHECK_COUNT("/b:c/dec[number('x') != .]", 1);
+
+    /* casts */
+    CHECK_COUNT("/b:c[sum(cnt) = 18446744073709551615]", 1);
+    CHECK_COUNT("/b:c[dec * 2 = 3]", 1);
+    CHECK_COUNT("/b:c[un + 5 = 0]", 1);
+
+#undef CHECK_COUNT
+
+    lyd_free_all(tree);
+}
+
+static void
+test_boolean(void **state)
+{
+    const char *data =
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a1</a>\n"
+            "    <b>b1</b>\n"
+            "    <c>c1</c>\n"
+            "</l1>\n"
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a2</a>\n"
+            "    <b>b2</b>\n"
+            "</l1>\n"
+            "<l1 xmlns=\"urn:tests:a\">\n"
+            "    <a>a3</a>\n"
+            "    <b>b3</b>\n"
+            "    <c>c3</c>\n"
+            "</l1>\n"
+            "<c xmlns=\"urn:tests:a\">\n"
+            "    <ll2>a2</ll2>\n"
+            "    <ll2>b</ll2>\n"
+            "</c>";
+    struct lyd_node *tree;
+    struct ly_set *set;
+    ly_bool result;
+
+    assert_int_equal(LY_SUCCESS, lyd_parse_data_mem(UTEST_LYCTX, data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, &tree));
+    assert_non_null(tree);
+
+#define CHECK_BOOL(XPATH, RESULT) \
+    assert_int_equal(LY_SUCCESS, lyd_eval_xpath(tree, XPATH, &result)); \
+    assert_int_equal(RESULT, result)
+#define CHECK_COUNT(XPATH, COUNT) \
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, XPATH, &set)); \
+    assert_int_equal(COUNT, set->count); \
+    ly_set_free(set, NULL)
+
+    /* existence */
+    CHECK_BOOL("/a:l1[c = 'c3']", 1);
+    CHECK_BOOL("/a:l1[c = 'c2']", 0);
+    CHECK_BOOL("boolean(/a:l1[c])", 1);
+    CHECK_BOOL("not(/a:l1[c])", 0);
+    CHECK_BOOL("not(/a:l1[a = 'a4'])", 1);
+    CHECK_BOOL("/a:l1[c]/b = 'b3'", 1);
+    CHECK_BOOL("/a:l1[c][2]/b = 'b3'", 1);
+    CHECK_BOOL("/a:l1[c][1]/b = 'b3'", 0);
+    CHECK_BOOL("/a:l1/c | /a:nothing", 1);
+    CHECK_BOOL("/a:nothing | /a:l1/c", 1);
+    CHECK_BOOL("(/a:l1)[last()][c = 'c3']", 1);
+    CHECK_BOOL("(/a:l1)[2][c]", 0);
+    CHECK_BOOL("/a:l1[position() = 3]/c", 1);
+    CHECK_BOOL("/a:l1[last()]/c", 1);
+
+    /* count() compared with 0 */
+    CHECK_BOOL("count(/a:l1[c]) > 0", 1);
+    CHECK_BOOL("count(/a:l1[a = 'a4']) > 0", 0);
+    CHECK_BOOL("count(/a:l1) != 0", 1);
+    CHECK_BOOL("count(/a:l1[c = 'c2']) = 0", 1);
+    CHECK_BOOL("count(/a:l1) = 0", 0);
+    CHECK_BOOL("count(/a:l1) > 0 = (1 > 0)", 1);
+    CHECK_BOOL("count(/a:l1) > 0 + 2", 1);
+    CHECK_BOOL("count(/a:l1) > 0 + 3", 0);
+    CHECK_BOOL("count(/a:l1[c]) = 0 or /a:c/ll2 = 'b'", 1);
+    assert_int_equal(LY_EVALID, lyd_eval_xpath(tree, "count('a') > 0", &result));
+
+    /* predicates of the found nodes must be evaluated completely */
+    CHECK_COUNT("/a:l1[c]", 2);
+    CHECK_COUNT("/a:l1[a != 'a1']/b", 2);
+    CHECK_COUNT("/a:l1[/a:c/ll2 = 'b']", 3);
+    CHECK_COUNT("/a:l1[count(/a:c/ll2) = 2]", 3);
+    CHECK_COUNT("/a:c/ll2[count(/a:l1[c]) > 0]", 2);
+
+#undef CHECK_BOOL
+#undef CHECK_COUNT
+
+    lyd_free_all(tree);
+}
+
 static void
 test_derived_from(void **state)
 {
@@ -753,6 +980,9 @@ main(void)
         UTEST(test_toplevel, setup),
         UTEST(test_atomize, setup),
         UTEST(test_canonize, setup),
+        UTEST(test_node_set_comp, setup),
+        UTEST(test_numbers, setup),
+        UTEST(test_boolean, setup),
         UTEST(test_derived_from, setup),
         UTEST(test_augment, setup),
         UTEST(test_variables, setup),
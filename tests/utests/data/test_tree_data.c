@@ -528,6 +528,75 @@ test_data_hash(void **state)
     lyd_free_all(tree);
 }
 
+static void
+test_data_hash_value(void **state)
+{
+    struct lyd_node *tree, *match, *first;
+    const struct lysc_node *snode;
+    const char *schema, *data;
+
+    schema =
+            "module test-data-hash-value {"
+            "  yang-version 1.1;"
+            "  namespace \"urn:tests:tdhv\";"
+            "  prefix t;"
+            "  import ietf-yang-types {prefix yang;}"
+            "  container c {"
+            "    list l {"
+            "      key \"k\";"
+            "      leaf k {"
+            "        type union {"
+            "          type int8;"
+            "          type string;"
+            "        }"
+            "      }"
+            "    }"
+            "    leaf-list ll {"
+            "      type yang:date-and-time;"
+            "    }"
+            "  }"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    data =
+            "<c xmlns='urn:tests:tdhv'>"
+            "  <l><k>1</k></l>"
+            "  <l><k>a</k></l>"
+            "  <l><k>2</k></l>"
+            "  <l><k></k></l>"
+            "  <ll>2021-01-01T09:00:00Z</ll>"
+            "  <ll>2021-01-01T09:00:00.5Z</ll>"
+            "  <ll>2021-01-01T10:00:00Z</ll>"
+            "  <ll>2021-01-01T11:00:00Z</ll>"
+            "</c>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+
+    /* values stored from a different string must hash the same */
+    snode = lys_find_path(UTEST_LYCTX, NULL, "/test-data-hash-value:c/l", 0);
+    assert_int_equal(LY_SUCCESS, lyd_find_sibling_val(lyd_child(tree), snode, "[k='2']", 0, &match));
+    assert_string_equal("2", lyd_get_value(lyd_child(match)));
+    assert_int_equal(LY_SUCCESS, lyd_find_sibling_val(lyd_child(tree), snode, "[k='']", 0, &match));
+    assert_int_equal(LY_ENOTFOUND, lyd_find_sibling_val(lyd_child(tree), snode, "[k='3']", 0, NULL));
+
+    snode = lys_find_path(UTEST_LYCTX, NULL, "/test-data-hash-value:c/ll", 0);
+    first = lyd_child(tree)->prev->prev->prev->prev;
+    assert_int_equal(LY_SUCCESS, lyd_find_sibling_val(lyd_child(tree), snode, "2021-01-01T10:00:00+01:00", 0, &match));
+    assert_ptr_equal(first, match);
+    assert_int_equal(LY_SUCCESS, lyd_find_sibling_val(lyd_child(tree), snode, "2021-01-01T10:30:00.5+01:30", 0, &match));
+    assert_ptr_equal(first->next, match);
+    assert_int_equal(LY_ENOTFOUND, lyd_find_sibling_val(lyd_child(tree), snode, "2021-01-01T09:00:00.4Z", 0, NULL));
+
+    /* duplicate union keys */
+    data =
+            "<c xmlns='urn:tests:tdhv'>"
+            "  <l><k>1</k></l>"
+            "  <l><k>01</k></l>"
+            "</c>";
+    lyd_free_all(tree);
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+}
+
 static void
 test_lyxp_vars(void **UNUSED(state))
 {
@@ -590,6 +659,7 @@ main(void)
         UTEST(test_first_sibling, setup),
         UTEST(test_find_path, setup),
         UTEST(test_data_hash, setup),
+        UTEST(test_data_hash_value, setup),
         UTEST(test_lyxp_vars),
     };
 
@@ -121,6 +121,116 @@ test_mandatory_when(void **state)
     lyd_free_all(tree);
 }
 
+static void
+test_when_shared(void **state)
+{
+    struct lyd_node *tree, *node;
+    const char *schema =
+            "module a {\n"
+            "    namespace urn:tests:a;\n"
+            "    prefix a;\n"
+            "    yang-version 1.1;\n"
+            "\n"
+            "    leaf enabled {\n"
+            "        type boolean;\n"
+            "    }\n"
+            "    container cont {\n"
+            "        leaf flag {\n"
+            "            type string;\n"
+            "        }\n"
+            "        list l {\n"
+            "            key \"k\";\n"
+            "            when \"/enabled = 'true'\";\n"
+            "            leaf k {\n"
+            "                type string;\n"
+            "            }\n"
+            "            leaf v {\n"
+            "                when \"../../flag = 'on'\";\n"
+            "                type string;\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    /* instance-independent when, the same false result for every instance */
+    CHECK_PARSE_LYD_PARAM("<enabled xmlns=\"urn:tests:a\">false</enabled><cont xmlns=\"urn:tests:a\">"
+            "<l><k>a</k></l><l><k>b</k></l></cont>", LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX("When condition \"/enabled = 'true'\" not satisfied.", "Schema location /a:cont/l, data location /a:cont/l[k='a'].");
+
+    /* parent-relative when, each list instance is a different parent */
+    LYD_TREE_CREATE("<enabled xmlns=\"urn:tests:a\">true</enabled><cont xmlns=\"urn:tests:a\"><flag>on</flag>"
+            "<l><k>a</k><v>1</v></l><l><k>b</k><v>2</v></l><l><k>c</k></l></cont>", tree);
+    node = lyd_child(tree->next)->next;
+    assert_int_equal(LYD_WHEN_TRUE, node->flags & LYD_WHEN_TRUE);
+    assert_int_equal(LYD_WHEN_TRUE, lyd_child(node)->next->flags & LYD_WHEN_TRUE);
+    assert_int_equal(LYD_WHEN_TRUE, node->next->flags & LYD_WHEN_TRUE);
+
+    /* once false, all the instances are auto-deleted */
+    assert_int_equal(LY_SUCCESS, lyd_change_term(tree, "false"));
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_STRING(lyd_child(tree->next)->schema->name, "flag");
+    assert_null(lyd_child(tree->next)->next);
+
+    lyd_free_all(tree);
+}
+
+static void
+test_when_order(void **state)
+{
+    struct lyd_node *tree, *node;
+    const char *schema =
+            "module a {\n"
+            "    namespace urn:tests:a;\n"
+            "    prefix a;\n"
+            "    yang-version 1.1;\n"
+            "\n"
+            "    container cont {\n"
+            "        leaf w1 {\n"
+            "            when \"../w2 = 'on'\";\n"
+            "            type string;\n"
+            "        }\n"
+            "        leaf w2 {\n"
+            "            when \"../w3 = 'on'\";\n"
+            "            type string;\n"
+            "        }\n"
+            "        leaf w3 {\n"
+            "            type string;\n"
+            "        }\n"
+            "        container sub {\n"
+            "            when \"../w3 = 'on'\";\n"
+            "            leaf s {\n"
+            "                when \"../../w1 = 'on'\";\n"
+            "                type string;\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    /* dependencies following the nodes */
+    LYD_TREE_CREATE("<cont xmlns=\"urn:tests:a\"><w1>on</w1><w2>on</w2><w3>on</w3><sub><s>on</s></sub></cont>", tree);
+    LY_LIST_FOR(lyd_child(tree), node) {
+        if (strcmp(LYD_NAME(node), "w3")) {
+            assert_int_equal(LYD_WHEN_TRUE, node->flags & LYD_WHEN_TRUE);
+        }
+    }
+    assert_int_equal(LYD_WHEN_TRUE, lyd_child(lyd_child(tree)->prev)->flags & LYD_WHEN_TRUE);
+
+    /* cascade of autodeleted nodes */
+    assert_int_equal(LY_SUCCESS, lyd_change_term(lyd_child(tree)->next->next, "off"));
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LYD_STRING_PARAM(tree, "<cont xmlns=\"urn:tests:a\">\n  <w3>off</w3>\n</cont>\n", LYD_XML, LYD_PRINT_WITHSIBLINGS);
+    lyd_free_all(tree);
+
+    /* invalid node deep in the dependencies */
+    CHECK_PARSE_LYD_PARAM("<cont xmlns=\"urn:tests:a\"><w1>on</w1><w2>off</w2><w3>on</w3><sub><s>on</s></sub></cont>",
+            LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX("When condition \"../w2 = 'on'\" not satisfied.", "Schema location /a:cont/w1, data location /a:cont/w1.");
+}
+
 static void
 test_mandatory(void **state)
 {
@@ -625,6 +735,91 @@ test_unique_nested(void **state)
             "Schema location /d:lt2, data location /d:lt2[k='val3'].", "data-not-unique");
 }
 
+static void
+test_unique_index(void **state)
+{
+    struct lyd_node *tree, *list, *node;
+    struct lyd_unique_index_stats stats;
+    const char *schema =
+            "module e {\n"
+            "    namespace urn:tests:e;\n"
+            "    prefix e;\n"
+            "    yang-version 1.1;\n"
+            "\n"
+            "    container top {\n"
+            "        list l {\n"
+            "            key \"k\";\n"
+            "            unique \"c/u1 u2\";\n"
+            "            leaf k {\n"
+            "                type string;\n"
+            "            }\n"
+            "            container c {\n"
+            "                leaf u1 {\n"
+            "                    type string;\n"
+            "                }\n"
+            "            }\n"
+            "            leaf u2 {\n"
+            "                type string;\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_options(UTEST_LYCTX, LY_CTX_UNIQUE_INDEX));
+
+    /* the index is created by the parser validation */
+    LYD_TREE_CREATE("<top xmlns=\"urn:tests:e\">\n"
+            "    <l><k>a</k><c><u1>1</u1></c><u2>1</u2></l>\n"
+            "    <l><k>b</k><c><u1>2</u1></c><u2>1</u2></l>\n"
+            "    <l><k>c</k><c><u1>3</u1></c><u2>1</u2></l>\n"
+            "</top>", tree);
+    assert_int_equal(LY_SUCCESS, lyd_unique_index_stats(tree, &stats));
+    assert_int_equal(1, stats.indexes);
+    assert_int_equal(3, stats.instances);
+    assert_int_equal(3, stats.rehashes);
+
+    /* value change, only the changed instance is hashed again */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "l[k='c']/c/u1", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "1"));
+    assert_int_equal(LY_EVALID, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LOG_CTX_APPTAG("Unique data leaf(s) \"c/u1 u2\" not satisfied in \"/e:top/l[k='c']\" and \"/e:top/l[k='a']\".",
+            "Schema location /e:top/l, data location /e:top/l[k='a'].", "data-not-unique");
+    assert_int_equal(LY_SUCCESS, lyd_unique_index_stats(tree, &stats));
+    assert_int_equal(4, stats.rehashes);
+
+    /* the invalid instance is checked again */
+    assert_int_equal(LY_SUCCESS, lyd_change_term(node, "4"));
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_unique_index_stats(tree, &stats));
+    assert_int_equal(5, stats.rehashes);
+
+    /* removed unique leaf */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "l[k='b']/u2", 0, &node));
+    lyd_free_tree(node);
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+
+    /* new instance */
+    assert_int_equal(LY_SUCCESS, lyd_new_list(tree, NULL, "l", 0, &list, "d"));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(list, NULL, "c/u1", "2", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_new_term(list, NULL, "u2", "1", 0, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_new_path(tree, NULL, "l[k='b']/u2", "1", 0, NULL));
+    assert_int_equal(LY_EVALID, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LOG_CTX_APPTAG("Unique data leaf(s) \"c/u1 u2\" not satisfied in \"/e:top/l[k='b']\" and \"/e:top/l[k='d']\".",
+            "Schema location /e:top/l, data location /e:top/l[k='d'].", "data-not-unique");
+
+    /* removed instance */
+    lyd_free_tree(list);
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    assert_int_equal(LY_SUCCESS, lyd_unique_index_stats(tree, &stats));
+    assert_int_equal(1, stats.indexes);
+    assert_int_equal(3, stats.instances);
+    assert_int_equal(9, stats.rehashes);
+
+    lyd_free_all(tree);
+}
+
 static void
 test_dup(void **state)
 {
@@ -1401,6 +1596,324 @@ test_case(void **state)
             "Schema location /k:ch/a0, data location /k:ch, line number 5.");
 }
 
+/**
+ * @brief Validate @p target changes of a valid @p base both incrementally and fully and compare the results.
+ */
+static void
+check_validate_diff(void **state, const char *base, const char *target)
+{
+    struct lyd_node *base_tree, *target_tree, *diff, *inc, *full;
+    LY_ERR inc_ret, full_ret;
+
+    CHECK_PARSE_LYD_PARAM(base, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, base_tree);
+    CHECK_PARSE_LYD_PARAM(target, LYD_XML, LYD_PARSE_ONLY, 0, LY_SUCCESS, target_tree);
+    assert_int_equal(LY_SUCCESS, lyd_diff_siblings(base_tree, target_tree, 0, &diff));
+    assert_non_null(diff);
+
+    /* apply the changes to copies of the valid tree */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base_tree, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &inc));
+    assert_int_equal(LY_SUCCESS, lyd_diff_apply_all(&inc, diff));
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(base_tree, NULL, LYD_DUP_RECURSIVE | LYD_DUP_WITH_FLAGS, &full));
+    assert_int_equal(LY_SUCCESS, lyd_diff_apply_all(&full, diff));
+
+    inc_ret = lyd_validate_diff(&inc, diff, LYD_VALIDATE_PRESENT, NULL);
+    full_ret = lyd_validate_all(&full, NULL, LYD_VALIDATE_PRESENT, NULL);
+    assert_int_equal(inc_ret, full_ret);
+    if (!inc_ret) {
+        assert_int_equal(LY_SUCCESS, lyd_compare_siblings(inc, full, LYD_COMPARE_FULL_RECURSION | LYD_COMPARE_DEFAULTS));
+    }
+
+    lyd_free_all(base_tree);
+    lyd_free_all(target_tree);
+    lyd_free_all(diff);
+    lyd_free_all(inc);
+    lyd_free_all(full);
+}
+
+static void
+test_validate_diff(void **state)
+{
+    const char *schema =
+            "module d {\n"
+            "    namespace urn:tests:d;\n"
+            "    prefix d;\n"
+            "    yang-version 1.1;\n"
+            "\n"
+            "    feature f;\n"
+            "\n"
+            "    container cont {\n"
+            "        leaf enabled {\n"
+            "            type boolean;\n"
+            "            default true;\n"
+            "        }\n"
+            "        leaf limit {\n"
+            "            type uint8;\n"
+            "            default 5;\n"
+            "        }\n"
+            "        leaf mode {\n"
+            "            type string;\n"
+            "            must \"not(../hidden)\";\n"
+            "        }\n"
+            "        leaf hidden {\n"
+            "            if-feature f;\n"
+            "            type string;\n"
+            "        }\n"
+            "        leaf-list target {\n"
+            "            type string;\n"
+            "        }\n"
+            "        list item {\n"
+            "            key \"name\";\n"
+            "            unique \"val\";\n"
+            "            min-elements 1;\n"
+            "            max-elements 3;\n"
+            "            leaf name {\n"
+            "                type string;\n"
+            "            }\n"
+            "            leaf val {\n"
+            "                type uint8;\n"
+            "                must \". <= ../../limit\";\n"
+            "            }\n"
+            "            leaf ref {\n"
+            "                type leafref {\n"
+            "                    path \"../../target\";\n"
+            "                }\n"
+            "            }\n"
+            "            leaf opt {\n"
+            "                when \"../../enabled = 'true'\";\n"
+            "                type string;\n"
+            "            }\n"
+            "        }\n"
+            "        choice ch {\n"
+            "            leaf a {\n"
+            "                type string;\n"
+            "            }\n"
+            "            case cb {\n"
+            "                leaf b {\n"
+            "                    type string;\n"
+            "                }\n"
+            "                leaf b2 {\n"
+            "                    type string;\n"
+            "                    default \"x\";\n"
+            "                }\n"
+            "            }\n"
+            "        }\n"
+            "        leaf-list tag {\n"
+            "            type string;\n"
+            "            must \"count(../tag) <= 2\";\n"
+            "        }\n"
+            "        container sub {\n"
+            "            must \"string(.) != 'xy'\";\n"
+            "            leaf p {\n"
+            "                type string;\n"
+            "            }\n"
+            "            leaf q {\n"
+            "                type string;\n"
+            "            }\n"
+            "        }\n"
+            "        leaf req {\n"
+            "            when \"../mode = 'on'\";\n"
+            "            mandatory true;\n"
+            "            type string;\n"
+            "        }\n"
+            "    }\n"
+            "    container other {\n"
+            "        leaf dl {\n"
+            "            when \"/d:cont/d:enabled = 'true'\";\n"
+            "            type string;\n"
+            "            default \"dv\";\n"
+            "        }\n"
+            "        container np {\n"
+            "            when \"/d:cont/d:enabled = 'true'\";\n"
+            "            container np2 {\n"
+            "                leaf dl2 {\n"
+            "                    type string;\n"
+            "                    default \"dv2\";\n"
+            "                }\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "    leaf top-dl {\n"
+            "        when \"/d:cont/d:enabled = 'true'\";\n"
+            "        type string;\n"
+            "        default \"tdv\";\n"
+            "    }\n"
+            "}";
+    const char *base =
+            "<cont xmlns=\"urn:tests:d\"><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>1</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    /* changed value */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>3</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>");
+
+    /* must of a changed node */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>9</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>");
+
+    /* must of unchanged nodes */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><limit>1</limit><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>1</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>");
+
+    /* must of other instances of the same node */
+    check_validate_diff(state,
+            "<cont xmlns=\"urn:tests:d\"><item><name>i1</name></item><tag>t1</tag><tag>t2</tag></cont>",
+            "<cont xmlns=\"urn:tests:d\"><item><name>i1</name></item><tag>t1</tag><tag>t2</tag><tag>t3</tag></cont>");
+
+    /* must of an ancestor using its value */
+    check_validate_diff(state,
+            "<cont xmlns=\"urn:tests:d\"><item><name>i1</name></item><sub><p>x</p></sub></cont>",
+            "<cont xmlns=\"urn:tests:d\"><item><name>i1</name></item><sub><p>x</p><q>y</q></sub></cont>");
+
+    /* leafref of an unchanged node */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><target>t1</target>"
+            "<item><name>i1</name><val>1</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>");
+
+    /* unique */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>2</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>");
+
+    /* when of an unchanged node, auto-deleted */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><enabled>false</enabled><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>1</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>");
+
+    /* when of unchanged implicit nodes becoming true */
+    check_validate_diff(state,
+            "<cont xmlns=\"urn:tests:d\"><enabled>false</enabled><item><name>i1</name></item></cont>",
+            "<cont xmlns=\"urn:tests:d\"><enabled>true</enabled><item><name>i1</name></item></cont>");
+    check_validate_diff(state,
+            "<cont xmlns=\"urn:tests:d\"><enabled>true</enabled><item><name>i1</name></item></cont>",
+            "<cont xmlns=\"urn:tests:d\"><enabled>false</enabled><item><name>i1</name></item></cont>");
+
+    /* when of a created node */
+    check_validate_diff(state,
+            "<cont xmlns=\"urn:tests:d\"><enabled>false</enabled><item><name>i1</name></item></cont>",
+            "<cont xmlns=\"urn:tests:d\"><enabled>false</enabled><item><name>i1</name><opt>o</opt></item></cont>");
+
+    /* other case with default nodes */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>1</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><a>a</a></cont>");
+
+    /* mandatory node with when */
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><mode>on</mode><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>1</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><b>b</b></cont>");
+
+    /* min-elements and max-elements */
+    check_validate_diff(state, base, "<cont xmlns=\"urn:tests:d\"><b>b</b></cont>");
+    check_validate_diff(state, base,
+            "<cont xmlns=\"urn:tests:d\"><target>t1</target><target>t2</target>"
+            "<item><name>i1</name><val>1</val><ref>t1</ref><opt>o</opt></item>"
+            "<item><name>i2</name><val>2</val><ref>t2</ref></item><item><name>i3</name></item>"
+            "<item><name>i4</name></item><b>b</b></cont>");
+
+    /* default restored */
+    check_validate_diff(state,
+            "<cont xmlns=\"urn:tests:d\"><limit>9</limit><item><name>i1</name><val>7</val></item></cont>",
+            "<cont xmlns=\"urn:tests:d\"><item><name>i1</name><val>7</val></item></cont>");
+    check_validate_diff(state,
+            "<cont xmlns=\"urn:tests:d\"><limit>9</limit><item><name>i1</name><val>3</val></item></cont>",
+            "<cont xmlns=\"urn:tests:d\"><item><name>i1</name><val>3</val></item></cont>");
+}
+
+/**
+ * @brief Create a tree with leafrefs for test_multi_thread().
+ *
+ * @param[in] ctx Context.
+ * @param[in] count Number of list instances.
+ * @param[in] inval1 Index of an instance with an invalid leafref.
+ * @param[in] inval2 Index of another instance with an invalid leafref.
+ * @return Created tree.
+ */
+static struct lyd_node *
+multi_thread_tree(const struct ly_ctx *ctx, uint32_t count, uint32_t inval1, uint32_t inval2)
+{
+    struct lyd_node *tree, *list;
+    char buf[16];
+    uint32_t i;
+
+    assert_int_equal(LY_SUCCESS, lyd_new_inner(NULL, ly_ctx_get_module_implemented(ctx, "f"), "top", 0, &tree));
+    for (i = 0; i < count; ++i) {
+        sprintf(buf, "%" PRIu32, i);
+        assert_int_equal(LY_SUCCESS, lyd_new_term(tree, NULL, "t", buf, 0, NULL));
+        assert_int_equal(LY_SUCCESS, lyd_new_list(tree, NULL, "l", 0, &list, buf));
+        if ((i == inval1) || (i == inval2)) {
+            sprintf(buf, "%" PRIu32, count + i);
+        }
+        assert_int_equal(LY_SUCCESS, lyd_new_term(list, NULL, "r", buf, 0, NULL));
+    }
+
+    return tree;
+}
+
+static void
+test_multi_thread(void **state)
+{
+    struct lyd_node *tree;
+    const char *schema =
+            "module f {\n"
+            "    namespace urn:tests:f;\n"
+            "    prefix f;\n"
+            "    yang-version 1.1;\n"
+            "\n"
+            "    container top {\n"
+            "        leaf-list t {\n"
+            "            type uint32;\n"
+            "        }\n"
+            "        list l {\n"
+            "            key \"k\";\n"
+            "            leaf k {\n"
+            "                type uint32;\n"
+            "            }\n"
+            "            leaf r {\n"
+            "                type leafref {\n"
+            "                    path \"/f:top/f:t\";\n"
+            "                }\n"
+            "            }\n"
+            "        }\n"
+            "    }\n"
+            "}";
+
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    /* valid */
+    tree = multi_thread_tree(UTEST_LYCTX, 2000, UINT32_MAX, UINT32_MAX);
+    assert_int_equal(LY_SUCCESS, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT | LYD_VALIDATE_MULTI_THREAD,
+            NULL));
+    lyd_free_all(tree);
+
+    /* the same error is reported as when validated sequentially */
+    tree = multi_thread_tree(UTEST_LYCTX, 2000, 150, 1700);
+    assert_int_equal(LY_EVALID, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LOG_CTX("Invalid leafref value \"3700\" - no target instance \"/f:top/f:t\" with the same value.",
+            "Schema location /f:top/l/r, data location /f:top/l[k='1700']/r.");
+    lyd_free_all(tree);
+
+    tree = multi_thread_tree(UTEST_LYCTX, 2000, 150, 1700);
+    assert_int_equal(LY_EVALID, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT | LYD_VALIDATE_MULTI_THREAD,
+            NULL));
+    CHECK_LOG_CTX("Invalid leafref value \"3700\" - no target instance \"/f:top/f:t\" with the same value.",
+            "Schema location /f:top/l/r, data location /f:top/l[k='1700']/r.");
+    lyd_free_all(tree);
+}
+
 int
 main(void)
 {
@@ -1408,9 +1921,12 @@ main(void)
         UTEST(test_when),
         UTEST(test_mandatory),
         UTEST(test_mandatory_when),
+        UTEST(test_when_shared),
+        UTEST(test_when_order),
         UTEST(test_minmax),
         UTEST(test_unique),
         UTEST(test_unique_nested),
+        UTEST(test_unique_index),
         UTEST(test_dup),
         UTEST(test_defaults),
         UTEST(test_state),
@@ -1419,6 +1935,8 @@ main(void)
         UTEST(test_rpc),
         UTEST(test_reply),
         UTEST(test_case),
+        UTEST(test_validate_diff),
+        UTEST(test_multi_thread),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -2338,6 +2338,14 @@ test_grouping(void **state)
     assert_int_equal(LY_EVALID, lys_parse_mem(UTEST_LYCTX, "module aa {namespace urn:aa;prefix aa;"
             "container a {grouping grp {leaf x {type leafref;}}}}", LYS_IN_YANG, NULL));
     CHECK_LOG_CTX("Missing path substatement for leafref type.", "/aa:a/{grouping='grp'}/x");
+
+    /* non-instantiated groupings are not compiled at all */
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_options(UTEST_LYCTX, LY_CTX_SKIP_UNUSED_GROUPINGS));
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module aa {namespace urn:aa;prefix aa;"
+            "container a {grouping grp {leaf x {type leafref;}}}}", LYS_IN_YANG, NULL));
+    assert_int_equal(LY_EVALID, lys_parse_mem(UTEST_LYCTX, "module bb {namespace urn:bb;prefix bb;"
+            "grouping grp {leaf x {type leafref;}} uses grp;}", LYS_IN_YANG, NULL));
+    CHECK_LOG_CTX("Missing path substatement for leafref type.", "/bb:{uses='grp'}/bb:x");
 }
 
 static void
@@ -3657,6 +3665,60 @@ test_when(void **state)
             LYS_IN_YANG, NULL));
 }
 
+static void
+test_xpath_compile(void **state)
+{
+    struct lys_module *mod;
+    const struct lysc_node *node;
+    const struct lyxp_expr *exp;
+    const struct lysc_when *when;
+    struct lyd_node *tree;
+
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module b {namespace urn:b;prefix b; leaf y {type string;}}",
+            LYS_IN_YANG, NULL));
+    assert_int_equal(LY_SUCCESS, lys_parse_mem(UTEST_LYCTX, "module a {namespace urn:a;prefix a; import b {prefix x;}"
+            "leaf l {type string; when \"/x:y = 'a'\";}"
+            "container c {leaf l {type string; must \"count(../a:*) = 1 and starts-with(../l, /x:y) or not(.)\";}}}",
+            LYS_IN_YANG, &mod));
+
+    /* when */
+    node = mod->compiled->data;
+    when = lysc_node_when(node)[0];
+    exp = when->cond;
+    assert_non_null(exp->tok_res);
+    assert_ptr_equal(when->prefixes, exp->res_prefix_data);
+    assert_int_equal(LYXP_TOKEN_NAMETEST, exp->tokens[1]);
+    assert_string_equal("b", exp->tok_res[1].mod->name);
+    assert_string_equal("y", exp->tok_res[1].name);
+
+    /* must */
+    node = lysc_node_child(node->next);
+    exp = lysc_node_musts(node)[0].cond;
+    assert_non_null(exp->tok_res);
+    assert_int_equal(LYXP_TOKEN_FUNCNAME, exp->tokens[0]);
+    assert_non_null(exp->tok_res[0].func);
+    assert_int_equal(LYXP_TOKEN_NAMETEST, exp->tokens[4]);
+    assert_ptr_equal(mod, exp->tok_res[4].mod);
+    assert_string_equal("*", exp->tok_res[4].name);
+    assert_int_equal(LYXP_TOKEN_NAMETEST, exp->tokens[13]);
+    assert_null(exp->tok_res[13].mod);
+    assert_string_equal("l", exp->tok_res[13].name);
+    assert_int_equal(LYXP_TOKEN_NAMETEST, exp->tokens[16]);
+    assert_string_equal("b", exp->tok_res[16].mod->name);
+    assert_int_equal(LYXP_TOKEN_FUNCNAME, exp->tokens[19]);
+    assert_non_null(exp->tok_res[19].func);
+
+    /* evaluate the compiled expressions */
+    CHECK_PARSE_LYD_PARAM("{\"b:y\":\"a\",\"a:l\":\"val\",\"a:c\":{\"l\":\"abc\"}}", LYD_JSON, 0,
+            LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    lyd_free_all(tree);
+
+    CHECK_PARSE_LYD_PARAM("{\"b:y\":\"b\",\"a:c\":{\"l\":\"abc\"}}", LYD_JSON, 0,
+            LYD_VALIDATE_PRESENT, LY_EVALID, tree);
+    CHECK_LOG_CTX("Must condition \"count(../a:*) = 1 and starts-with(../l, /x:y) or not(.)\" not satisfied.",
+            "Schema location /a:c/l, data location /a:c/l, line number 1.");
+}
+
 int
 main(void)
 {
@@ -3689,6 +3751,7 @@ main(void)
         UTEST(test_augment, setup),
         UTEST(test_deviation, setup),
         UTEST(test_when, setup),
+        UTEST(test_xpath_compile, setup),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
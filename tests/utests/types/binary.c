@@ -50,7 +50,8 @@ test_plugin_store(void **state)
     unsigned char bin_val[2];
     struct ly_err_item *err = NULL;
     struct lys_module *mod;
-    struct lyd_value value = {0};
+    struct lyd_value value = {0}, dup = {0};
+    struct lyd_value_binary *bin;
     struct lyplg_type *type = lyplg_find(LYPLG_TYPE, "", NULL, ly_data_type2str[LY_TYPE_BINARY]);
     struct lysc_type *lysc_type;
     LY_ERR ly_ret;
@@ -125,6 +126,40 @@ test_plugin_store(void **state)
     assert_ptr_equal(value.realtype, lysc_type);
     type->free(UTEST_LYCTX, &value);
 
+    /* single byte */
+    val = "YQ==";
+    dec_val = "a";
+    assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, dec_val, strlen(dec_val),
+            0, LY_VALUE_LYB, NULL, 0, NULL, &value, NULL, &err));
+    CHECK_LYD_VALUE(value, BINARY, val, dec_val, strlen(dec_val));
+    type->free(UTEST_LYCTX, &value);
+
+    /* non-zero bits before the padding are not canonical */
+    val = "YR==";
+    assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, val, strlen(val),
+            0, LY_VALUE_XML, NULL, LYD_VALHINT_STRING, NULL, &value, NULL, &err));
+    CHECK_LYD_VALUE(value, BINARY, "YQ==", dec_val, strlen(dec_val));
+    type->free(UTEST_LYCTX, &value);
+
+    val = "YWhveWp=";
+    dec_val = "ahoyj";
+    assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, val, strlen(val),
+            0, LY_VALUE_XML, NULL, LYD_VALHINT_STRING, NULL, &value, NULL, &err));
+    CHECK_LYD_VALUE(value, BINARY, "YWhveWo=", dec_val, strlen(dec_val));
+    type->free(UTEST_LYCTX, &value);
+
+    /* all the characters */
+    val = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, val, strlen(val),
+            0, LY_VALUE_XML, NULL, LYD_VALHINT_STRING, NULL, &value, NULL, &err));
+    LYD_VALUE_GET(&value, bin);
+    assert_int_equal(48, bin->size);
+    assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, bin->data, bin->size,
+            0, LY_VALUE_LYB, NULL, 0, NULL, &dup, NULL, &err));
+    assert_string_equal(val, type->print(UTEST_LYCTX, &dup, LY_VALUE_CANON, NULL, NULL, NULL));
+    type->free(UTEST_LYCTX, &value);
+    type->free(UTEST_LYCTX, &dup);
+
     /* empty value */
     val = "";
     assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, val, strlen(val),
@@ -606,6 +606,7 @@ test_data_xml(void **state)
 
     const char *schema;
     struct lyd_node *tree;
+    struct ly_set *set;
     const char *data;
 
     /* xml test */
@@ -641,6 +642,26 @@ test_data_xml(void **state)
     CHECK_LYD_NODE_TERM((struct lyd_node_term *)tree, 0, 0, 0, 0, 1, BITS, "");
     lyd_free_all(tree);
 
+    /* bits on the byte boundaries */
+    schema = MODULE_CREATE_YANG("T1", "leaf port {type bits {bit zero {position 0;}}}");
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+    TEST_SUCCESS_XML("T1", "zero", BITS, "zero", "zero");
+
+    schema = MODULE_CREATE_YANG("T2", "leaf port {type bits {bit seven {position 7;} bit eight; bit zero {position 0;}}}");
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+    TEST_SUCCESS_XML("T2", "eight zero", BITS, "zero eight", "zero", "eight");
+    TEST_SUCCESS_XML("T2", "seven eight", BITS, "seven eight", "seven", "eight");
+
+    /* bit-is-set() */
+    data = "<port xmlns=\"urn:tests:T2\">eight</port>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/T2:port[bit-is-set(., 'eight')]", &set));
+    assert_int_equal(1, set->count);
+    ly_set_free(set, NULL);
+    assert_int_equal(LY_SUCCESS, lyd_find_xpath(tree, "/T2:port[bit-is-set(., 'seven')]", &set));
+    assert_int_equal(0, set->count);
+    ly_set_free(set, NULL);
+    lyd_free_all(tree);
 }
 
 static void
@@ -1441,6 +1441,15 @@ test_plugin_store(void **state)
     assert_ptr_equal(value.realtype, lysc_type);
     type->free(UTEST_LYCTX, &value);
 
+    /* canonical value is generated only on demand */
+    val_text = "020";
+    assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, val_text, strlen(val_text),
+            0, LY_VALUE_XML, NULL, LYD_VALHINT_DECNUM, NULL, &value, NULL, &err));
+    assert_null(value._canonical);
+    assert_string_equal("20", lyd_value_get_canonical(UTEST_LYCTX, &value));
+    assert_string_equal("20", value._canonical);
+    type->free(UTEST_LYCTX, &value);
+
     val_text = "-20";
     assert_int_equal(LY_SUCCESS, type->store(UTEST_LYCTX, lysc_type, val_text, strlen(val_text),
             0, LY_VALUE_XML, NULL, LYD_VALHINT_DECNUM, NULL, &value, NULL, &err));
@@ -1345,6 +1345,57 @@ test_plugin_dup(void **state)
     }
 }
 
+static void
+test_inline(void **state)
+{
+    const char *schema, *data;
+    struct lyd_node *tree, *dup, *node, *node2;
+    struct lys_module *mod;
+
+    schema = MODULE_CREATE_YANG("inl", "list l {key k; leaf k {type string;} leaf v {type string;}}"
+            "leaf-list ll {type string;}");
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, &mod);
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_options(UTEST_LYCTX, LY_CTX_INLINE_STRINGS));
+
+    data = "<l xmlns=\"urn:tests:inl\"><k>a</k><v>a value too long to be stored inline</v></l>"
+            "<l xmlns=\"urn:tests:inl\"><k>b</k><v/></l>"
+            "<ll xmlns=\"urn:tests:inl\">a</ll><ll xmlns=\"urn:tests:inl\">b</ll>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+
+    /* short values inline, long ones in the dictionary */
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/inl:l[k='a']/k", 0, &node));
+    assert_null(((struct lyd_node_term *)node)->value._canonical);
+    assert_string_equal("a", lyd_get_value(node));
+    assert_non_null(((struct lyd_node_term *)node->next)->value._canonical);
+    assert_string_equal("a value too long to be stored inline", lyd_get_value(node->next));
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/inl:l[k='b']/v", 0, &node));
+    assert_null(((struct lyd_node_term *)node)->value._canonical);
+    assert_string_equal("", lyd_get_value(node));
+
+    /* duplicate instances */
+    assert_int_equal(LY_SUCCESS, lyd_new_term(NULL, mod, "ll", "b", 0, &node));
+    assert_int_equal(LY_SUCCESS, lyd_insert_sibling(tree, node, NULL));
+    assert_int_equal(LY_EVALID, lyd_validate_all(&tree, NULL, LYD_VALIDATE_PRESENT, NULL));
+    CHECK_LOG_CTX("Duplicate instance of \"ll\".", "Schema location /inl:ll, data location /inl:ll[.='b'].");
+    lyd_free_tree(node);
+
+    /* dup, compare and print */
+    assert_int_equal(LY_SUCCESS, lyd_dup_siblings(tree, NULL, LYD_DUP_RECURSIVE, &dup));
+    assert_int_equal(LY_SUCCESS, lyd_compare_siblings(tree, dup, LYD_COMPARE_FULL_RECURSION));
+    CHECK_LYD_STRING_PARAM(dup, data, LYD_XML, LYD_PRINT_SHRINK | LYD_PRINT_WITHSIBLINGS);
+    lyd_free_all(dup);
+
+    /* values stored in the dictionary before setting the option */
+    assert_int_equal(LY_SUCCESS, ly_ctx_unset_options(UTEST_LYCTX, LY_CTX_INLINE_STRINGS));
+    assert_int_equal(LY_SUCCESS, lyd_new_term(NULL, mod, "ll", "a", 0, &node));
+    assert_non_null(((struct lyd_node_term *)node)->value._canonical);
+    assert_int_equal(LY_SUCCESS, lyd_find_path(tree, "/inl:ll[.='a']", 0, &node2));
+    assert_int_equal(LY_SUCCESS, lyd_compare_single(node, node2, 0));
+    lyd_free_tree(node);
+
+    lyd_free_all(tree);
+}
+
 int
 main(void)
 {
@@ -1362,6 +1413,7 @@ main(void)
         UTEST(test_plugin_compare),
         UTEST(test_plugin_print),
         UTEST(test_plugin_dup),
+        UTEST(test_inline),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
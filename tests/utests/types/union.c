@@ -106,6 +106,46 @@ test_data_xml(void **state)
             "Schema location /defs:un1, line number 1.");
 }
 
+static void
+test_data_builtin(void **state)
+{
+    const char *schema;
+    struct lyd_node *tree;
+    struct lyd_node_term *term;
+
+    schema = MODULE_CREATE_YANG("bltn", "leaf un1 {type union {"
+            "    type uint8;"
+            "    type decimal64 {fraction-digits 2;}"
+            "    type boolean;"
+            "    type enumeration {enum up; enum down;}"
+            "    type string;}}"
+            "leaf l {type string;}");
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", "8", UNION, "8", UINT8, "8", 8);
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", " +9", UNION, "9", UINT8, "9", 9);
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", "300", UNION, "300.0", DEC64, "300.0", 30000);
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", "-1.5", UNION, "-1.5", DEC64, "-1.5", -150);
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", "false", UNION, "false", BOOL, "false", 0);
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", "down", UNION, "down", ENUM, "down", "down");
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", "truex", UNION, "truex", STRING, "truex");
+    TEST_SUCCESS_XML2("<l xmlns=\"urn:tests:bltn\">a</l>", "bltn", "", "un1", "", UNION, "", STRING, "");
+
+    /* JSON string is not a number */
+    CHECK_PARSE_LYD_PARAM("{\"bltn:un1\":\"8\"}", LYD_JSON, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    term = (struct lyd_node_term *)tree;
+    assert_int_equal(LY_TYPE_DEC64, term->value.subvalue->value.realtype->basetype);
+    lyd_free_all(tree);
+    CHECK_PARSE_LYD_PARAM("{\"bltn:un1\":8}", LYD_JSON, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    term = (struct lyd_node_term *)tree;
+    assert_int_equal(LY_TYPE_UINT8, term->value.subvalue->value.realtype->basetype);
+    lyd_free_all(tree);
+    CHECK_PARSE_LYD_PARAM("{\"bltn:un1\":\"true\"}", LYD_JSON, 0, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    term = (struct lyd_node_term *)tree;
+    assert_int_equal(LY_TYPE_STRING, term->value.subvalue->value.realtype->basetype);
+    lyd_free_all(tree);
+}
+
 static void
 test_plugin_lyb(void **state)
 {
@@ -122,12 +162,63 @@ test_plugin_lyb(void **state)
     TEST_SUCCESS_LYB("lyb", "un1", "");
 }
 
+static void
+test_intern(void **state)
+{
+    const char *schema, *data;
+    struct lyd_node *tree, *dup;
+    struct lyd_node_term *u1, *u2, *u3, *r1, *r2;
+
+    schema = MODULE_CREATE_YANG("intern",
+            "container c {list l {key k; leaf k {type string;}"
+            "    leaf u {type union {type uint8; type string;}}"
+            "    leaf r {type union {type leafref {path ../../l/k;} type string;}}}}");
+    UTEST_ADD_MODULE(schema, LYS_IN_YANG, NULL, NULL);
+    assert_int_equal(LY_SUCCESS, ly_ctx_set_options(UTEST_LYCTX, LY_CTX_INTERN_VALUES));
+
+    data = "<c xmlns=\"urn:tests:intern\">"
+            "<l><k>a</k><u>1</u><r>a</r></l>"
+            "<l><k>b</k><u>1</u><r>a</r></l>"
+            "<l><k>c</k><u>01</u></l>"
+            "</c>";
+    CHECK_PARSE_LYD_PARAM(data, LYD_XML, LYD_PARSE_STRICT, LYD_VALIDATE_PRESENT, LY_SUCCESS, tree);
+    u1 = (struct lyd_node_term *)lyd_child(lyd_child(tree))->next;
+    u2 = (struct lyd_node_term *)lyd_child(lyd_child(tree)->next)->next;
+    u3 = (struct lyd_node_term *)lyd_child(lyd_child(tree)->prev)->next;
+    r1 = (struct lyd_node_term *)u1->next;
+    r2 = (struct lyd_node_term *)u2->next;
+
+    /* equal values share the value, unless stored from a different string or resolved in the data tree */
+    assert_ptr_equal(u1->value.subvalue, u2->value.subvalue);
+    assert_ptr_not_equal(u1->value.subvalue, u3->value.subvalue);
+    assert_ptr_not_equal(r1->value.subvalue, r2->value.subvalue);
+    assert_string_equal("1", lyd_get_value(&u1->node));
+    assert_string_equal("1", lyd_get_value(&u3->node));
+
+    /* duplicates share it, too */
+    assert_int_equal(LY_SUCCESS, lyd_dup_single(tree, NULL, LYD_DUP_RECURSIVE, &dup));
+    assert_ptr_equal(u1->value.subvalue, ((struct lyd_node_term *)lyd_child(lyd_child(dup))->next)->value.subvalue);
+    assert_int_equal(LY_SUCCESS, lyd_compare_single(tree, dup, LYD_COMPARE_FULL_RECURSION));
+    lyd_free_all(dup);
+
+    /* changing a value does not affect the others */
+    assert_int_equal(LY_SUCCESS, lyd_change_term(&u1->node, "x"));
+    assert_string_equal("x", lyd_get_value(&u1->node));
+    assert_string_equal("1", lyd_get_value(&u2->node));
+    assert_int_equal(LY_SUCCESS, lyd_change_term(&u2->node, "x"));
+    assert_ptr_equal(u1->value.subvalue, u2->value.subvalue);
+
+    lyd_free_all(tree);
+}
+
 int
 main(void)
 {
     const struct CMUnitTest tests[] = {
         UTEST(test_data_xml),
+        UTEST(test_data_builtin),
         UTEST(test_plugin_lyb),
+        UTEST(test_intern),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -101,6 +101,11 @@ test_data_xml(void **state)
     /* canonize */
     TEST_SUCCESS_XML("a", "l", "2005-02-29T23:15:15-02:00", STRING, "2005-03-01T23:15:15-02:00");
 
+    /* leap years */
+    TEST_SUCCESS_XML("a", "l", "2000-02-29T12:00:00Z", STRING, "2000-02-29T10:00:00-02:00");
+    TEST_SUCCESS_XML("a", "l", "1600-03-01T01:00:00+00:00", STRING, "1600-02-29T23:00:00-02:00");
+    TEST_SUCCESS_XML("a", "l", "2100-03-01T00:30:00+00:30", STRING, "2100-02-28T22:00:00-02:00");
+
     TEST_ERROR_XML("a", "l", "2005-05-31T23:15:15.-08:00");
     CHECK_LOG_CTX("Unsatisfied pattern - \"2005-05-31T23:15:15.-08:00\" does not conform to "
             "\"\\d{4}-\\d{2}-\\d{2}T\\d{2}:\\d{2}:\\d{2}(\\.\\d+)?(Z|[\\+\\-]\\d{2}:\\d{2})\".",
@@ -183,6 +188,39 @@ test_lyb(void **state)
     TEST_SUCCESS_LYB("a\" xmlns:aa=\"urn:tests:a", "l2", "/aa:l2[. = '4']");
 }
 
+static void
+test_time_conv(void **state)
+{
+    struct timespec ts;
+    time_t t;
+    char *str, *frac;
+
+    (void)state;
+
+    /* epoch */
+    assert_int_equal(LY_SUCCESS, ly_time_str2time("1970-01-01T02:00:00+02:00", &t, &frac));
+    assert_int_equal(0, t);
+    assert_null(frac);
+
+    assert_int_equal(LY_SUCCESS, ly_time_str2time("1969-12-31T23:59:59.0120Z", &t, &frac));
+    assert_int_equal(-1, t);
+    assert_string_equal("0120", frac);
+    free(frac);
+
+    /* nanoseconds */
+    assert_int_equal(LY_SUCCESS, ly_time_str2ts("2021-07-14T09:30:00.5-00:30", &ts));
+    assert_int_equal(1626256800, ts.tv_sec);
+    assert_int_equal(500000000, ts.tv_nsec);
+    assert_int_equal(LY_SUCCESS, ly_time_str2ts("2021-07-14T10:00:00.1234567891Z", &ts));
+    assert_int_equal(1626256800, ts.tv_sec);
+    assert_int_equal(123456789, ts.tv_nsec);
+
+    /* back to the local timezone */
+    assert_int_equal(LY_SUCCESS, ly_time_ts2str(&ts, &str));
+    assert_string_equal("2021-07-14T08:00:00.123456789-02:00", str);
+    free(str);
+}
+
 int
 main(void)
 {
@@ -190,6 +228,7 @@ main(void)
         UTEST(test_data_xml),
         UTEST(test_print),
         UTEST(test_lyb),
+        UTEST(test_time_conv),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -847,6 +847,19 @@ struct utest_context {
     CHECK_POINTER((NODE)->val_prefix_data, VAL_PREFS); \
     assert_string_equal((NODE)->value, VALUE);
 
+/**
+ * @brief assert that the lyd_node private data pointer is correct, nothing is checked if libyang is built without it
+ * @param[in] NODE     pointer to lyd_node variable
+ * @param[in] PRIV     1 if node has private data other 0
+ */
+#ifdef LYD_NODE_PRIV
+# define CHECK_LYD_NODE_PRIV(NODE, PRIV) \
+    CHECK_POINTER((NODE)->priv, PRIV)
+#else
+# define CHECK_LYD_NODE_PRIV(NODE, PRIV) \
+    (void)(PRIV)
+#endif
+
 /**
  * @brief assert that lyd_node_opaq structure members are correct
  * @param[in] NODE     pointer to lyd_node_opaq variable
@@ -868,7 +881,7 @@ struct utest_context {
     CHECK_POINTER((NODE)->parent, PARENT); \
     assert_non_null((NODE)->prev); \
     CHECK_POINTER((NODE)->next, NEXT); \
-    CHECK_POINTER((NODE)->priv, PRIV); \
+    CHECK_LYD_NODE_PRIV(NODE, PRIV); \
     CHECK_POINTER((NODE)->schema, SCHEMA)
 
 /**
@@ -938,13 +951,18 @@ struct utest_context {
     assert_int_equal(LY_TYPE_BITS, (NODE).realtype->basetype); \
     { \
         const char *arr[] = { __VA_ARGS__ }; \
-        LY_ARRAY_COUNT_TYPE arr_size = (sizeof(arr) / sizeof(arr[0])) - 1; \
+        LY_ARRAY_COUNT_TYPE arr_size = (sizeof(arr) / sizeof(arr[0])) - 1, _set = 0; \
         struct lyd_value_bits *_val; \
+        struct lysc_type_bits *_type = (struct lysc_type_bits *)(NODE).realtype; \
         LYD_VALUE_GET(&(NODE), _val); \
-        assert_int_equal(arr_size, LY_ARRAY_COUNT(_val->items)); \
-        for (LY_ARRAY_COUNT_TYPE it = 0; it < arr_size; it++) { \
-            assert_string_equal(arr[it + 1], _val->items[it]->name); \
+        for (LY_ARRAY_COUNT_TYPE it = 0; it < LY_ARRAY_COUNT(_type->bits); it++) { \
+            if (lyplg_type_bits_is_bit_set(_val->bitmap, lyplg_type_bits_bitmap_size(_type), _type->bits[it].position)) { \
+                assert_true(_set < arr_size); \
+                assert_string_equal(arr[_set + 1], _type->bits[it].name); \
+                ++_set; \
+            } \
         } \
+        assert_int_equal(arr_size, _set); \
     }
 
 /**